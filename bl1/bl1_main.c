@@ -34,6 +34,7 @@
 #include <auth_mod.h>
 #include <bl1.h>
 #include <bl_common.h>
+#include <boot_timeline.h>
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
@@ -102,6 +103,8 @@ void bl1_main(void)
 {
 	unsigned int image_id;
 
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL1_ENTRY);
+
 	/* Announce our arrival */
 	NOTICE(FIRMWARE_WELCOME_STR);
 	NOTICE("BL1: %s\n", version_string);
@@ -164,6 +167,8 @@ void bl1_main(void)
 		NOTICE("BL1-FWU: *******FWU Process Started*******\n");
 
 	bl1_prepare_next_image(image_id);
+
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL1_EXIT);
 }
 
 /*******************************************************************************
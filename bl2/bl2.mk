@@ -43,4 +43,8 @@ else
 BL2_SOURCES		+=	bl2/bl2_image_load.c
 endif
 
+ifeq (${BL2_PARALLEL_AUTH},1)
+BL2_SOURCES		+=	bl2/bl2_parallel_auth.c
+endif
+
 BL2_LINKERFILE		:=	bl2/bl2.ld.S
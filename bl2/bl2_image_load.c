@@ -38,6 +38,7 @@
 #include <platform.h>
 #include <platform_def.h>
 #include <stdint.h>
+#include "bl2_private.h"
 
 /*
  * Check for platforms that use obsolete image terminology
@@ -46,6 +47,16 @@
 # error "BL30_BASE platform define no longer used - please use SCP_BL2_BASE"
 #endif
 
+/*
+ * With BL2_PARALLEL_AUTH, the BL3x images are authenticated by the secondary
+ * CPUs while the primary CPU loads the next ones.
+ */
+#if BL2_PARALLEL_AUTH
+#define load_auth_bl3x_image	bl2_parallel_auth_load
+#else
+#define load_auth_bl3x_image	load_auth_image
+#endif
+
 /*******************************************************************************
  * Load the SCP_BL2 image if there's one.
  * If a platform does not want to attempt to load SCP_BL2 image it must leave
@@ -113,11 +124,11 @@ static int load_bl31(bl31_params_t *bl2_to_bl31_params,
 	bl31_ep_info->args.arg0 = (unsigned long)bl2_to_bl31_params;
 
 	/* Load the BL31 image */
-	e = load_auth_image(bl2_tzram_layout,
-			    BL31_IMAGE_ID,
-			    BL31_BASE,
-			    bl2_to_bl31_params->bl31_image_info,
-			    bl31_ep_info);
+	e = load_auth_bl3x_image(bl2_tzram_layout,
+				 BL31_IMAGE_ID,
+				 BL31_BASE,
+				 bl2_to_bl31_params->bl31_image_info,
+				 bl31_ep_info);
 
 	if (e == 0) {
 		bl2_plat_set_bl31_ep_info(bl2_to_bl31_params->bl31_image_info,
@@ -151,11 +162,11 @@ static int load_bl32(bl31_params_t *bl2_to_bl31_params)
 	 * completely different memory.
 	 */
 	bl2_plat_get_bl32_meminfo(&bl32_mem_info);
-	e = load_auth_image(&bl32_mem_info,
-			    BL32_IMAGE_ID,
-			    BL32_BASE,
-			    bl2_to_bl31_params->bl32_image_info,
-			    bl2_to_bl31_params->bl32_ep_info);
+	e = load_auth_bl3x_image(&bl32_mem_info,
+				 BL32_IMAGE_ID,
+				 BL32_BASE,
+				 bl2_to_bl31_params->bl32_image_info,
+				 bl2_to_bl31_params->bl32_ep_info);
 
 	if (e == 0) {
 		bl2_plat_set_bl32_ep_info(
@@ -185,11 +196,11 @@ static int load_bl33(bl31_params_t *bl2_to_bl31_params)
 	bl2_plat_get_bl33_meminfo(&bl33_mem_info);
 
 	/* Load the BL33 image in non-secure memory provided by the platform */
-	e = load_auth_image(&bl33_mem_info,
-			    BL33_IMAGE_ID,
-			    plat_get_ns_image_entrypoint(),
-			    bl2_to_bl31_params->bl33_image_info,
-			    bl2_to_bl31_params->bl33_ep_info);
+	e = load_auth_bl3x_image(&bl33_mem_info,
+				 BL33_IMAGE_ID,
+				 plat_get_ns_image_entrypoint(),
+				 bl2_to_bl31_params->bl33_image_info,
+				 bl2_to_bl31_params->bl33_ep_info);
 
 	if (e == 0) {
 		bl2_plat_set_bl33_ep_info(bl2_to_bl31_params->bl33_image_info,
@@ -228,6 +239,10 @@ entry_point_info_t *bl2_load_images(void)
 	bl2_to_bl31_params = bl2_plat_get_bl31_params();
 	bl31_ep_info = bl2_plat_get_bl31_ep_info();
 
+#if BL2_PARALLEL_AUTH
+	bl2_parallel_auth_init();
+#endif
+
 #ifdef EL3_PAYLOAD_BASE
 	/*
 	 * In the case of an EL3 payload, we don't need to load any further
@@ -278,6 +293,11 @@ entry_point_info_t *bl2_load_images(void)
 
 #endif /* EL3_PAYLOAD_BASE */
 
+#if BL2_PARALLEL_AUTH
+	/* Wait for the images to be authenticated */
+	bl2_parallel_auth_finish();
+#endif
+
 	/* Flush the params to be passed to memory */
 	bl2_plat_flush_bl31_params();
 
@@ -32,6 +32,7 @@
 #include <auth_mod.h>
 #include <bl1.h>
 #include <bl_common.h>
+#include <boot_timeline.h>
 #include <debug.h>
 #include <platform.h>
 #include "bl2_private.h"
@@ -46,6 +47,8 @@ void bl2_main(void)
 {
 	entry_point_info_t *next_bl_ep_info;
 
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL2_ENTRY);
+
 	NOTICE("BL2: %s\n", version_string);
 	NOTICE("BL2: %s\n", build_message);
 
@@ -58,7 +61,9 @@ void bl2_main(void)
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* Load the subsequent bootloader images. */
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL2_LOAD_IMAGES_START);
 	next_bl_ep_info = bl2_load_images();
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL2_LOAD_IMAGES_END);
 
 #ifdef AARCH32
 	/*
@@ -69,6 +74,8 @@ void bl2_main(void)
 	disable_mmu_icache_secure();
 #endif /* AARCH32 */
 
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL2_EXIT);
+
 	/*
 	 * Run next BL image via an SMC to BL1. Information on how to pass
 	 * control to the BL32 (if present) and BL33 software images will
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <auth_mod.h>
+#include <bl_common.h>
+#include <boot_timeline.h>
+#include <debug.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <string.h>
+#include "bl2_private.h"
+
+/*
+ * Parallel image authentication
+ *
+ * The primary CPU loads the images one after the other. Instead of hashing
+ * each raw image before loading the next one, it queues the hash check and
+ * moves on. Secondary CPUs released by the platform take the checks from the
+ * queue. Once all the images are loaded, the primary CPU does the checks left
+ * in the queue itself, waits for the ones in progress and sends the secondary
+ * CPUs back to the platform.
+ *
+ * Certificates are still authenticated by the primary CPU, in order, as each
+ * of them provides the keys or hashes needed by the next ones.
+ */
+
+/* Maximum number of hash checks in flight. Platforms may override it. */
+#ifndef PLAT_BL2_AUTH_MAX_JOBS
+#define PLAT_BL2_AUTH_MAX_JOBS		4
+#endif
+
+#define JOB_FREE		0
+#define JOB_QUEUED		1
+#define JOB_RUNNING		2
+#define JOB_DONE		3
+
+typedef struct bl2_auth_job {
+	volatile unsigned int state;
+	unsigned int image_id;
+	uintptr_t image_base;
+	size_t image_size;
+	auth_hash_check_t check;
+	int result;
+	unsigned int core_pos;
+	uint64_t ticks;
+} bl2_auth_job_t;
+
+static bl2_auth_job_t jobs[PLAT_BL2_AUTH_MAX_JOBS];
+static spinlock_t jobs_lock;
+static volatile unsigned int workers_stop;
+static unsigned char workers_started[PLATFORM_CORE_COUNT];
+static uint64_t load_start, load_end;
+
+#pragma weak bl2_plat_secondary_start
+#pragma weak bl2_plat_secondary_stop
+
+/*
+ * Release a secondary CPU so that it calls bl2_parallel_auth_worker(). Return 0
+ * if it has been released. By default no secondary CPU is used.
+ */
+int bl2_plat_secondary_start(unsigned int core_pos)
+{
+	return -1;
+}
+
+/*
+ * Take back a secondary CPU once bl2_parallel_auth_worker() returned on it
+ */
+void bl2_plat_secondary_stop(unsigned int core_pos)
+{
+}
+
+/*
+ * Take the oldest hash check in the queue, if any
+ */
+static bl2_auth_job_t *job_claim(void)
+{
+	bl2_auth_job_t *job = NULL;
+	int i;
+
+	spin_lock(&jobs_lock);
+	for (i = 0; i < PLAT_BL2_AUTH_MAX_JOBS; i++) {
+		if (jobs[i].state == JOB_QUEUED) {
+			job = &jobs[i];
+			job->state = JOB_RUNNING;
+			break;
+		}
+	}
+	spin_unlock(&jobs_lock);
+
+	return job;
+}
+
+static void job_run(bl2_auth_job_t *job)
+{
+	uint64_t start = read_cntpct_el0();
+
+	BOOT_TIMELINE_RECORD_IMAGE(job->image_id, BOOT_TL_IMG_AUTH_START);
+	job->result = auth_mod_verify_hash_check(job->image_id, &job->check);
+	BOOT_TIMELINE_RECORD_IMAGE(job->image_id, BOOT_TL_IMG_AUTH_END);
+	job->core_pos = plat_my_core_pos();
+	job->ticks = read_cntpct_el0() - start;
+
+	/* Publish the result before the state */
+	dmbish();
+	job->state = JOB_DONE;
+	dsbish();
+	sev();
+}
+
+/*
+ * Main loop of the secondary CPUs, called by the platform once the CPU is
+ * running with the BL2 translation tables and a stack.
+ */
+void bl2_parallel_auth_worker(void)
+{
+	bl2_auth_job_t *job;
+
+	while (workers_stop == 0) {
+		job = job_claim();
+		if (job == NULL) {
+			wfe();
+			continue;
+		}
+		job_run(job);
+	}
+}
+
+/*
+ * Release the secondary CPUs before loading the images
+ */
+void bl2_parallel_auth_init(void)
+{
+	unsigned int core_pos, primary = plat_my_core_pos();
+	unsigned int started = 0;
+
+	load_start = read_cntpct_el0();
+
+	for (core_pos = 0; core_pos < PLATFORM_CORE_COUNT; core_pos++) {
+		if (core_pos == primary) {
+			continue;
+		}
+		if (bl2_plat_secondary_start(core_pos) == 0) {
+			workers_started[core_pos] = 1;
+			started++;
+		}
+	}
+
+	INFO("BL2: %u CPUs released for image authentication\n", started);
+}
+
+/*
+ * Load an image and queue its authentication. This has the same interface as
+ * load_auth_image(), which is used for the images that cannot be authenticated
+ * by a simple hash check or when the queue is full.
+ */
+int bl2_parallel_auth_load(meminfo_t *mem_layout,
+			   unsigned int image_id,
+			   uintptr_t image_base,
+			   image_info_t *image_data,
+			   entry_point_info_t *entry_point_info)
+{
+	bl2_auth_job_t *job = NULL;
+	unsigned int parent_id;
+	int rc, i;
+
+	/* Authenticate the certificates first */
+	rc = auth_mod_get_parent_id(image_id, &parent_id);
+	if (rc == 0) {
+		rc = load_auth_image(mem_layout, parent_id, image_base,
+				     image_data, NULL);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	for (i = 0; i < PLAT_BL2_AUTH_MAX_JOBS; i++) {
+		if (jobs[i].state == JOB_FREE) {
+			job = &jobs[i];
+			break;
+		}
+	}
+	if (job == NULL) {
+		return load_auth_image(mem_layout, image_id, image_base,
+				       image_data, entry_point_info);
+	}
+
+	rc = load_image(mem_layout, image_id, image_base, image_data,
+			entry_point_info);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = auth_mod_get_hash_check(image_id, (void *)image_data->image_base,
+				     image_data->image_size, &job->check);
+	if (rc != 0) {
+		/* Authenticate it now, as load_auth_image() does */
+		BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_START);
+		rc = auth_mod_verify_img(image_id,
+					 (void *)image_data->image_base,
+					 image_data->image_size);
+		BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_END);
+		if (rc != 0) {
+			memset((void *)image_data->image_base, 0x00,
+			       image_data->image_size);
+			flush_dcache_range(image_data->image_base,
+					   image_data->image_size);
+			return -EAUTH;
+		}
+		flush_dcache_range(image_data->image_base,
+				   image_data->image_size);
+		return 0;
+	}
+
+	job->image_id = image_id;
+	job->image_base = image_data->image_base;
+	job->image_size = image_data->image_size;
+
+	/* Publish the job before making it visible to the workers */
+	dmbish();
+	job->state = JOB_QUEUED;
+	dsbish();
+	sev();
+
+	return 0;
+}
+
+/*
+ * Wait for all the queued authentications, stop the secondary CPUs and
+ * report the time spent. Images that fail authentication are wiped out and
+ * the boot is stopped, as for load_auth_image().
+ */
+void bl2_parallel_auth_finish(void)
+{
+	bl2_auth_job_t *job;
+	unsigned long long freq = read_cntfrq_el0();
+	uint64_t end;
+	unsigned int core_pos;
+	int i, failed = 0;
+
+	load_end = read_cntpct_el0();
+
+	/* Help with the checks nobody has taken yet */
+	while ((job = job_claim()) != NULL) {
+		job_run(job);
+	}
+
+	for (i = 0; i < PLAT_BL2_AUTH_MAX_JOBS; i++) {
+		while (jobs[i].state == JOB_RUNNING) {
+			wfe();
+		}
+	}
+
+	workers_stop = 1;
+	dsbish();
+	sev();
+	for (core_pos = 0; core_pos < PLATFORM_CORE_COUNT; core_pos++) {
+		if (workers_started[core_pos] != 0) {
+			bl2_plat_secondary_stop(core_pos);
+		}
+	}
+
+	end = read_cntpct_el0();
+
+	/* Convert the counter ticks to microseconds if the frequency is set */
+	if (freq == 0) {
+		freq = 1000000;
+	}
+	INFO("BL2: images loaded in %llu us, authentication completed "
+	     "%llu us later\n",
+	     (unsigned long long)(load_end - load_start) * 1000000 / freq,
+	     (unsigned long long)(end - load_end) * 1000000 / freq);
+
+	for (i = 0; i < PLAT_BL2_AUTH_MAX_JOBS; i++) {
+		job = &jobs[i];
+		if (job->state != JOB_DONE) {
+			continue;
+		}
+
+		INFO("BL2: image id=%u (%zu bytes) checked by CPU %u in "
+		     "%llu us\n", job->image_id, job->image_size,
+		     job->core_pos,
+		     (unsigned long long)job->ticks * 1000000 / freq);
+
+		if (job->result != 0) {
+			ERROR("BL2: Failed to authenticate image id=%u\n",
+			      job->image_id);
+			memset((void *)job->image_base, 0x00, job->image_size);
+			failed = 1;
+		}
+
+		/*
+		 * Flush the image (or what is left of it) to main memory so
+		 * that it can be executed later by any CPU, regardless of
+		 * cache and MMU state.
+		 */
+		flush_dcache_range(job->image_base, job->image_size);
+		job->state = JOB_FREE;
+	}
+
+	if (failed != 0) {
+		plat_error_handler(-EAUTH);
+	}
+}
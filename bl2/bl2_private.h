@@ -35,11 +35,23 @@
  * Forward declarations
  *****************************************/
 struct entry_point_info;
+struct image_info;
+struct meminfo;
 
 /******************************************
  * Function prototypes
  *****************************************/
 void bl2_arch_setup(void);
 struct entry_point_info *bl2_load_images(void);
+#if BL2_PARALLEL_AUTH
+void bl2_parallel_auth_init(void);
+int bl2_parallel_auth_load(struct meminfo *mem_layout,
+			   unsigned int image_id,
+			   uintptr_t image_base,
+			   struct image_info *image_data,
+			   struct entry_point_info *entry_point_info);
+void bl2_parallel_auth_finish(void);
+void bl2_parallel_auth_worker(void);
+#endif
 
 #endif /* __BL2_PRIVATE_H__ */
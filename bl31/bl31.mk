@@ -41,7 +41,12 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				${PSCI_LIB_SOURCES}
 
 ifeq (${ENABLE_PMF}, 1)
-BL31_SOURCES		+=	lib/pmf/pmf_main.c
+BL31_SOURCES		+=	lib/pmf/pmf_main.c				\
+				lib/pmf/pmf_smc.c
+endif
+
+ifeq (${ENABLE_RT_SVC_STATS}, 1)
+BL31_SOURCES		+=	common/runtime_svc_stats.c
 endif
 
 BL31_LINKERFILE		:=	bl31/bl31.ld.S
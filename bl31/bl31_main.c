@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <bl_common.h>
 #include <bl31.h>
+#include <boot_timeline.h>
 #include <context_mgmt.h>
 #include <debug.h>
 #include <platform.h>
@@ -86,6 +87,8 @@ void bl31_lib_init(void)
  ******************************************************************************/
 void bl31_main(void)
 {
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL31_ENTRY);
+
 	NOTICE("BL31: %s\n", version_string);
 	NOTICE("BL31: %s\n", build_message);
 
@@ -97,7 +100,9 @@ void bl31_main(void)
 
 	/* Initialize the runtime services e.g. psci. */
 	INFO("BL31: Initializing runtime services\n");
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL31_RT_SVC_INIT_START);
 	runtime_svc_init();
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL31_RT_SVC_INIT_END);
 
 	/*
 	 * All the cold boot actions on the primary cpu are done. We now need to
@@ -127,6 +132,8 @@ void bl31_main(void)
 	 * from BL31
 	 */
 	bl31_plat_runtime_setup();
+
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL31_EXIT);
 }
 
 /*******************************************************************************
@@ -32,6 +32,7 @@
 ***************************************************************************
 */
 
+#include <boot_timeline.h>
 #include <debug.h>
 #include <console.h>
 #include <platform_def.h>
@@ -52,6 +53,9 @@ void mailbox_clean(void)
 int  __attribute__ ((section(".entry"))) ble_main(int bootrom_flags)
 {
 	int skip = 0;
+
+	BOOT_TIMELINE_RECORD(BOOT_TL_BLE_ENTRY);
+
 	/*
 	 * In some situations, like boot from UART, bootrom will
 	 * request to avoid printing to console. in that case don't
@@ -77,8 +81,15 @@ int  __attribute__ ((section(".entry"))) ble_main(int bootrom_flags)
 	if (skip)
 		return SKIP_IMAGE_CODE;
 
+#if ENABLE_BOOT_TIMELINE
+	/* DRAM is up, hand the timestamps taken so far to the timeline */
+	boot_timeline_init();
+#endif
+
 	/* clean mailbox from garbage data */
 	mailbox_clean();
 
+	BOOT_TIMELINE_RECORD(BOOT_TL_BLE_EXIT);
+
 	return 0;
 }
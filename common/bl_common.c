@@ -33,14 +33,27 @@
 #include <assert.h>
 #include <auth_mod.h>
 #include <bl_common.h>
+#include <boot_timeline.h>
 #include <debug.h>
 #include <errno.h>
 #include <io_storage.h>
+#include <limits.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <string.h>
 #include <utils.h>
 #include <xlat_tables.h>
 
+#if ENABLE_STREAMING_HASH
+/*
+ * Images are read in chunks of this size, each one being hashed right after it
+ * is read, while it is still in the data cache. Platforms may override it.
+ */
+#ifndef PLAT_LOAD_IMAGE_CHUNK_SIZE
+#define PLAT_LOAD_IMAGE_CHUNK_SIZE	(64 * 1024)
+#endif
+#endif /* ENABLE_STREAMING_HASH */
+
 uintptr_t page_align(uintptr_t value, unsigned dir)
 {
 	/* Round up the limit to the next page boundary */
@@ -221,6 +234,131 @@ size_t image_size(unsigned int image_id)
 	return image_size;
 }
 
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+/*******************************************************************************
+ * Report the time taken to read an image from its device and the resulting
+ * throughput, which mostly depends on the boot device and its IO driver.
+ ******************************************************************************/
+static void report_read_rate(unsigned int image_id, size_t size,
+			     unsigned long long start)
+{
+	unsigned long long ticks = read_cntpct_el0() - start;
+	unsigned long long freq = read_cntfrq_el0();
+	unsigned long long us;
+
+	if ((freq == 0) || (ticks == 0))
+		return;
+
+	us = ticks * 1000000 / freq;
+	VERBOSE("Image id=%u: 0x%zx bytes read in %llu us (%llu KB/s)\n",
+		image_id, size, us,
+		((unsigned long long)size * freq) / (ticks * 1024));
+}
+#else
+#define report_read_rate(image_id, size, start)
+#endif
+
+/*******************************************************************************
+ * Read a whole image. When ENABLE_STREAMING_HASH is set, the image is read in
+ * chunks of PLAT_LOAD_IMAGE_CHUNK_SIZE bytes which are passed to the
+ * authentication module as they arrive, so that the image hash is ready by the
+ * time the image is loaded.
+ ******************************************************************************/
+static int read_image(unsigned int image_id, uintptr_t image_handle,
+		      uintptr_t image_base, size_t image_size,
+		      size_t *bytes_read)
+{
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+	unsigned long long start = read_cntpct_el0();
+#endif
+	int io_result = 0;
+#if ENABLE_STREAMING_HASH
+	size_t chunk, chunk_read;
+
+	*bytes_read = 0;
+	while (*bytes_read < image_size) {
+		chunk = image_size - *bytes_read;
+		if (chunk > PLAT_LOAD_IMAGE_CHUNK_SIZE)
+			chunk = PLAT_LOAD_IMAGE_CHUNK_SIZE;
+
+		io_result = io_read(image_handle, image_base + *bytes_read,
+				    chunk, &chunk_read);
+		if ((io_result != 0) || (chunk_read == 0))
+			break;
+
+		auth_mod_hash_update(image_id,
+				     (void *)(image_base + *bytes_read),
+				     chunk_read);
+		*bytes_read += chunk_read;
+	}
+#else
+	io_result = io_read(image_handle, image_base, image_size, bytes_read);
+#endif /* ENABLE_STREAMING_HASH */
+
+	if (io_result == 0)
+		report_read_rate(image_id, *bytes_read, start);
+
+	return io_result;
+}
+
+#if TRUSTED_BOARD_BOOT && AUTH_VERIFY_IN_PLACE
+/*******************************************************************************
+ * Authenticate an image where it lies in its device, without loading it. This
+ * is only done for the images the authentication module can verify in place
+ * (the certificates) and whose device can map them into the address space,
+ * e.g. a FIP in memory. It saves the copy of each certificate to RAM.
+ *
+ * Returns 0 on success, -EAUTH if the authentication failed, or -ENODEV if
+ * the image must be loaded and authenticated by the caller instead.
+ ******************************************************************************/
+static int verify_mapped_image(unsigned int image_id)
+{
+	uintptr_t dev_handle;
+	uintptr_t image_handle;
+	uintptr_t image_spec;
+	uintptr_t image_ptr;
+	size_t image_size;
+	int rc;
+
+	if (!auth_mod_verify_in_place(image_id))
+		return -ENODEV;
+
+	if (plat_get_image_source(image_id, &dev_handle, &image_spec) != 0)
+		return -ENODEV;
+
+	rc = -ENODEV;
+	if (io_open(dev_handle, image_spec, &image_handle) != 0)
+		goto close_dev;
+
+	if ((io_size(image_handle, &image_size) != 0) || (image_size == 0) ||
+	    (image_size > UINT_MAX))
+		goto exit;
+
+	if (io_map(image_handle, image_size, &image_ptr) != 0)
+		goto exit;
+
+	INFO("Authenticating image id=%u in place at %p\n", image_id,
+	     (void *) image_ptr);
+
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_START);
+	rc = auth_mod_verify_img(image_id, (void *)image_ptr, image_size);
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_END);
+	if (rc != 0)
+		rc = -EAUTH;
+
+exit:
+	io_close(image_handle);
+	/* Ignore improbable/unrecoverable error in 'close' */
+
+close_dev:
+	/* Drop the reference taken by plat_get_image_source() */
+	io_dev_close(dev_handle);
+	/* Ignore improbable/unrecoverable error in 'dev_close' */
+
+	return rc;
+}
+#endif /* TRUSTED_BOARD_BOOT && AUTH_VERIFY_IN_PLACE */
+
 #if LOAD_IMAGE_V2
 
 /*******************************************************************************
@@ -284,11 +422,14 @@ int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_LOAD_START);
+	io_result = read_image(image_id, image_handle, image_base, image_size,
+			       &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_LOAD_END);
 
 #if !TRUSTED_BOARD_BOOT
 	/*
@@ -337,19 +478,37 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 			return rc;
 		}
 	}
+
+#if AUTH_VERIFY_IN_PLACE
+	/* Certificates do not need to be loaded if they can be mapped */
+	rc = verify_mapped_image(image_id);
+	if (rc != -ENODEV) {
+		return rc;
+	}
+#endif
 #endif /* TRUSTED_BOARD_BOOT */
 
+#if ENABLE_STREAMING_HASH
+	/* Hash the image while it is loaded, if possible */
+	auth_mod_hash_start(image_id);
+#endif
+
 	/* Load the image */
 	rc = load_image(image_id, image_data);
 	if (rc != 0) {
+#if ENABLE_STREAMING_HASH
+		auth_mod_hash_abort();
+#endif
 		return rc;
 	}
 
 #if TRUSTED_BOARD_BOOT
 	/* Authenticate it */
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_START);
 	rc = auth_mod_verify_img(image_id,
 				 (void *)image_data->image_base,
 				 image_data->image_size);
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_END);
 	if (rc != 0) {
 		memset((void *)image_data->image_base, 0x00,
 		       image_data->image_size);
@@ -444,11 +603,14 @@ int load_image(meminfo_t *mem_layout,
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_LOAD_START);
+	io_result = read_image(image_id, image_handle, image_base, image_size,
+			       &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_LOAD_END);
 
 	image_data->image_base = image_base;
 	image_data->image_size = image_size;
@@ -521,20 +683,38 @@ int load_auth_image(meminfo_t *mem_layout,
 			return rc;
 		}
 	}
+
+#if AUTH_VERIFY_IN_PLACE
+	/* Certificates do not need to be loaded if they can be mapped */
+	rc = verify_mapped_image(image_id);
+	if (rc != -ENODEV) {
+		return rc;
+	}
+#endif
 #endif /* TRUSTED_BOARD_BOOT */
 
+#if ENABLE_STREAMING_HASH
+	/* Hash the image while it is loaded, if possible */
+	auth_mod_hash_start(image_id);
+#endif
+
 	/* Load the image */
 	rc = load_image(mem_layout, image_id, image_base, image_data,
 			entry_point_info);
 	if (rc != 0) {
+#if ENABLE_STREAMING_HASH
+		auth_mod_hash_abort();
+#endif
 		return rc;
 	}
 
 #if TRUSTED_BOARD_BOOT
 	/* Authenticate it */
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_START);
 	rc = auth_mod_verify_img(image_id,
 				 (void *)image_data->image_base,
 				 image_data->image_size);
+	BOOT_TIMELINE_RECORD_IMAGE(image_id, BOOT_TL_IMG_AUTH_END);
 	if (rc != 0) {
 		memset((void *)image_data->image_base, 0x00,
 		       image_data->image_size);
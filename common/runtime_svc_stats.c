@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <runtime_svc.h>
+
+/*
+ * Per-CPU statistics of the SMCs handled by the runtime services. Each CPU
+ * only updates its own table, so no locking is needed. The first
+ * RT_SVC_STATS_ENTRIES function IDs seen by a CPU get an entry, later ones
+ * are only counted as dropped.
+ */
+typedef struct rt_svc_stats_entry {
+	uint32_t smc_fid;
+	uint32_t count;
+	uint64_t total_ticks;
+	uint64_t max_ticks;
+	uint32_t hist[RT_SVC_STATS_BUCKETS];
+} rt_svc_stats_entry_t;
+
+typedef struct rt_svc_stats {
+	unsigned int num_entries;
+	unsigned int dropped;
+	rt_svc_stats_entry_t entry[RT_SVC_STATS_ENTRIES];
+} __aligned(CACHE_WRITEBACK_GRANULE) rt_svc_stats_t;
+
+static rt_svc_stats_t rt_svc_stats[PLATFORM_CORE_COUNT];
+
+CASSERT(RT_SVC_STATS_DROPPED_TID <= PMF_TID_MASK, assert_rt_svc_stats_tids);
+
+static void rt_svc_stats_add(uint32_t smc_fid, uint64_t ticks)
+{
+	rt_svc_stats_t *stats = &rt_svc_stats[plat_my_core_pos()];
+	rt_svc_stats_entry_t *entry;
+	unsigned int i, bucket;
+
+	for (i = 0; i < stats->num_entries; i++)
+		if (stats->entry[i].smc_fid == smc_fid)
+			break;
+
+	if (i == stats->num_entries) {
+		if (i == RT_SVC_STATS_ENTRIES) {
+			stats->dropped++;
+			return;
+		}
+		stats->entry[i].smc_fid = smc_fid;
+		stats->num_entries++;
+	}
+
+	entry = &stats->entry[i];
+	entry->count++;
+	entry->total_ticks += ticks;
+	if (ticks > entry->max_ticks)
+		entry->max_ticks = ticks;
+
+	/* Bucket n counts the calls that took less than 4^(n+1) ticks */
+	for (bucket = 0; bucket < RT_SVC_STATS_BUCKETS - 1; bucket++)
+		if (ticks < (4ULL << (2 * bucket)))
+			break;
+	entry->hist[bucket]++;
+}
+
+/*******************************************************************************
+ * Replacement for the runtime service handler that is called by the SMC
+ * exception handler when ENABLE_RT_SVC_STATS is set. It looks up the handler
+ * of the service owning the function ID, and records the time spent in it.
+ ******************************************************************************/
+uintptr_t rt_svc_stats_handle(uint32_t smc_fid,
+			      u_register_t x1,
+			      u_register_t x2,
+			      u_register_t x3,
+			      u_register_t x4,
+			      void *cookie,
+			      void *handle,
+			      u_register_t flags)
+{
+	const rt_svc_desc_t *desc = (const rt_svc_desc_t *)
+				     &__RT_SVC_DESCS_START__;
+	unsigned long long start;
+	uintptr_t rc;
+
+	desc += rt_svc_descs_indices[get_unique_oen_from_smc_fid(smc_fid)];
+
+	start = read_cntpct_el0();
+	rc = desc->handle(smc_fid, x1, x2, x3, x4, cookie, handle, flags);
+	rt_svc_stats_add(smc_fid, read_cntpct_el0() - start);
+
+	return rc;
+}
+
+/*
+ * PMF time-stamp retrieval handler. The statistics are read one field at a
+ * time: the timestamp ID selects the entry and the field, see
+ * RT_SVC_STATS_TID(), and the MPIDR selects the CPU.
+ */
+static unsigned long long rt_svc_stats_get(unsigned int tid,
+					   u_register_t mpidr,
+					   unsigned int flags)
+{
+	unsigned int idx = (tid & PMF_TID_MASK) / RT_SVC_STATS_FIELDS;
+	unsigned int field = (tid & PMF_TID_MASK) % RT_SVC_STATS_FIELDS;
+	const rt_svc_stats_t *stats;
+	const rt_svc_stats_entry_t *entry;
+	int cpu = plat_core_pos_by_mpidr(mpidr);
+
+	if ((cpu < 0) || (cpu >= PLATFORM_CORE_COUNT))
+		return 0;
+
+	stats = &rt_svc_stats[cpu];
+	if ((tid & PMF_TID_MASK) == RT_SVC_STATS_DROPPED_TID)
+		return stats->dropped;
+
+	if (idx >= stats->num_entries)
+		return 0;
+
+	entry = &stats->entry[idx];
+	switch (field) {
+	case RT_SVC_STATS_FID:
+		return entry->smc_fid;
+	case RT_SVC_STATS_COUNT:
+		return entry->count;
+	case RT_SVC_STATS_TOTAL:
+		return entry->total_ticks;
+	case RT_SVC_STATS_MAX:
+		return entry->max_ticks;
+	default:
+		return entry->hist[field - RT_SVC_STATS_HIST];
+	}
+}
+
+PMF_REGISTER_SERVICE_SMC_OWN(rt_svc_stats, PMF_ARM_TIF_IMPL_ID,
+	PMF_RT_SVC_STATS_SVC_ID, RT_SVC_STATS_DROPPED_TID + 1, NULL,
+	rt_svc_stats_get)
@@ -54,6 +54,21 @@
 extern const auth_img_desc_t *const cot_desc_ptr;
 extern unsigned int auth_img_flags[];
 
+#if ENABLE_STREAMING_HASH
+/*
+ * Hash of an image being computed while it is loaded. 'base' and 'len' cover
+ * the data hashed so far, which must be the whole image for the result to be
+ * used by auth_mod_verify_img().
+ */
+static struct {
+	unsigned int img_id;
+	int active;
+	int failed;
+	uintptr_t base;
+	unsigned int len;
+} hash_stream;
+#endif /* ENABLE_STREAMING_HASH */
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -136,6 +151,35 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	return rc;
 }
 
+#if ENABLE_STREAMING_HASH
+/*
+ * Complete the hash computed while loading the image, if any.
+ *
+ * Return:
+ *   1 = the computed hash covers the image and its result is in '*rc'
+ *   0 = no usable hash, the image must be hashed again
+ */
+static int auth_hash_stream_final(unsigned int img_id,
+				  void *img, unsigned int img_len, int *rc)
+{
+	if ((hash_stream.active == 0) || (hash_stream.img_id != img_id)) {
+		return 0;
+	}
+
+	if ((hash_stream.failed != 0) ||
+	    (hash_stream.base != (uintptr_t)img) ||
+	    (hash_stream.len != img_len)) {
+		auth_mod_hash_abort();
+		return 0;
+	}
+
+	hash_stream.active = 0;
+	*rc = crypto_mod_hash_final();
+
+	return 1;
+}
+#endif /* ENABLE_STREAMING_HASH */
+
 /*
  * Authenticate by digital signature
  *
@@ -343,6 +387,198 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+#if AUTH_VERIFY_IN_PLACE
+/*
+ * Check whether an image can be authenticated where it lies in the boot device
+ * instead of being loaded first. This is the case of the certificates: they
+ * are only parsed, and the parameters needed by their children are copied out
+ * by auth_mod_verify_img(), so they do not have to be kept in memory.
+ *
+ * Return value:
+ *   1 = Image can be verified in place, 0 = Image must be loaded
+ */
+int auth_mod_verify_in_place(unsigned int img_id)
+{
+	return cot_desc_ptr[img_id].img_type == IMG_CERT;
+}
+#endif /* AUTH_VERIFY_IN_PLACE */
+
+#if ENABLE_STREAMING_HASH
+/*
+ * Start hashing an image while it is being loaded
+ *
+ * Only raw images authenticated by hash are handled: their parent has already
+ * been authenticated, so the expected hash is known before the image is read.
+ * Nothing is done for other images, nor if the crypto library cannot compute
+ * the hash in chunks, in which case the image is hashed by
+ * auth_mod_verify_img() once loaded.
+ */
+void auth_mod_hash_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *auth_method;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int i;
+
+	/* Drop any hash left over by a previous load */
+	auth_mod_hash_abort();
+
+	img_desc = &cot_desc_ptr[img_id];
+	if ((img_desc->img_type != IMG_RAW) || (img_desc->parent == NULL)) {
+		return;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type == AUTH_METHOD_HASH) {
+			break;
+		}
+	}
+	if (i == AUTH_METHOD_NUM) {
+		return;
+	}
+
+	if (auth_get_param(auth_method->param.hash.hash, img_desc->parent,
+			   &hash_der_ptr, &hash_der_len) != 0) {
+		return;
+	}
+
+	if (crypto_mod_hash_init(hash_der_ptr, hash_der_len) != 0) {
+		return;
+	}
+
+	hash_stream.img_id = img_id;
+	hash_stream.active = 1;
+	hash_stream.failed = 0;
+	hash_stream.base = 0;
+	hash_stream.len = 0;
+}
+
+/*
+ * Add a chunk of an image just loaded to its hash. The chunks must be
+ * contiguous and supplied in order, otherwise the image will be hashed again
+ * by auth_mod_verify_img().
+ */
+void auth_mod_hash_update(unsigned int img_id, void *ptr, unsigned int len)
+{
+	if ((hash_stream.active == 0) || (hash_stream.img_id != img_id) ||
+	    (hash_stream.failed != 0)) {
+		return;
+	}
+
+	if (hash_stream.len == 0) {
+		hash_stream.base = (uintptr_t)ptr;
+	} else if ((uintptr_t)ptr != hash_stream.base + hash_stream.len) {
+		hash_stream.failed = 1;
+		return;
+	}
+
+	if (crypto_mod_hash_update(ptr, len) != 0) {
+		hash_stream.failed = 1;
+		return;
+	}
+
+	hash_stream.len += len;
+}
+
+/*
+ * Drop the hash being computed, if any (e.g. when the image failed to load)
+ */
+void auth_mod_hash_abort(void)
+{
+	if (hash_stream.active != 0) {
+		hash_stream.active = 0;
+		(void)crypto_mod_hash_final();
+	}
+}
+#endif /* ENABLE_STREAMING_HASH */
+
+/*
+ * Get the hash check that authenticates an image, so that it can be done
+ * later, possibly on another CPU.
+ *
+ * Only raw images whose only authentication method is a hash provided by their
+ * (already authenticated) parent are accepted: once '*check' is filled, the
+ * image can be authenticated with auth_mod_verify_hash_check(), which only
+ * reads the image and the parent's hash. The other images must go through
+ * auth_mod_verify_img().
+ *
+ * Return: 0 = success, Otherwise = the image must use auth_mod_verify_img()
+ */
+int auth_mod_get_hash_check(unsigned int img_id,
+			    void *img_ptr,
+			    unsigned int img_len,
+			    auth_hash_check_t *check)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *auth_method;
+	const auth_method_param_hash_t *param = NULL;
+	int rc, i;
+
+	assert(check != NULL);
+
+	img_desc = &cot_desc_ptr[img_id];
+	if ((img_desc->img_type != IMG_RAW) || (img_desc->parent == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type == AUTH_METHOD_NONE) {
+			continue;
+		}
+		if ((auth_method->type != AUTH_METHOD_HASH) || (param != NULL)) {
+			return 1;
+		}
+		param = &auth_method->param.hash;
+	}
+	if (param == NULL) {
+		return 1;
+	}
+
+	/* No parameter must be extracted for the children images */
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		if (img_desc->authenticated_data[i].type_desc != NULL) {
+			return 1;
+		}
+	}
+
+	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
+	return_if_error(rc);
+
+	rc = auth_get_param(param->hash, img_desc->parent,
+			&check->hash_der_ptr, &check->hash_der_len);
+	return_if_error(rc);
+
+	rc = img_parser_get_auth_param(img_desc->img_type, param->data,
+			img_ptr, img_len, &check->data_ptr, &check->data_len);
+
+	return rc;
+}
+
+/*
+ * Do a hash check obtained from auth_mod_get_hash_check(). This only uses the
+ * stateless hash verification of the crypto module, so it may run on a
+ * secondary CPU while the primary one authenticates other images.
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_verify_hash_check(unsigned int img_id,
+			       const auth_hash_check_t *check)
+{
+	int rc;
+
+	rc = crypto_mod_verify_hash(check->data_ptr, check->data_len,
+				    check->hash_der_ptr, check->hash_der_len);
+	return_if_error(rc);
+
+	/* Mark image as authenticated */
+	auth_img_flags[img_id] |= IMG_FLAG_AUTHENTICATED;
+
+	return 0;
+}
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -361,6 +597,9 @@ void auth_mod_init(void)
 /*
  * Authenticate a certificate/image
  *
+ * The image is only read, so it may be in read-only memory, and it is not
+ * referenced once this function returns.
+ *
  * Return: 0 = success, Otherwise = error
  */
 int auth_mod_verify_img(unsigned int img_id,
@@ -389,6 +628,12 @@ int auth_mod_verify_img(unsigned int img_id,
 			rc = 0;
 			break;
 		case AUTH_METHOD_HASH:
+#if ENABLE_STREAMING_HASH
+			if (auth_hash_stream_final(img_id, img_ptr, img_len,
+						   &rc) != 0) {
+				break;
+			}
+#endif /* ENABLE_STREAMING_HASH */
 			rc = auth_hash(&auth_method->param.hash,
 					img_desc, img_ptr, img_len);
 			break;
@@ -127,3 +127,52 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start verifying a hash computed over data supplied in chunks
+ *
+ * Returns CRYPTO_ERR_HASH if the library does not support it, in which case
+ * crypto_mod_verify_hash() must be used once all the data is available.
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if (crypto_lib_desc.hash_init == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return crypto_lib_desc.hash_init(digest_info_ptr, digest_info_len);
+}
+
+/*
+ * Add a chunk of data to the hash started by crypto_mod_hash_init()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(crypto_lib_desc.hash_update != NULL);
+
+	return crypto_lib_desc.hash_update(data_ptr, data_len);
+}
+
+/*
+ * Compare the hash of all the data supplied since crypto_mod_hash_init() with
+ * the expected one. This also ends the computation, it must be called even if
+ * the result is not needed anymore.
+ */
+int crypto_mod_hash_final(void)
+{
+	assert(crypto_lib_desc.hash_final != NULL);
+
+	return crypto_lib_desc.hash_final();
+}
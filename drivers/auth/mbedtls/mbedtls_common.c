@@ -41,7 +41,17 @@
 #elif (MBEDTLS_KEY_ALG_ID == MBEDTLS_RSA)
 #define MBEDTLS_HEAP_SIZE		(8*1024)
 #endif
-static unsigned char heap[MBEDTLS_HEAP_SIZE];
+
+/*
+ * Room for the public keys kept parsed by the crypto library
+ */
+#ifdef MBEDTLS_PK_CACHE_ENTRIES
+#define MBEDTLS_PK_CACHE_HEAP_SIZE	(MBEDTLS_PK_CACHE_ENTRIES * 1024)
+#else
+#define MBEDTLS_PK_CACHE_HEAP_SIZE	0
+#endif
+
+static unsigned char heap[MBEDTLS_HEAP_SIZE + MBEDTLS_PK_CACHE_HEAP_SIZE];
 
 /*
  * mbed TLS initialization function
@@ -52,7 +62,7 @@ void mbedtls_init(void)
 
 	if (!ready) {
 		/* Initialize the mbed TLS heap */
-		mbedtls_memory_buffer_alloc_init(heap, MBEDTLS_HEAP_SIZE);
+		mbedtls_memory_buffer_alloc_init(heap, sizeof(heap));
 		ready = 1;
 	}
 }
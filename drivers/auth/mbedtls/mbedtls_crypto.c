@@ -43,6 +43,30 @@
 
 #define LIB_NAME		"mbed TLS"
 
+#if MBEDTLS_PK_CACHE_ENTRIES
+/*
+ * Cache of parsed public keys. The same keys are used to verify several
+ * certificates in a row, so keep the parsed contexts (allocated in the mbed TLS
+ * heap) instead of parsing the DER key again on every signature check.
+ * Entries are identified by the SHA-256 digest of the DER key and replaced in
+ * least recently used order.
+ */
+#define PK_CACHE_DIGEST_SIZE	32
+
+typedef struct {
+	unsigned char		digest[PK_CACHE_DIGEST_SIZE];
+	mbedtls_pk_context	pk;
+	unsigned int		last_use;
+	unsigned int		valid;
+} pk_cache_entry_t;
+
+static pk_cache_entry_t pk_cache[MBEDTLS_PK_CACHE_ENTRIES];
+static unsigned int pk_cache_clock;
+static unsigned int pk_cache_hits;
+static unsigned int pk_cache_misses;
+static unsigned int pk_cache_evictions;
+#endif
+
 /*
  * AlgorithmIdentifier  ::=  SEQUENCE  {
  *     algorithm               OBJECT IDENTIFIER,
@@ -69,6 +93,79 @@ static void init(void)
 	mbedtls_init();
 }
 
+#if MBEDTLS_PK_CACHE_ENTRIES
+/*
+ * Return the parsed public key for the DER encoded SubjectPublicKeyInfo at
+ * @pk_ptr, parsing it only if it is not in the cache. Returns NULL if the key
+ * cannot be parsed.
+ */
+static mbedtls_pk_context *pk_cache_get(void *pk_ptr, unsigned int pk_len)
+{
+	unsigned char digest[PK_CACHE_DIGEST_SIZE];
+	const mbedtls_md_info_t *md_info;
+	pk_cache_entry_t *entry, *victim = NULL;
+	unsigned char *p, *end;
+	unsigned int i;
+	int rc;
+
+	md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+	if ((md_info == NULL) ||
+	    (mbedtls_md(md_info, pk_ptr, pk_len, digest) != 0)) {
+		return NULL;
+	}
+
+	for (i = 0; i < MBEDTLS_PK_CACHE_ENTRIES; i++) {
+		entry = &pk_cache[i];
+		if (entry->valid &&
+		    (memcmp(entry->digest, digest, sizeof(digest)) == 0)) {
+			entry->last_use = ++pk_cache_clock;
+			pk_cache_hits++;
+			return &entry->pk;
+		}
+		/* Prefer a free entry, else the least recently used one */
+		if (victim == NULL) {
+			victim = entry;
+		} else if (!victim->valid) {
+			continue;
+		} else if (!entry->valid ||
+			   (entry->last_use < victim->last_use)) {
+			victim = entry;
+		}
+	}
+
+	pk_cache_misses++;
+	if (victim->valid) {
+		mbedtls_pk_free(&victim->pk);
+		victim->valid = 0;
+		pk_cache_evictions++;
+	}
+
+	mbedtls_pk_init(&victim->pk);
+	p = (unsigned char *)pk_ptr;
+	end = (unsigned char *)(p + pk_len);
+	rc = mbedtls_pk_parse_subpubkey(&p, end, &victim->pk);
+	if (rc != 0) {
+		mbedtls_pk_free(&victim->pk);
+		return NULL;
+	}
+
+	memcpy(victim->digest, digest, sizeof(digest));
+	victim->last_use = ++pk_cache_clock;
+	victim->valid = 1;
+
+	return &victim->pk;
+}
+
+/*
+ * Print the public key cache statistics
+ */
+void mbedtls_pk_cache_print_stats(void)
+{
+	INFO("%s: public key cache hits %u misses %u evictions %u\n",
+	     LIB_NAME, pk_cache_hits, pk_cache_misses, pk_cache_evictions);
+}
+#endif /* MBEDTLS_PK_CACHE_ENTRIES */
+
 /*
  * Verify a signature.
  *
@@ -84,7 +181,10 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	mbedtls_asn1_buf signature;
 	mbedtls_md_type_t md_alg;
 	mbedtls_pk_type_t pk_alg;
-	mbedtls_pk_context pk;
+	mbedtls_pk_context *pk;
+#if !MBEDTLS_PK_CACHE_ENTRIES
+	mbedtls_pk_context pk_ctx;
+#endif
 	int rc;
 	void *sig_opts = NULL;
 	const mbedtls_md_info_t *md_info;
@@ -106,13 +206,21 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Parse the public key */
-	mbedtls_pk_init(&pk);
+#if MBEDTLS_PK_CACHE_ENTRIES
+	pk = pk_cache_get(pk_ptr, pk_len);
+	if (pk == NULL) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+#else
+	pk = &pk_ctx;
+	mbedtls_pk_init(pk);
 	p = (unsigned char *)pk_ptr;
 	end = (unsigned char *)(p + pk_len);
-	rc = mbedtls_pk_parse_subpubkey(&p, end, &pk);
+	rc = mbedtls_pk_parse_subpubkey(&p, end, pk);
 	if (rc != 0) {
 		return CRYPTO_ERR_SIGNATURE;
 	}
+#endif
 
 	/* Get the signature (bitstring) */
 	p = (unsigned char *)sig_ptr;
@@ -139,7 +247,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Verify the signature */
-	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk, md_alg, hash,
+	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, pk, md_alg, hash,
 			mbedtls_md_get_size(md_info),
 			signature.p, signature.len);
 	if (rc != 0) {
@@ -151,24 +259,25 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	rc = CRYPTO_SUCCESS;
 
 end:
-	mbedtls_pk_free(&pk);
+#if !MBEDTLS_PK_CACHE_ENTRIES
+	mbedtls_pk_free(pk);
+#endif
 	return rc;
 }
 
 /*
- * Match a hash
+ * Get the hash algorithm and the hash value from a digest info.
  *
  * Digest info is passed in DER format following the ASN.1 structure detailed
  * above.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -192,8 +301,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -204,10 +313,33 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len,
+			     &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
 	p = (unsigned char *)data_ptr;
@@ -225,7 +357,88 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+#if ENABLE_STREAMING_HASH
+/*
+ * State of the hash computed over data supplied in chunks
+ */
+static mbedtls_md_context_t hash_ctx;
+static unsigned char hash_expected[MBEDTLS_MD_MAX_SIZE];
+static unsigned int hash_expected_len;
+
+/*
+ * Start a hash computation, to be matched against the digest info
+ */
+static int hash_init(void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len,
+			     &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	mbedtls_md_init(&hash_ctx);
+	rc = mbedtls_md_setup(&hash_ctx, md_info, 0);
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&hash_ctx);
+	}
+	if (rc != 0) {
+		mbedtls_md_free(&hash_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	hash_expected_len = mbedtls_md_get_size(md_info);
+	memcpy(hash_expected, hash, hash_expected_len);
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Add data to the hash computation
+ */
+static int hash_update(void *data_ptr, unsigned int data_len)
+{
+	if (mbedtls_md_update(&hash_ctx, (unsigned char *)data_ptr,
+			      data_len) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * End the hash computation and match the result
+ */
+static int hash_final(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = mbedtls_md_finish(&hash_ctx, data_hash);
+	mbedtls_md_free(&hash_ctx);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, hash_expected, hash_expected_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+#endif /* ENABLE_STREAMING_HASH */
+
 /*
  * Register crypto library descriptor
  */
+#if ENABLE_STREAMING_HASH
+REGISTER_CRYPTO_LIB_HASH_STREAM(LIB_NAME, init, verify_signature, verify_hash,
+				hash_init, hash_update, hash_final);
+#else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+#endif
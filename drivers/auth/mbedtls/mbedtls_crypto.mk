@@ -68,5 +68,27 @@ endif
 # mbed TLS libraries rely on this define to build correctly
 $(eval $(call add_define,MBEDTLS_KEY_ALG_ID))
 
+# Number of parsed public keys kept by the crypto library, 0 to disable
+ifeq (${MBEDTLS_PK_CACHE_ENTRIES},)
+    MBEDTLS_PK_CACHE_ENTRIES	:=	0
+endif
+
+$(eval $(call add_define,MBEDTLS_PK_CACHE_ENTRIES))
+
+# Compute SHA-256 with the ARMv8 Cryptographic Extension when the CPU has it
+ifeq (${MBEDTLS_SHA256_CE},)
+    MBEDTLS_SHA256_CE		:=	0
+endif
+
+ifeq (${MBEDTLS_SHA256_CE},1)
+    ifneq (${ARCH},aarch64)
+        $(error "MBEDTLS_SHA256_CE is only supported on AArch64")
+    endif
+    MBEDTLS_CRYPTO_SOURCES	+=	drivers/auth/mbedtls/mbedtls_sha256.c	\
+					drivers/auth/mbedtls/aarch64/sha256_ce.S
+endif
+
+$(eval $(call add_define,MBEDTLS_SHA256_CE))
+
 BL1_SOURCES			+=	${MBEDTLS_CRYPTO_SOURCES}
 BL2_SOURCES			+=	${MBEDTLS_CRYPTO_SOURCES}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <stdint.h>
+
+/* mbed TLS headers */
+#include <mbedtls/sha256.h>
+
+/*
+ * SHA-256 block function for mbed TLS (MBEDTLS_SHA256_PROCESS_ALT). The rest
+ * of the SHA-256 module (buffering, padding) is the one from mbed TLS.
+ *
+ * The block is processed with the ARMv8 Cryptographic Extension when the CPU
+ * implements the SHA-256 instructions, and with the portable code below
+ * otherwise.
+ */
+
+/* Implemented in aarch64/sha256_ce.S */
+void sha256_ce_process(uint32_t state[8], const unsigned char *data);
+
+static const uint32_t k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROR(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+#define S0(x)		(ROR(x, 7) ^ ROR(x, 18) ^ ((x) >> 3))
+#define S1(x)		(ROR(x, 17) ^ ROR(x, 19) ^ ((x) >> 10))
+#define S2(x)		(ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
+#define S3(x)		(ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
+#define CH(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+
+static void sha256_c_process(uint32_t state[8], const unsigned char *data)
+{
+	uint32_t w[64], s[8], t1, t2;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		w[i] = ((uint32_t)data[4 * i] << 24) |
+		       ((uint32_t)data[4 * i + 1] << 16) |
+		       ((uint32_t)data[4 * i + 2] << 8) |
+		       (uint32_t)data[4 * i + 3];
+	}
+	for (i = 16; i < 64; i++)
+		w[i] = S1(w[i - 2]) + w[i - 7] + S0(w[i - 15]) + w[i - 16];
+
+	for (i = 0; i < 8; i++)
+		s[i] = state[i];
+
+	for (i = 0; i < 64; i++) {
+		t1 = s[7] + S3(s[4]) + CH(s[4], s[5], s[6]) + k[i] + w[i];
+		t2 = S2(s[0]) + MAJ(s[0], s[1], s[2]);
+		s[7] = s[6];
+		s[6] = s[5];
+		s[5] = s[4];
+		s[4] = s[3] + t1;
+		s[3] = s[2];
+		s[2] = s[1];
+		s[1] = s[0];
+		s[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8; i++)
+		state[i] += s[i];
+}
+
+void mbedtls_sha256_process(mbedtls_sha256_context *ctx,
+			    const unsigned char data[64])
+{
+	unsigned int sha2;
+
+	sha2 = (read_id_aa64isar0_el1() >> ID_AA64ISAR0_SHA2_SHIFT) &
+		ID_AA64ISAR0_SHA2_MASK;
+	if (sha2 != 0)
+		sha256_ce_process(ctx->state, data);
+	else
+		sha256_c_process(ctx->state, data);
+}
@@ -37,11 +37,36 @@
 #include <platform_def.h>
 #include <string.h>
 
+#ifndef MAX_IO_BLOCK_CACHE_LINES
+#define MAX_IO_BLOCK_CACHE_LINES	0
+#endif
+
+#if MAX_IO_BLOCK_CACHE_LINES
+typedef struct {
+	int		lba;		/* First block held in the line */
+	size_t		blocks;		/* Valid blocks, 0 if the line is free */
+	unsigned int	last_use;	/* LRU stamp */
+} block_cache_line_t;
+
+typedef struct {
+	block_cache_line_t	lines[MAX_IO_BLOCK_CACHE_LINES];
+	unsigned int		num_lines;
+	size_t			line_blocks;
+	unsigned int		clock;
+	/* Reported by io_block_print_stats() */
+	unsigned int		hits;
+	unsigned int		misses;
+} block_cache_t;
+#endif
+
 typedef struct {
 	io_block_dev_spec_t	*dev_spec;
 	uintptr_t		base;
 	size_t			file_pos;
 	size_t			size;
+#if MAX_IO_BLOCK_CACHE_LINES
+	block_cache_t		cache;
+#endif
 } block_dev_state_t;
 
 #define is_power_of_2(x)	((x != 0) && ((x & (x - 1)) == 0))
@@ -73,6 +98,7 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.close		= block_close,
 	.dev_init	= NULL,
 	.dev_close	= block_dev_close,
+	.map		= NULL,
 };
 
 static block_dev_state_t state_pool[MAX_IO_BLOCK_DEVICES];
@@ -143,6 +169,122 @@ static int free_dev_info(io_dev_info_t *dev_info)
 	return result;
 }
 
+#if MAX_IO_BLOCK_CACHE_LINES
+/* Set up the cache geometry from the device specification */
+static void block_cache_init(block_dev_state_t *cur)
+{
+	block_cache_t *cache = &cur->cache;
+	io_block_spec_t *region = &cur->dev_spec->cache;
+	size_t block_size = cur->dev_spec->block_size;
+
+	memset(cache, 0, sizeof(block_cache_t));
+	if (region->length == 0)
+		return;
+
+	cache->line_blocks = cur->dev_spec->cache_line_blocks;
+	if (cache->line_blocks == 0)
+		cache->line_blocks = 1;
+	assert((region->offset % block_size) == 0);
+
+	cache->num_lines = region->length / (cache->line_blocks * block_size);
+	if (cache->num_lines > MAX_IO_BLOCK_CACHE_LINES)
+		cache->num_lines = MAX_IO_BLOCK_CACHE_LINES;
+}
+
+/*
+ * Return the address of the cached copy of block @lba, reading it and the
+ * blocks following it up to the end of the current region into a line on a
+ * miss. @avail is set to the number of cached blocks starting at @lba.
+ */
+static uintptr_t block_cache_get(block_dev_state_t *cur, int lba,
+				 size_t *avail)
+{
+	block_cache_t *cache = &cur->cache;
+	block_cache_line_t *line, *victim = NULL;
+	size_t block_size = cur->dev_spec->block_size;
+	size_t line_size = cache->line_blocks * block_size;
+	size_t blocks, count;
+	int end_lba;
+	unsigned int i;
+
+	for (i = 0; i < cache->num_lines; i++) {
+		line = &cache->lines[i];
+		if ((line->blocks != 0) && (lba >= line->lba) &&
+		    (lba < line->lba + (int)line->blocks)) {
+			line->last_use = ++cache->clock;
+			cache->hits++;
+			*avail = line->lba + line->blocks - lba;
+			return cur->dev_spec->cache.offset + i * line_size +
+			       (lba - line->lba) * block_size;
+		}
+		/* Prefer a free line, else the least recently used one */
+		if (victim == NULL)
+			victim = line;
+		else if (victim->blocks == 0)
+			continue;
+		else if ((line->blocks == 0) ||
+			 (line->last_use < victim->last_use))
+			victim = line;
+	}
+
+	assert(victim != NULL);
+	cache->misses++;
+
+	/* Read ahead, but not past the end of the region being accessed */
+	end_lba = (cur->base + cur->size + block_size - 1) / block_size;
+	assert(lba < end_lba);
+	blocks = cache->line_blocks;
+	if (lba + (int)blocks > end_lba)
+		blocks = end_lba - lba;
+
+	i = victim - cache->lines;
+	count = cur->dev_spec->ops.read(lba,
+					cur->dev_spec->cache.offset +
+					i * line_size,
+					blocks * block_size);
+	assert(count == blocks * block_size);
+
+	victim->lba = lba;
+	victim->blocks = blocks;
+	victim->last_use = ++cache->clock;
+	*avail = blocks;
+
+	return cur->dev_spec->cache.offset + i * line_size;
+}
+
+/*
+ * The cache is write-through: after @length bytes from @buffer have been
+ * written to the device at byte offset @offset, refresh any cached copy.
+ */
+static void block_cache_update(block_dev_state_t *cur, size_t offset,
+			       uintptr_t buffer, size_t length)
+{
+	block_cache_t *cache = &cur->cache;
+	block_cache_line_t *line;
+	size_t block_size = cur->dev_spec->block_size;
+	size_t line_size = cache->line_blocks * block_size;
+	size_t start, end;
+	unsigned int i;
+
+	for (i = 0; i < cache->num_lines; i++) {
+		line = &cache->lines[i];
+		if (line->blocks == 0)
+			continue;
+		start = line->lba * block_size;
+		end = start + line->blocks * block_size;
+		if ((offset >= end) || (offset + length <= start))
+			continue;
+		if (start < offset)
+			start = offset;
+		if (end > offset + length)
+			end = offset + length;
+		memcpy((void *)(cur->dev_spec->cache.offset + i * line_size +
+				start - line->lba * block_size),
+		       (void *)(buffer + (start - offset)), end - start);
+	}
+}
+#endif /* MAX_IO_BLOCK_CACHE_LINES */
+
 static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		      io_entity_t *entity)
 {
@@ -196,9 +338,12 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	block_dev_state_t *cur;
 	io_block_spec_t *buf;
 	io_block_ops_t *ops;
-	size_t aligned_length, skip, count, left, padding, block_size;
+	size_t skip, count, xfer, left, block_size, direct_min;
 	int lba;
-	int buffer_not_aligned;
+#if MAX_IO_BLOCK_CACHE_LINES
+	uintptr_t cached;
+	size_t avail;
+#endif
 
 	assert(entity->info != (uintptr_t)NULL);
 	cur = (block_dev_state_t *)entity->info;
@@ -209,87 +354,71 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	       (length > 0) &&
 	       (ops->read != 0));
 
-	if ((buffer & (block_size - 1)) != 0) {
-		/*
-		 * buffer isn't aligned with block size.
-		 * Block device always relies on DMA operation.
-		 * It's better to make the buffer as block size aligned.
-		 */
-		buffer_not_aligned = 1;
-	} else {
-		buffer_not_aligned = 0;
-	}
+	/*
+	 * With the cache enabled, only reads spanning at least a whole line
+	 * bypass it. Smaller ones are likely to be repeated (headers, tables
+	 * of contents...) or to be followed by a sequential read.
+	 */
+	direct_min = block_size;
+#if MAX_IO_BLOCK_CACHE_LINES
+	if (cur->cache.num_lines != 0)
+		direct_min = cur->cache.line_blocks * block_size;
+#endif
 
-	skip = cur->file_pos % block_size;
-	aligned_length = ((skip + length) + (block_size - 1)) &
-			 ~(block_size - 1);
-	padding = aligned_length - (skip + length);
-	left = aligned_length;
+	left = length;
 	do {
 		lba = (cur->file_pos + cur->base) / block_size;
-		if (left >= buf->length) {
+		skip = cur->file_pos % block_size;
+		if ((skip == 0) && (left >= direct_min) &&
+		    ((buffer & (block_size - 1)) == 0)) {
 			/*
-			 * Since left is larger, it's impossible to padding.
+			 * Both the position and the buffer are aligned with
+			 * the block size. Block device always relies on DMA
+			 * operation, so read all the remaining full blocks
+			 * straight into the caller's buffer at once.
+			 */
+			xfer = left & ~(block_size - 1);
+			count = ops->read(lba, buffer, xfer);
+			assert(count == xfer);
+#if MAX_IO_BLOCK_CACHE_LINES
+		} else if (cur->cache.num_lines != 0) {
+			cached = block_cache_get(cur, lba, &avail);
+			xfer = avail * block_size - skip;
+			if (xfer > left)
+				xfer = left;
+			memcpy((void *)buffer, (void *)(cached + skip), xfer);
+#endif
+		} else {
+			/*
+			 * The beginning address (file_pos) or the size isn't
+			 * aligned with block size, or the buffer isn't
+			 * aligned. Read through the block buffer to avoid
+			 * overflow and DMA errors.
 			 *
-			 * If buffer isn't aligned, we need to use aligned
-			 * buffer instead.
+			 * When the buffer and file_pos share the same offset
+			 * within a block, only this head (or tail) block needs
+			 * the block buffer and the rest is read directly.
+			 * Otherwise every block has to go through it.
 			 */
-			if (skip || buffer_not_aligned) {
-				/*
-				 * The beginning address (file_pos) isn't
-				 * aligned with block size, we need to use
-				 * block buffer to read block. Since block
-				 * device is always relied on DMA operation.
-				 */
-				count = ops->read(lba, buf->offset,
-						  buf->length);
+			if (((buffer - skip) & (block_size - 1)) == 0) {
+				xfer = block_size;
 			} else {
-				count = ops->read(lba, buffer, buf->length);
-			}
-			assert(count == buf->length);
-			cur->file_pos += count - skip;
-			if (skip || buffer_not_aligned) {
-				/*
-				 * Since there's not aligned block size caused
-				 * by skip or not aligned buffer, block buffer
-				 * is used to store data.
-				 */
-				memcpy((void *)buffer,
-				       (void *)(buf->offset + skip),
-				       count - skip);
+				xfer = ((skip + left) + (block_size - 1)) &
+				       ~(block_size - 1);
+				if (xfer > buf->length)
+					xfer = buf->length;
 			}
-			left = left - (count - skip);
-		} else {
-			if (skip || padding || buffer_not_aligned) {
-				/*
-				 * The beginning address (file_pos) isn't
-				 * aligned with block size, we have to read
-				 * full block by block buffer instead.
-				 * The size isn't aligned with block size.
-				 * Use block buffer to avoid overflow.
-				 *
-				 * If buffer isn't aligned, use block buffer
-				 * to avoid DMA error.
-				 */
-				count = ops->read(lba, buf->offset, left);
-			} else
-				count = ops->read(lba, buffer, left);
-			assert(count == left);
-			left = left - (skip + padding);
-			cur->file_pos += left;
-			if (skip || padding || buffer_not_aligned) {
-				/*
-				 * Since there's not aligned block size or
-				 * buffer, block buffer is used to store data.
-				 */
-				memcpy((void *)buffer,
-				       (void *)(buf->offset + skip),
-				       left);
-			}
-			/* It's already the last block operation */
-			left = 0;
+			count = ops->read(lba, buf->offset, xfer);
+			assert(count == xfer);
+			xfer -= skip;
+			if (xfer > left)
+				xfer = left;
+			memcpy((void *)buffer, (void *)(buf->offset + skip),
+			       xfer);
 		}
-		skip = cur->file_pos % block_size;
+		cur->file_pos += xfer;
+		buffer += xfer;
+		left -= xfer;
 	} while (left > 0);
 	*length_read = length;
 
@@ -305,6 +434,10 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 	size_t aligned_length, skip, count, left, padding, block_size;
 	int lba;
 	int buffer_not_aligned;
+	uintptr_t src = buffer;
+#if MAX_IO_BLOCK_CACHE_LINES
+	size_t start_offset;
+#endif
 
 	assert(entity->info != (uintptr_t)NULL);
 	cur = (block_dev_state_t *)entity->info;
@@ -315,6 +448,9 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 	       (length > 0) &&
 	       (ops->read != 0) &&
 	       (ops->write != 0));
+#if MAX_IO_BLOCK_CACHE_LINES
+	start_offset = cur->base + cur->file_pos;
+#endif
 
 	if ((buffer & (block_size - 1)) != 0) {
 		/*
@@ -347,14 +483,15 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 						  buf->length);
 				assert(count == buf->length);
 				memcpy((void *)(buf->offset + skip),
-				       (void *)buffer,
+				       (void *)src,
 				       count - skip);
 				count = ops->write(lba, buf->offset,
 						   buf->length);
 			} else
-				count = ops->write(lba, buffer, buf->length);
+				count = ops->write(lba, src, buf->length);
 			assert(count == buf->length);
 			cur->file_pos += count - skip;
+			src += count - skip;
 			left = left - (count - skip);
 		} else {
 			if (skip || padding || buffer_not_aligned) {
@@ -372,11 +509,11 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 				count = ops->read(lba, buf->offset, left);
 				assert(count == left);
 				memcpy((void *)(buf->offset + skip),
-				       (void *)buffer,
+				       (void *)src,
 				       left - skip - padding);
 				count = ops->write(lba, buf->offset, left);
 			} else
-				count = ops->write(lba, buffer, left);
+				count = ops->write(lba, src, left);
 			assert(count == left);
 			cur->file_pos += left - (skip + padding);
 			/* It's already the last block operation */
@@ -384,6 +521,9 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		}
 		skip = cur->file_pos % block_size;
 	} while (left > 0);
+#if MAX_IO_BLOCK_CACHE_LINES
+	block_cache_update(cur, start_offset, buffer, length);
+#endif
 	*length_written = length;
 	return 0;
 }
@@ -417,6 +557,12 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	       ((buffer->offset % block_size) == 0) &&
 	       ((buffer->length % block_size) == 0));
 
+#if MAX_IO_BLOCK_CACHE_LINES
+	block_cache_init(cur);
+#else
+	assert(cur->dev_spec->cache.length == 0);
+#endif
+
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
 	(void)buffer;
@@ -446,3 +592,20 @@ int register_io_dev_block(const io_dev_connector_t **dev_con)
 		*dev_con = &block_dev_connector;
 	return result;
 }
+
+#if MAX_IO_BLOCK_CACHE_LINES
+/* Print the block cache hits and misses of the open devices, e.g. at BL2 end */
+void io_block_print_stats(void)
+{
+	block_dev_state_t *cur;
+	int index;
+
+	for (index = 0; index < MAX_IO_BLOCK_DEVICES; ++index) {
+		cur = &state_pool[index];
+		if ((cur->dev_spec == NULL) || (cur->cache.num_lines == 0))
+			continue;
+		tf_printf("io_block %d: cache hits %u misses %u\n", index,
+			  cur->cache.hits, cur->cache.misses);
+	}
+}
+#endif
@@ -73,6 +73,7 @@ static const io_dev_funcs_t dummy_dev_funcs = {
 	.close = dummy_block_close,
 	.dev_init = NULL,
 	.dev_close = dummy_dev_close,
+	.map = NULL,
 };
 
 
@@ -59,10 +59,55 @@ typedef struct {
 	fip_toc_entry_t entry;
 } file_state_t;
 
+/*
+ * Maximum number of files which can be open in the package at the same time,
+ * e.g. a content certificate and the image it describes.
+ */
+#ifndef PLAT_FIP_MAX_FILES
+#define PLAT_FIP_MAX_FILES	2
+#endif
+
+/*
+ * Maximum number of Table of Contents entries held in the ToC index. A FIP
+ * with more entries is still usable, lookups that miss in the index fall
+ * back to scanning the ToC on the backend.
+ */
+#ifndef PLAT_FIP_TOC_CACHE_ENTRIES
+#define PLAT_FIP_TOC_CACHE_ENTRIES	20
+#endif
+
+/*
+ * Index of the Table of Contents, filled in by fip_dev_init() with a single
+ * backend read so that fip_file_open() does not need any backend I/O.
+ * 'complete' is set when the ToC end marker was found within the index.
+ */
+typedef struct {
+	unsigned int valid;
+	unsigned int complete;
+	unsigned int num_entries;
+	fip_toc_entry_t entries[PLAT_FIP_TOC_CACHE_ENTRIES];
+} toc_cache_t;
+
 static const uuid_t uuid_null = {0};
-static file_state_t current_file = {0};
+static file_state_t file_pool[PLAT_FIP_MAX_FILES];
+static toc_cache_t toc_cache;
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
+/*
+ * The backend is open while files are open in the package, and shared by
+ * them: backend_refs counts the open files. It is closed with the last one,
+ * so that the backend device is free for other users in between.
+ */
+static uintptr_t backend_handle;
+static unsigned int backend_refs;
+/*
+ * Number of io_dev_init() calls not yet balanced by io_dev_close(), and the
+ * image they initialised the device with. The header and the ToC are only
+ * read by the first one, so a platform may keep the device initialised for
+ * a whole boot stage.
+ */
+static unsigned int fip_dev_refs;
+static unsigned int fip_image_id;
 
 
 /* Firmware Image Package driver functions */
@@ -73,6 +118,8 @@ static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
+static int fip_file_map(io_entity_t *entity, size_t length,
+			uintptr_t *address);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
 
@@ -95,6 +142,105 @@ static inline int is_valid_header(fip_toc_header_t *header)
 }
 
 
+/* Open the backend for a file of the package, if not already open */
+static int fip_backend_get(void)
+{
+	int result;
+
+	if (backend_refs == 0) {
+		result = io_open(backend_dev_handle, backend_image_spec,
+				 &backend_handle);
+		if (result != 0) {
+			WARN("Failed to open Firmware Image Package (%i)\n",
+			     result);
+			backend_handle = (uintptr_t)NULL;
+			return -ENOENT;
+		}
+	}
+
+	backend_refs++;
+	return 0;
+}
+
+
+/* Release the backend on behalf of a file, closing it with the last one */
+static void fip_backend_put(void)
+{
+	assert(backend_refs != 0);
+
+	if (--backend_refs == 0) {
+		io_close(backend_handle);
+		backend_handle = (uintptr_t)NULL;
+	}
+}
+
+
+/*
+ * Read the Table of Contents into the ToC index. The backend handle must be
+ * positioned right after the FIP header. A failure here is not fatal, it only
+ * means that files will be looked up on the backend.
+ */
+static void fip_toc_cache_fill(void)
+{
+	size_t fip_size;
+	size_t length = sizeof(toc_cache.entries);
+	size_t bytes_read;
+	unsigned int i;
+
+	memset(&toc_cache, 0, sizeof(toc_cache));
+
+	/* Do not read past the end of the FIP */
+	if (io_size(backend_handle, &fip_size) == 0) {
+		if (fip_size <= sizeof(fip_toc_header_t))
+			return;
+		if (fip_size - sizeof(fip_toc_header_t) < length)
+			length = fip_size - sizeof(fip_toc_header_t);
+	}
+
+	if (io_read(backend_handle, (uintptr_t)toc_cache.entries, length,
+		    &bytes_read) != 0) {
+		WARN("Failed to read FIP ToC\n");
+		return;
+	}
+
+	for (i = 0; i < bytes_read / sizeof(fip_toc_entry_t); i++) {
+		if (compare_uuids(&toc_cache.entries[i].uuid,
+				  &uuid_null) == 0) {
+			toc_cache.complete = 1;
+			break;
+		}
+	}
+
+	toc_cache.num_entries = i;
+	toc_cache.valid = 1;
+	VERBOSE("FIP ToC index: %u entries%s\n", toc_cache.num_entries,
+		toc_cache.complete ? "" : " (partial)");
+}
+
+
+/*
+ * Look up @uuid in the ToC index.
+ * Returns 0 and fills @entry on a hit, -ENOENT if the file is known not to be
+ * in the FIP and -EAGAIN if the backend has to be scanned.
+ */
+static int fip_toc_cache_lookup(const uuid_t *uuid, fip_toc_entry_t *entry)
+{
+	unsigned int i;
+
+	if (!toc_cache.valid)
+		return -EAGAIN;
+
+	for (i = 0; i < toc_cache.num_entries; i++) {
+		if (compare_uuids(&toc_cache.entries[i].uuid, uuid) == 0) {
+			*entry = toc_cache.entries[i];
+			return 0;
+		}
+	}
+
+	return toc_cache.complete ? -ENOENT : -EAGAIN;
+}
+
+
 /* Identify the device type as a virtual driver */
 io_type_t device_type_fip(void)
 {
@@ -117,6 +263,7 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
 	.dev_close = fip_dev_close,
+	.map = fip_file_map,
 };
 
 
@@ -143,10 +290,24 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
-	uintptr_t backend_handle;
 	fip_toc_header_t header;
 	size_t bytes_read;
 
+	/* Already initialised with this package, the ToC index is valid */
+	if ((fip_dev_refs != 0) && (image_id == fip_image_id)) {
+		fip_dev_refs++;
+		return 0;
+	}
+
+	/* The backend cannot change under open files */
+	if (backend_refs != 0) {
+		WARN("FIP in use, cannot switch to image id=%u\n", image_id);
+		return -EBUSY;
+	}
+
+	fip_dev_refs = 0;
+	memset(&toc_cache, 0, sizeof(toc_cache));
+
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_id, &backend_dev_handle,
 				       &backend_image_spec);
@@ -158,11 +319,9 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 	}
 
 	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = fip_backend_get();
 	if (result != 0) {
 		WARN("Failed to access image id=%u (%i)\n", image_id, result);
-		result = -ENOENT;
 		goto fip_dev_init_exit;
 	}
 
@@ -174,10 +333,13 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			result = -ENOENT;
 		} else {
 			VERBOSE("FIP header looks OK.\n");
+			fip_toc_cache_fill();
+			fip_image_id = image_id;
+			fip_dev_refs = 1;
 		}
 	}
 
-	io_close(backend_handle);
+	fip_backend_put();
 
  fip_dev_init_exit:
 	return result;
@@ -186,9 +348,22 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 /* Close a connection to the FIP device */
 static int fip_dev_close(io_dev_info_t *dev_info)
 {
-	/* TODO: Consider tracking open files and cleaning them up here */
+	/* Still initialised on behalf of another user */
+	if (fip_dev_refs > 1) {
+		fip_dev_refs--;
+		return 0;
+	}
+	fip_dev_refs = 0;
+
+	/* Forget about any file still open, they cannot be read anymore */
+	memset(file_pool, 0, sizeof(file_pool));
+	if (backend_refs != 0) {
+		backend_refs = 1;
+		fip_backend_put();
+	}
 
-	/* Clear the backend. */
+	/* Invalidate the ToC index and clear the backend */
+	memset(&toc_cache, 0, sizeof(toc_cache));
 	backend_dev_handle = (uintptr_t)NULL;
 	backend_image_spec = (uintptr_t)NULL;
 
@@ -201,77 +376,84 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
 {
 	int result;
-	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
+	file_state_t *fp = NULL;
+	fip_toc_entry_t entry;
 	size_t bytes_read;
-	int found_file = 0;
+	unsigned int i;
 
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
+	/* Find a free file state. We need to track state like file cursor
+	 * position. We know the header lives at offset zero, so the entry
+	 * offset should never be zero for an active file.
 	 */
-	if (current_file.entry.offset_address != 0) {
-		WARN("fip_file_open : Only one open file at a time.\n");
+	for (i = 0; i < PLAT_FIP_MAX_FILES; i++) {
+		if (file_pool[i].entry.offset_address == 0) {
+			fp = &file_pool[i];
+			break;
+		}
+	}
+
+	if (fp == NULL) {
+		WARN("fip_file_open : Too many open files.\n");
 		return -ENOMEM;
 	}
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_open_exit;
+	if (fip_dev_refs == 0) {
+		WARN("Firmware Image Package not initialised\n");
+		return -ENOENT;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
-	result = io_seek(backend_handle, IO_SEEK_SET, sizeof(fip_toc_header_t));
+	/* Try the ToC index first, it avoids any backend access */
+	result = fip_toc_cache_lookup(&uuid_spec->uuid, &entry);
+	if (result == -ENOENT)
+		return result;
+
+	if (fip_backend_get() != 0)
+		return -ENOENT;
+
 	if (result != 0) {
-		WARN("fip_file_open: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_open_close;
-	}
+		/* Seek past the FIP header into the Table of Contents */
+		result = io_seek(backend_handle, IO_SEEK_SET,
+				 sizeof(fip_toc_header_t));
+		if (result != 0) {
+			WARN("fip_file_open: failed to seek\n");
+			result = -ENOENT;
+			goto fip_file_open_fail;
+		}
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_file.entry,
-				 sizeof(current_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
+		result = -ENOENT;
+		do {
+			if (io_read(backend_handle, (uintptr_t)&entry,
+				    sizeof(entry), &bytes_read) != 0) {
+				WARN("Failed to read FIP\n");
+				goto fip_file_open_fail;
+			}
+			if (compare_uuids(&entry.uuid, &uuid_spec->uuid) == 0) {
+				result = 0;
 				break;
 			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
+		} while (compare_uuids(&entry.uuid, &uuid_null) != 0);
+
+		if (result != 0) {
+			/* Did not find the file in the FIP. */
+			goto fip_file_open_fail;
 		}
-	} while (compare_uuids(&current_file.entry.uuid, &uuid_null) != 0);
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_file.entry' holds the
-		 * base and size of the file.
-		 */
-		current_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_file;
-	} else {
-		/* Did not find the file in the FIP. */
-		current_file.entry.offset_address = 0;
-		result = -ENOENT;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
+	/* All fine. Update entity info with file state and return. Set the
+	 * file position to 0. The 'entry' holds the base and size of the file.
+	 */
+	fp->entry = entry;
+	fp->file_pos = 0;
+	entity->info = (uintptr_t)fp;
+
+	return 0;
 
- fip_file_open_exit:
+ fip_file_open_fail:
+	fip_backend_put();
 	return result;
 }
 
@@ -296,7 +478,6 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	file_state_t *fp;
 	size_t file_offset;
 	size_t bytes_read;
-	uintptr_t backend_handle;
 
 	assert(entity != NULL);
 #ifndef PLAT_ALLOW_ZERO_ADDR_COPY
@@ -304,56 +485,86 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 #endif
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
-
-	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open FIP (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_exit;
-	}
+	assert(backend_handle != (uintptr_t)NULL);
 
 	fp = (file_state_t *)entity->info;
 
-	/* Seek to the position in the FIP where the payload lives */
+	/* Seek to the position in the FIP where the payload lives. The
+	 * backend is shared by all open files so always seek first.
+	 */
 	file_offset = fp->entry.offset_address + fp->file_pos;
 	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
 	if (result != 0) {
 		WARN("fip_file_read: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_read_close;
+		return -ENOENT;
 	}
 
 	result = io_read(backend_handle, buffer, length, &bytes_read);
 	if (result != 0) {
 		/* We cannot read our data. Fail. */
 		WARN("Failed to read payload (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_close;
-	} else {
-		/* Set caller length and new file position. */
-		*length_read = bytes_read;
-		fp->file_pos += bytes_read;
+		return -ENOENT;
 	}
 
-/* Close the backend. */
- fip_file_read_close:
-	io_close(backend_handle);
+	/* Set caller length and new file position. */
+	*length_read = bytes_read;
+	fp->file_pos += bytes_read;
 
- fip_file_read_exit:
-	return result;
+	return 0;
+}
+
+
+/* Map a file in package, if the backend can map the FIP itself */
+static int fip_file_map(io_entity_t *entity, size_t length,
+			uintptr_t *address)
+{
+	int result;
+	file_state_t *fp;
+	size_t file_offset;
+
+	assert(entity != NULL);
+	assert(address != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+	assert(backend_handle != (uintptr_t)NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	if ((fp->file_pos > fp->entry.size) ||
+	    (length > fp->entry.size - fp->file_pos))
+		return -EINVAL;
+
+	/* The backend is shared by all open files so always seek first */
+	file_offset = fp->entry.offset_address + fp->file_pos;
+	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
+	if (result != 0) {
+		WARN("fip_file_map: failed to seek\n");
+		return -ENOENT;
+	}
+
+	/* Returns -ENODEV if the backend cannot map, e.g. a block device */
+	result = io_map(backend_handle, length, address);
+	if (result != 0)
+		return result;
+
+	fp->file_pos += length;
+
+	return 0;
 }
 
 
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
-	 * If we had malloc() we would free() here.
+	assert(entity != NULL);
+
+	/* Release the file state back to the pool, and the backend with it.
+	 * If we had malloc() we would free() here. A file left open when the
+	 * device was closed has already been released.
 	 */
-	if (current_file.entry.offset_address != 0) {
-		memset(&current_file, 0, sizeof(current_file));
+	if ((entity->info != (uintptr_t)NULL) &&
+	    (((file_state_t *)entity->info)->entry.offset_address != 0)) {
+		memset((void *)entity->info, 0, sizeof(file_state_t));
+		fip_backend_put();
 	}
 
 	/* Clear the Entity info. */
@@ -69,6 +69,8 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
 static int memmap_block_close(io_entity_t *entity);
+static int memmap_block_map(io_entity_t *entity, size_t length,
+			    uintptr_t *address);
 static int memmap_dev_close(io_dev_info_t *dev_info);
 
 
@@ -87,6 +89,7 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.close = memmap_block_close,
 	.dev_init = NULL,
 	.dev_close = memmap_dev_close,
+	.map = memmap_block_map,
 };
 
 
@@ -226,6 +229,32 @@ static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 }
 
 
+/*
+ * Hand out the address of the data at the file cursor instead of copying it,
+ * for callers that only need to read it, e.g. to parse it in place.
+ */
+static int memmap_block_map(io_entity_t *entity, size_t length,
+			    uintptr_t *address)
+{
+	file_state_t *fp;
+
+	assert(entity != NULL);
+	assert(address != NULL);
+
+	fp = (file_state_t *)entity->info;
+
+	if ((fp->file_pos > fp->size) || (length > fp->size - fp->file_pos))
+		return -EINVAL;
+
+	*address = fp->base + fp->file_pos;
+
+	/* advance the file 'cursor' as a read would */
+	fp->file_pos += length;
+
+	return 0;
+}
+
+
 /* Close a file on the memmap device */
 static int memmap_block_close(io_entity_t *entity)
 {
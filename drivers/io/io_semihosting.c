@@ -70,6 +70,7 @@ static const io_dev_funcs_t sh_dev_funcs = {
 	.close = sh_file_close,
 	.dev_init = NULL,	/* NOP */
 	.dev_close = NULL,	/* NOP */
+	.map = NULL,
 };
 
 
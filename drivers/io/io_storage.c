@@ -340,6 +340,28 @@ int io_write(uintptr_t handle,
 }
 
 
+/*
+ * Return in 'address' a read-only pointer to the next 'length' bytes of an IO
+ * entity, and advance its position as io_read() would. This is only supported
+ * by devices whose content is directly addressable, the others return -ENODEV
+ * and must be read into a buffer instead.
+ */
+int io_map(uintptr_t handle, size_t length, uintptr_t *address)
+{
+	int result = -ENODEV;
+	assert(is_valid_entity(handle) && (address != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->map != NULL)
+		result = dev->funcs->map(entity, length, address);
+
+	return result;
+}
+
+
 /* Close an IO entity */
 int io_close(uintptr_t handle)
 {
@@ -0,0 +1,318 @@
+/*
+ * ***************************************************************************
+ * Copyright (C) 2017 Marvell International Ltd.
+ * ***************************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of Marvell nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************
+ */
+
+/*
+ * Address decoding map validation.
+ *
+ * The AP (CCU and RFU) and CP (IOB and AMB) address decoding windows are
+ * described by the board memory map tables. They are all checked here, in
+ * one pass and before any of them is programmed, for alignment, window count
+ * and overlaps. Alignment errors are fixed up in the tables, so the decoding
+ * drivers only have to write the registers.
+ */
+
+#include <plat_def.h>
+#include <debug.h>
+#include <mvebu.h>
+#include <plat_config.h>
+#include <addr_map.h>
+
+#define ADDR_MAP_WIN_ALIGNMENT_1M	(0x100000)
+#define ADDR_MAP_AMB_BASE_SHIFT		(16)
+
+/* The IOB has the largest windows count, and all the CPs are checked at once */
+#define ADDR_MAP_MAX_WIN		(IOB_MAX_WIN_NUM * CP_COUNT)
+
+struct addr_map_win {
+	uint64_t base;
+	uint64_t size;
+	uint32_t target_id;
+};
+
+struct addr_map_rules {
+	const char *name;
+	uint32_t max_win;	/* Windows available for the memory map */
+	uint64_t base_align;
+	uint64_t size_align;	/* 0 if the size must be a power of 2 */
+};
+
+static struct addr_map_win addr_map_wins[ADDR_MAP_MAX_WIN];
+
+/* CCU, RFU and IOB windows share the same layout */
+#define WIN_TO_ADDR_MAP(_map, _win)					\
+	do {								\
+		(_map)->base = ((uint64_t)(_win)->base_addr_high << 32) +	\
+				(_win)->base_addr_low;			\
+		(_map)->size = ((uint64_t)(_win)->win_size_high << 32) +	\
+				(_win)->win_size_low;			\
+		(_map)->target_id = (_win)->target_id;			\
+	} while (0)
+
+#define ADDR_MAP_TO_WIN(_win, _map)					\
+	do {								\
+		(_win)->base_addr_high = (uint32_t)((_map)->base >> 32);	\
+		(_win)->base_addr_low = (uint32_t)((_map)->base);	\
+		(_win)->win_size_high = (uint32_t)((_map)->size >> 32);	\
+		(_win)->win_size_low = (uint32_t)((_map)->size);	\
+	} while (0)
+
+/*
+ * Align the windows as required by the decoder, with a warning. Returns the
+ * count of empty windows, which cannot be fixed.
+ */
+static int addr_map_fixup(const struct addr_map_rules *rules,
+			  struct addr_map_win *win, uint32_t count)
+{
+	uint64_t size;
+	uint32_t n;
+	int errors = 0;
+
+	for (n = 0; n < count; n++, win++) {
+		if (win->size == 0) {
+			ERROR("%s window %d: empty window\n", rules->name, n);
+			errors++;
+		}
+
+		if (IS_NOT_ALIGN(win->base, rules->base_align)) {
+			win->base = ALIGN_UP(win->base, rules->base_align);
+			WARN("%s window %d: base address unaligned to 0x%lx, aligned up to 0x%lx\n",
+			     rules->name, n, rules->base_align, win->base);
+		}
+
+		if (rules->size_align == 0) {
+			if (win->size == 0 || IS_POWER_OF_2(win->size))
+				continue;
+			for (size = 1; size < win->size; size <<= 1)
+				;
+		} else if (IS_NOT_ALIGN(win->size, rules->size_align)) {
+			size = ALIGN_UP(win->size, rules->size_align);
+		} else {
+			continue;
+		}
+
+		WARN("%s window %d: invalid size 0x%lx, rounded up to 0x%lx\n",
+		     rules->name, n, win->size, size);
+		win->size = size;
+	}
+
+	return errors;
+}
+
+/* Returns the count of overlapping windows pairs */
+static int addr_map_check_overlap(const char *name,
+				  const struct addr_map_win *win, uint32_t count)
+{
+	uint32_t i, j;
+	int errors = 0;
+
+	for (i = 0; i < count; i++) {
+		for (j = i + 1; j < count; j++) {
+			if ((win[i].base < win[j].base + win[j].size) &&
+			    (win[j].base < win[i].base + win[i].size)) {
+				ERROR("%s windows %d and %d overlap (0x%lx-0x%lx, 0x%lx-0x%lx)\n",
+				      name, i, j, win[i].base,
+				      win[i].base + win[i].size - 1, win[j].base,
+				      win[j].base + win[j].size - 1);
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+
+static int addr_map_check(const struct addr_map_rules *rules,
+			  struct addr_map_win *win, uint32_t count)
+{
+	return addr_map_fixup(rules, win, count) +
+	       addr_map_check_overlap(rules->name, win, count);
+}
+
+static int addr_map_check_ccu(void)
+{
+	struct addr_map_rules rules = { "CCU", CCU_MAX_WIN_NUM,
+		ADDR_MAP_WIN_ALIGNMENT_1M, ADDR_MAP_WIN_ALIGNMENT_1M };
+	struct ccu_win *ccu_win;
+	uint32_t count, n;
+	int errors;
+
+	marvell_get_ccu_memory_map(&ccu_win, &count);
+	n = marvell_get_ccu_max_win();
+	if (n != 0 && n < CCU_MAX_WIN_NUM)
+		rules.max_win = n;
+
+	if (count > rules.max_win) {
+		ERROR("CCU: %d windows requested, %d available\n", count, rules.max_win);
+		return 1;
+	}
+
+	for (n = 0; n < count; n++)
+		WIN_TO_ADDR_MAP(&addr_map_wins[n], &ccu_win[n]);
+
+	errors = addr_map_check(&rules, addr_map_wins, count);
+
+	for (n = 0; n < count; n++)
+		ADDR_MAP_TO_WIN(&ccu_win[n], &addr_map_wins[n]);
+
+	return errors;
+}
+
+static int addr_map_check_rfu(void)
+{
+	/* RFU window 0 is reserved for the BootROM */
+	const struct addr_map_rules rules = { "RFU", RFU_MAX_WIN_ID - 1,
+		ADDR_MAP_WIN_ALIGNMENT_1M, ADDR_MAP_WIN_ALIGNMENT_1M };
+	struct rfu_win *rfu_win;
+	uint32_t count, n;
+	int errors = 0;
+
+	marvell_get_rfu_memory_map(&rfu_win, &count);
+	if (count > rules.max_win) {
+		ERROR("RFU: %d windows requested, %d available\n", count, rules.max_win);
+		return 1;
+	}
+
+	for (n = 0; n < count; n++) {
+		if (rfu_win[n].target_id >= RFU_MAX_TID) {
+			ERROR("RFU window %d: invalid target ID %d\n", n, rfu_win[n].target_id);
+			errors++;
+		}
+		WIN_TO_ADDR_MAP(&addr_map_wins[n], &rfu_win[n]);
+	}
+
+	errors += addr_map_check(&rules, addr_map_wins, count);
+
+	for (n = 0; n < count; n++)
+		ADDR_MAP_TO_WIN(&rfu_win[n], &addr_map_wins[n]);
+
+	return errors;
+}
+
+/*
+ * The IOB windows of all the CPs are in the AP address space, so on top of
+ * the per CP checks, the windows of different CPs must not overlap either.
+ */
+static int addr_map_check_iob(void)
+{
+	/* IOB window 0 is reserved for the CP internal registers */
+	struct addr_map_rules rules = { "IOB", IOB_MAX_WIN_NUM - 1,
+		ADDR_MAP_WIN_ALIGNMENT_1M, ADDR_MAP_WIN_ALIGNMENT_1M };
+	struct iob_win *iob_win;
+	uint32_t count, total = 0, n;
+	int cp, errors = 0;
+
+	n = marvell_get_iob_max_win();
+	if (n != 0 && n < IOB_MAX_WIN_NUM)
+		rules.max_win = n - 1;
+
+	for (cp = 0; cp < CP_COUNT; cp++) {
+		if (marvell_get_iob_memory_map(&iob_win, &count, cp))
+			continue;
+
+		if (count > rules.max_win) {
+			ERROR("CP%d IOB: %d windows requested, %d available\n",
+			      cp, count, rules.max_win);
+			errors++;
+			continue;
+		}
+
+		for (n = 0; n < count; n++)
+			WIN_TO_ADDR_MAP(&addr_map_wins[total + n], &iob_win[n]);
+
+		errors += addr_map_check(&rules, &addr_map_wins[total], count);
+
+		for (n = 0; n < count; n++)
+			ADDR_MAP_TO_WIN(&iob_win[n], &addr_map_wins[total + n]);
+
+		total += count;
+	}
+
+	if (CP_COUNT > 1)
+		errors += addr_map_check_overlap("CPs IOB", addr_map_wins, total);
+
+	return errors;
+}
+
+static int addr_map_check_amb(void)
+{
+	const struct addr_map_rules rules = { "AMB", AMB_MAX_WIN_ID,
+		ADDR_MAP_WIN_ALIGNMENT_1M, 0 };
+	struct amb_win *amb_win;
+	uint32_t count, n;
+	int errors;
+
+	marvell_get_amb_memory_map(&amb_win, &count);
+	if (count > rules.max_win) {
+		ERROR("AMB: %d windows requested, %d available\n", count, rules.max_win);
+		return 1;
+	}
+
+	/* The AMB base address is held in 64KB units */
+	for (n = 0; n < count; n++) {
+		addr_map_wins[n].base = (uint64_t)amb_win[n].base_addr << ADDR_MAP_AMB_BASE_SHIFT;
+		addr_map_wins[n].size = amb_win[n].win_size;
+		addr_map_wins[n].target_id = amb_win[n].attribute;
+	}
+
+	errors = addr_map_check(&rules, addr_map_wins, count);
+
+	for (n = 0; n < count; n++) {
+		amb_win[n].base_addr = (uint32_t)(addr_map_wins[n].base >> ADDR_MAP_AMB_BASE_SHIFT);
+		amb_win[n].win_size = (uint32_t)addr_map_wins[n].size;
+	}
+
+	return errors;
+}
+
+/*
+ * Validate the address decoding windows of the AP and all the CPs.
+ * Must be called before any of the decoding units is initialized.
+ * Unaligned windows are fixed up with a warning. Returns the count of the
+ * errors that cannot be fixed: empty or overlapping windows, invalid targets
+ * and more windows than a unit has.
+ */
+int addr_map_validate(void)
+{
+	int errors;
+
+	errors = addr_map_check_ccu();
+	errors += addr_map_check_rfu();
+	errors += addr_map_check_iob();
+	errors += addr_map_check_amb();
+
+	if (errors)
+		ERROR("%d errors found in the address decoding map\n", errors);
+
+	return errors;
+}
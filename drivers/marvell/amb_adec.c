@@ -55,33 +55,9 @@
 #define AMB_BASE_OFFSET			16
 
 #define AMB_WIN_ALIGNMENT_64K		(0x10000)
-#define AMB_WIN_ALIGNMENT_1M		(0x100000)
 
-uintptr_t amb_base;
-
-static void amb_check_win(struct amb_win *win, uint32_t win_num)
-{
-	uint32_t alignment_value = AMB_WIN_ALIGNMENT_1M;
-	uint32_t base_addr  = win->base_addr << AMB_BASE_OFFSET;
-
-	/* for AMB The base is always 1M aligned */
-	/* check if address is aligned to 1M */
-
-	if (IS_NOT_ALIGN(base_addr, alignment_value)) {
-		win->base_addr = ALIGN_UP(base_addr, alignment_value);
-		printf("Warning: Window %d: base address unaligned to 0x%x\n", win_num, alignment_value);
-		printf("Align up the base address to 0x%x\n", win->base_addr);
-	}
-
-	/* size parameter validity check */
-	if (!IS_POWER_OF_2(win->win_size)) {
-		printf("Warning: Window %d: window size is not power of 2 (0x%x)\n", win_num, win->win_size);
-		win->win_size = ROUND_UP_TO_POW_OF_2(win->win_size);
-		printf("Rounding size to 0x%x\n", win->win_size);
-	}
-}
-
-static void amb_enable_win(struct amb_win *win, uint32_t win_num)
+/* The AMB of each CP may be initialized by a different CPU (CP110_PARALLEL_INIT) */
+static void amb_enable_win(uintptr_t amb_base, struct amb_win *win, uint32_t win_num)
 {
 	uint32_t ctrl, base, size;
 
@@ -99,7 +75,7 @@ static void amb_enable_win(struct amb_win *win, uint32_t win_num)
 	mmio_write_32(AMB_WIN_CR_OFFSET(win_num), ctrl);
 }
 #ifdef DEBUG_ADDR_MAP
-static void dump_amb_adec(void)
+static void dump_amb_adec(uintptr_t amb_base)
 {
 	uint32_t ctrl, base, win_id, attr;
 	uint32_t size, size_count;
@@ -125,6 +101,7 @@ static void dump_amb_adec(void)
 int init_amb_adec(int cp_index)
 {
 	struct amb_win *win;
+	uintptr_t amb_base;
 	uint32_t win_id, win_reg;
 	uint32_t win_count;
 
@@ -146,18 +123,18 @@ int init_amb_adec(int cp_index)
 	/* disable all AMB windows */
 	for (win_id = 0; win_id < AMB_MAX_WIN_ID; win_id++) {
 		win_reg = mmio_read_32(AMB_WIN_CR_OFFSET(win_id));
-		win_reg &= ~WIN_ENABLE_BIT;
-		mmio_write_32(AMB_WIN_CR_OFFSET(win_id), win_reg);
+		if (win_reg & WIN_ENABLE_BIT) {
+			win_reg &= ~WIN_ENABLE_BIT;
+			mmio_write_32(AMB_WIN_CR_OFFSET(win_id), win_reg);
+		}
 	}
 
-	/* enable relevant windows */
-	for (win_id = 0; win_id < win_count; win_id++, win++) {
-		amb_check_win(win, win_id);
-		amb_enable_win(win, win_id);
-	}
+	/* enable relevant windows, checked by addr_map_validate() */
+	for (win_id = 0; win_id < win_count; win_id++, win++)
+		amb_enable_win(amb_base, win, win_id);
 
 #ifdef DEBUG_ADDR_MAP
-	dump_amb_adec();
+	dump_amb_adec(amb_base);
 #endif
 
 	INFO("Done AXI to MBus Bridge Address decoding Initializing\n");
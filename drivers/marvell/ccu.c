@@ -48,10 +48,8 @@
 /* Physical address of the base of the window = {AddrLow[19:0],20’h0} */
 #define ADDRESS_SHIFT			(20 - 4)
 #define ADDRESS_MASK			(0xFFFFFFF0)
-#define CCU_WIN_ALIGNMENT		(0x100000)
 
 /* AP registers */
-#define CCU_MAX_WIN_NUM			(8)
 #define CCU_WIN_CR_OFFSET(win)		(ccu_info->ccu_base + 0x0 + (0x10 * win))
 #define CCU_TARGET_ID_OFFSET		(8)
 #define CCU_TARGET_ID_MASK		(0x7F)
@@ -134,31 +132,6 @@ static void dump_ccu(void)
 }
 #endif
 
-static void ccu_win_check(struct ccu_win *win, uint32_t win_num)
-{
-	uint64_t start_addr, win_size;
-
-	/* check if address is aligned to 1M */
-	start_addr = ((uint64_t)win->base_addr_high << 32) + win->base_addr_low;
-	if (IS_NOT_ALIGN(start_addr, CCU_WIN_ALIGNMENT)) {
-		start_addr = ALIGN_UP(start_addr, CCU_WIN_ALIGNMENT);
-		ERROR("Window %d: base address unaligned to 0x%x\n", win_num, CCU_WIN_ALIGNMENT);
-		printf("Align up the base address to 0x%lx\n", start_addr);
-		win->base_addr_high = (uint32_t)(start_addr >> 32);
-		win->base_addr_low = (uint32_t)(start_addr);
-	}
-
-	/* size parameter validity check */
-	win_size = ((uint64_t)win->win_size_high << 32) + win->win_size_low;
-	if (IS_NOT_ALIGN(win_size, CCU_WIN_ALIGNMENT)) {
-		win_size = ALIGN_UP(win_size, CCU_WIN_ALIGNMENT);
-		ERROR("Window %d: window size unaligned to 0x%x\n", win_num, CCU_WIN_ALIGNMENT);
-		printf("Aligning size to 0x%lx\n", win_size);
-		win->win_size_high = (uint32_t)(win_size >> 32);
-		win->win_size_low = (uint32_t)(win_size);
-	}
-}
-
 static void ccu_enable_win(struct ccu_win *win, uint32_t win_id)
 {
 	uint32_t ccu_win_reg;
@@ -199,6 +172,7 @@ int init_ccu(void)
 	struct ccu_win *win;
 	uint32_t win_id, win_reg;
 	uint32_t win_count, array_id;
+	uint32_t skip_mask = 0;
 
 	INFO("Initializing CCU Address decoding\n");
 
@@ -223,14 +197,18 @@ int init_ccu(void)
 	win_reg = (DRAM_0_TID & CCU_GCR_TARGET_MASK) << CCU_GCR_TARGET_OFFSET;
 	mmio_write_32(CCU_WIN_GCR_OFFSET, win_reg);
 
-	/* disable AP windows */
+	/* disable AP windows, and keep track of the ones that must not be overridden */
 	for (win_id = 0; win_id < ccu_info->max_win; win_id++) {
 		win_reg = mmio_read_32(CCU_WIN_CR_OFFSET(win_id));
-		if (skip_ccu_window(win_reg))
-				continue;
+		if (skip_ccu_window(win_reg)) {
+			skip_mask |= 1 << win_id;
+			continue;
+		}
 
-		win_reg &= ~WIN_ENABLE_BIT;
-		mmio_write_32(CCU_WIN_CR_OFFSET(win_id), win_reg);
+		if (win_reg & WIN_ENABLE_BIT) {
+			win_reg &= ~WIN_ENABLE_BIT;
+			mmio_write_32(CCU_WIN_CR_OFFSET(win_id), win_reg);
+		}
 
 		/* enable write secure (and clear read secure) */
 		win_reg = CCU_WIN_ENA_WRITE_SECURE;
@@ -242,11 +220,10 @@ int init_ccu(void)
 		/* win_id is the index of the current ccu window
 			array_id is the index of the current FDT window entry */
 
-		win_reg = mmio_read_32(CCU_WIN_CR_OFFSET(win_id));
-		if (skip_ccu_window(win_reg))
-				continue;
+		if (skip_mask & (1 << win_id))
+			continue;
 
-		ccu_win_check(win, win_id);
+		/* The window was checked by addr_map_validate() */
 		ccu_enable_win(win, win_id);
 
 		win++;
@@ -45,9 +45,28 @@
 #endif
 
 #define CONFIG_SYS_TCLK				250000000
+/* Platforms with fast-mode devices only may raise it in plat_def.h */
+#ifndef CONFIG_SYS_I2C_SPEED
 #define CONFIG_SYS_I2C_SPEED			100000
+#endif
 #define CONFIG_SYS_I2C_SLAVE			0x0
-#define I2C_TIMEOUT_VALUE			0x500
+/*
+ * Time allowed for a single bus event (start, stop or byte transfer) in us,
+ * including clock stretching by the slave
+ */
+#define I2C_TIMEOUT_US				1000
+/*
+ * Minimum time between a register write and the write clearing the interrupt
+ * flag that follows it, to prevent I2C register write after write issues. It
+ * is not needed once the controller has raised the interrupt flag since the
+ * last write, i.e. it has processed it. 1 ms is the delay the driver has
+ * always used. A platform may lower it in plat_def.h after validating it.
+ */
+#ifndef I2C_WRITE_DELAY_US
+#define I2C_WRITE_DELAY_US			1000
+#endif
+/* Back-off before a transaction is retried after a lost arbitration */
+#define I2C_RETRY_DELAY_US			1000
 #define I2C_MAX_RETRY_CNT			1000
 #define I2C_CMD_WRITE				0x0
 #define I2C_CMD_READ				0x1
@@ -92,6 +111,15 @@ struct  marvell_i2c_regs {
 
 static struct marvell_i2c_regs *base;
 
+/* Set by a register write, cleared when the interrupt flag is next seen */
+static int write_pending;
+
+static void marvell_i2c_reg_write(uint32_t *reg, uint32_t val)
+{
+	mmio_write_32((uintptr_t)reg, val);
+	write_pending = 1;
+}
+
 static int marvell_i2c_lost_arbitration(uint32_t *status)
 {
 	*status = mmio_read_32((uintptr_t)&base->u.status);
@@ -105,13 +133,17 @@ static void marvell_i2c_interrupt_clear(void)
 {
 	uint32_t reg;
 
-	/* Wait for 1 ms to prevent I2C register write after write issues */
-	udelay(1000);
+	/* Space the clear from a register write not yet processed */
+	if (write_pending)
+		udelay(I2C_WRITE_DELAY_US);
 	reg = mmio_read_32((uintptr_t)&base->control);
 	reg &= ~(I2C_CONTROL_IFLG);
-	mmio_write_32((uintptr_t)&base->control, reg);
-	/* Wait for 1 ms for the clear to take effect */
-	udelay(1000);
+	marvell_i2c_reg_write(&base->control, reg);
+	/*
+	 * Wait for 1 us for the clear to take effect, the flag is then polled
+	 * by marvell_i2c_wait_interrupt() rather than waiting for a fixed time
+	 */
+	udelay(1);
 
 	return;
 }
@@ -129,10 +161,13 @@ static int marvell_i2c_interrupt_get(void)
 static int marvell_i2c_wait_interrupt(void)
 {
 	uint32_t timeout = 0;
-	while (!marvell_i2c_interrupt_get() && (timeout++ < I2C_TIMEOUT_VALUE))
-		;
-	if (timeout >= I2C_TIMEOUT_VALUE)
-		return -ETIMEDOUT;
+
+	while (!marvell_i2c_interrupt_get()) {
+		if (timeout++ >= I2C_TIMEOUT_US)
+			return -ETIMEDOUT;
+		udelay(1);
+	}
+	write_pending = 0;
 
 	return 0;
 }
@@ -146,11 +181,11 @@ static int marvell_i2c_start_bit_set(void)
 		is_int_flag = 1;
 
 	/* set start bit */
-	mmio_write_32((uintptr_t)&base->control, mmio_read_32((uintptr_t)&base->control) | I2C_CONTROL_START);
+	marvell_i2c_reg_write(&base->control, mmio_read_32((uintptr_t)&base->control) | I2C_CONTROL_START);
 
 	/* in case that the int flag was set before i.e. repeated start bit */
 	if (is_int_flag) {
-		INFO("%s: repeated start Bit\n", __func__);
+		VERBOSE("%s: repeated start Bit\n", __func__);
 		marvell_i2c_interrupt_clear();
 	}
 
@@ -184,17 +219,20 @@ static int marvell_i2c_stop_bit_set(void)
 	uint32_t status;
 
 	/* Generate stop bit */
-	mmio_write_32((uintptr_t)&base->control, mmio_read_32((uintptr_t)&base->control) | I2C_CONTROL_STOP);
+	marvell_i2c_reg_write(&base->control, mmio_read_32((uintptr_t)&base->control) | I2C_CONTROL_STOP);
 	marvell_i2c_interrupt_clear();
 
 	timeout = 0;
 	/* Read control register, check the control stop bit */
-	while ((mmio_read_32((uintptr_t)&base->control) & I2C_CONTROL_STOP) && (timeout++ < I2C_TIMEOUT_VALUE))
-		;
-	if (timeout >= I2C_TIMEOUT_VALUE) {
-		ERROR("Stop bit didn't went down\n");
-		return -ETIMEDOUT;
+	while (mmio_read_32((uintptr_t)&base->control) & I2C_CONTROL_STOP) {
+		if (timeout++ >= I2C_TIMEOUT_US) {
+			ERROR("Stop bit didn't went down\n");
+			return -ETIMEDOUT;
+		}
+		udelay(1);
 	}
+	/* the controller has processed the stop */
+	write_pending = 0;
 
 	/* check that stop bit went down */
 	if ((mmio_read_32((uintptr_t)&base->control) & I2C_CONTROL_STOP) != 0) {
@@ -221,8 +259,7 @@ static int marvell_i2c_address_set(uint8_t chain, int command)
 
 	reg = (chain << I2C_DATA_ADDR_7BIT_OFFS) & I2C_DATA_ADDR_7BIT_MASK;
 	reg |= command;
-	mmio_write_32((uintptr_t)&base->data, reg);
-	udelay(1000);
+	marvell_i2c_reg_write(&base->data, reg);
 
 	marvell_i2c_interrupt_clear();
 
@@ -316,7 +353,7 @@ static int marvell_i2c_data_receive(uint8_t *p_block, uint32_t block_size)
 		if (block_size_read == 1) {
 			reg = mmio_read_32((uintptr_t)&base->control);
 			reg &= ~(I2C_CONTROL_ACK);
-			mmio_write_32((uintptr_t)&base->control, reg);
+			marvell_i2c_reg_write(&base->control, reg);
 		}
 		marvell_i2c_interrupt_clear();
 
@@ -340,7 +377,7 @@ static int marvell_i2c_data_receive(uint8_t *p_block, uint32_t block_size)
 
 		/* read the data */
 		*p_block = (uint8_t) mmio_read_32((uintptr_t)&base->data);
-		INFO("%s: place %d read %x\n", __func__, block_size - block_size_read, *p_block);
+		VERBOSE("%s: place %d read %x\n", __func__, block_size - block_size_read, *p_block);
 		p_block++;
 		block_size_read--;
 	}
@@ -359,8 +396,8 @@ static int marvell_i2c_data_transmit(uint8_t *p_block, uint32_t block_size)
 
 	while (block_size_write) {
 		/* write the data */
-		mmio_write_32((uintptr_t)&base->data, (uint32_t) *p_block);
-		INFO("%s: index = %d, data = %x\n", __func__, block_size - block_size_write, *p_block);
+		marvell_i2c_reg_write(&base->data, (uint32_t) *p_block);
+		VERBOSE("%s: index = %d, data = %x\n", __func__, block_size - block_size_write, *p_block);
 		p_block++;
 		block_size_write--;
 
@@ -398,7 +435,7 @@ static int marvell_i2c_target_offset_set(uint8_t chip, uint32_t addr, int alen)
 		off_block[0] = addr & 0xff;
 		off_size = 1;
 	}
-	INFO("%s: off_size = %x addr1 = %x addr2 = %x\n", __func__, off_size, off_block[0], off_block[1]);
+	VERBOSE("%s: off_size = %x addr1 = %x addr2 = %x\n", __func__, off_size, off_block[0], off_block[1]);
 	return marvell_i2c_data_transmit(off_block, off_size);
 }
 
@@ -456,15 +493,9 @@ int i2c_read(uint8_t chip, uint32_t addr, int alen, uint8_t *buffer, int len)
 #endif
 
 	do	{
-		if (ret != -EAGAIN && ret) {
-			ERROR("i2c transaction failed, after %d retries\n", counter);
-			marvell_i2c_stop_bit_set();
-			return ret;
-		}
-
-		/* wait for 1 ms for the interrupt clear to take effect */
+		/* back off before retrying a transaction lost on arbitration */
 		if (counter > 0)
-			udelay(1000);
+			udelay(I2C_RETRY_DELAY_US);
 		counter++;
 
 		ret = marvell_i2c_start_bit_set();
@@ -496,12 +527,16 @@ int i2c_read(uint8_t chip, uint32_t addr, int alen, uint8_t *buffer, int len)
 		ret =  marvell_i2c_stop_bit_set();
 	} while ((ret == -EAGAIN) && (counter < I2C_MAX_RETRY_CNT));
 
-	if (counter == I2C_MAX_RETRY_CNT)
+	if (ret == -EAGAIN)
 		ERROR("I2C transactions failed, got EAGAIN %d times\n", I2C_MAX_RETRY_CNT);
-	mmio_write_32((uintptr_t)&base->control, mmio_read_32((uintptr_t)&base->control) | I2C_CONTROL_ACK);
+	else if (ret)
+		/* Not an error, e.g. the probe of an empty DIMM slot */
+		INFO("i2c read from 0x%x failed (%d)\n", chip, ret);
+	if (ret)
+		marvell_i2c_stop_bit_set();
+	marvell_i2c_reg_write(&base->control, mmio_read_32((uintptr_t)&base->control) | I2C_CONTROL_ACK);
 
-	udelay(1000);
-	return 0;
+	return ret;
 }
 
 /*
@@ -523,14 +558,9 @@ int i2c_write(uint8_t chip, uint32_t addr, int alen, uint8_t *buffer, int len)
 	uint32_t counter = 0;
 
 	do	{
-		if (ret != -EAGAIN && ret) {
-			ERROR("i2c transaction failed\n");
-			marvell_i2c_stop_bit_set();
-			return ret;
-		}
-		/* wait for 1 ms for the interrupt clear to take effect */
+		/* back off before retrying a transaction lost on arbitration */
 		if (counter > 0)
-			udelay(1000);
+			udelay(I2C_RETRY_DELAY_US);
 		counter++;
 
 		ret = marvell_i2c_start_bit_set();
@@ -555,9 +585,13 @@ int i2c_write(uint8_t chip, uint32_t addr, int alen, uint8_t *buffer, int len)
 		ret = marvell_i2c_stop_bit_set();
 	} while ((ret == -EAGAIN) && (counter < I2C_MAX_RETRY_CNT));
 
-	if (counter == I2C_MAX_RETRY_CNT)
+	if (ret == -EAGAIN)
 		ERROR("I2C transactions failed, got EAGAIN %d times\n", I2C_MAX_RETRY_CNT);
+	else if (ret)
+		ERROR("i2c write to 0x%x failed (%d)\n", chip, ret);
+	if (ret)
+		marvell_i2c_stop_bit_set();
 
 	udelay(1000);
-	return 0;
+	return ret;
 }
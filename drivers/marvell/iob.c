@@ -48,11 +48,8 @@
 /* Physical address of the base of the window = {AddrLow[19:0],20`h0} */
 #define ADDRESS_SHIFT			(20 - 4)
 #define ADDRESS_MASK			(0xFFFFFFF0)
-#define IOB_WIN_ALIGNMENT		(0x100000)
 
 /* IOB registers */
-#define IOB_MAX_WIN_NUM			(24)
-
 #define IOB_WIN_CR_OFFSET(win)		(iob_info->iob_base + 0x0 + (0x20 * win))
 #define IOB_TARGET_ID_OFFSET		(8)
 #define IOB_TARGET_ID_MASK		(0xF)
@@ -71,35 +68,9 @@ struct iob_configuration {
 	uint32_t max_win;
 };
 
-struct iob_configuration iob_config;
-struct iob_configuration *iob_info = &iob_config;
-
-static void iob_win_check(struct iob_win *win, uint32_t win_num)
-{
-	uint64_t base_addr, win_size;
-
-	/* check if address is aligned to the size */
-	base_addr = ((uint64_t)win->base_addr_high << 32) + win->base_addr_low;
-	if (IS_NOT_ALIGN(base_addr, IOB_WIN_ALIGNMENT)) {
-		base_addr = ALIGN_UP(base_addr, IOB_WIN_ALIGNMENT);
-		ERROR("Window %d: base address unaligned to 0x%x\n", win_num, IOB_WIN_ALIGNMENT);
-		printf("Align up the base address to 0x%lx\n", base_addr);
-		win->base_addr_high = (uint32_t)(base_addr >> 32);
-		win->base_addr_low = (uint32_t)(base_addr);
-	}
-
-	/* size parameter validity check */
-	win_size = ((uint64_t)win->win_size_high << 32) + win->win_size_low;
-	if (IS_NOT_ALIGN(win_size, IOB_WIN_ALIGNMENT)) {
-		win_size = ALIGN_UP(win_size, IOB_WIN_ALIGNMENT);
-		ERROR("Window %d: window size unaligned to 0x%x\n", win_num, IOB_WIN_ALIGNMENT);
-		printf("Aligning size to 0x%lx\n", win_size);
-		win->win_size_high = (uint32_t)(win_size >> 32);
-		win->win_size_low = (uint32_t)(win_size);
-	}
-}
-
-static void iob_enable_win(struct iob_win *win, uint32_t win_id)
+/* The IOB of each CP may be initialized by a different CPU (CP110_PARALLEL_INIT) */
+static void iob_enable_win(const struct iob_configuration *iob_info,
+			   struct iob_win *win, uint32_t win_id)
 {
 	uint32_t iob_win_reg;
 	uint32_t alr, ahr;
@@ -119,7 +90,7 @@ static void iob_enable_win(struct iob_win *win, uint32_t win_id)
 }
 
 #ifdef DEBUG_ADDR_MAP
-static void dump_iob(void)
+static void dump_iob(const struct iob_configuration *iob_info)
 {
 	uint32_t win_id, win_cr, alr, ahr;
 	uint8_t target_id;
@@ -155,6 +126,7 @@ static void dump_iob(void)
 
 int init_iob(int cp_index)
 {
+	struct iob_configuration iob_config, *iob_info = &iob_config;
 	struct iob_win *win;
 	uint32_t win_id, win_reg;
 	uint32_t win_count;
@@ -181,8 +153,10 @@ int init_iob(int cp_index)
 	/* disable all IOB windows, start from win_id = 1 because can't disable internal register window */
 	for (win_id = 1; win_id < iob_info->max_win; win_id++) {
 		win_reg = mmio_read_32(IOB_WIN_CR_OFFSET(win_id));
-		win_reg &= ~WIN_ENABLE_BIT;
-		mmio_write_32(IOB_WIN_CR_OFFSET(win_id), win_reg);
+		if (win_reg & WIN_ENABLE_BIT) {
+			win_reg &= ~WIN_ENABLE_BIT;
+			mmio_write_32(IOB_WIN_CR_OFFSET(win_id), win_reg);
+		}
 
 		win_reg = ~IOB_WIN_ENA_CTRL_WRITE_SECURE;
 		win_reg &= ~IOB_WIN_ENA_CTRL_READ_SECURE;
@@ -191,13 +165,12 @@ int init_iob(int cp_index)
 		mmio_write_32(IOB_WIN_SCR_OFFSET(win_id), win_reg);
 	}
 
-	for (win_id = 1; win_id < win_count + 1; win_id++, win++) {
-		iob_win_check(win, win_id);
-		iob_enable_win(win, win_id);
-	}
+	/* The windows were checked by addr_map_validate() */
+	for (win_id = 1; win_id < win_count + 1; win_id++, win++)
+		iob_enable_win(iob_info, win, win_id);
 
 #ifdef DEBUG_ADDR_MAP
-	dump_iob();
+	dump_iob(iob_info);
 #endif
 
 	INFO("Done IOB Address decoding Initializing\n");
@@ -31,19 +31,60 @@
  *
  ***************************************************************************
  */
+#include <arch_helpers.h>
 #include <plat_def.h>
 #include <plat_marvell.h>
 #include <debug.h>
 #include <mmio.h>
 #include <mci.h>
 #include <apn806_setup.h>
-#include <delay_timer.h>
+#include <utils.h>
+#include <string.h>
 
 enum {
 	MCI_CMD_WRITE,
 	MCI_CMD_READ
 };
 
+/* Maximum time for an indirect access command to complete */
+#define MCI_CMD_TIMEOUT_US		100000
+
+#define MCI_US_TO_TICKS(us)		((us) * (uint64_t)COUNTER_FREQUENCY / 1000000)
+#define MCI_TICKS_TO_US(ticks)		((ticks) * 1000000 / COUNTER_FREQUENCY)
+
+/* Indirect write operation, as applied by mci_write_ops() */
+enum mci_op_type {
+	MCI_OP_WRITE,		/* Write and poll for the command completion */
+	MCI_OP_WRITE_NO_POLL	/* Write without waiting for the command */
+};
+
+struct mci_reg_op {
+	uint32_t cmd;		/* Indirect access command (register & target) */
+	enum mci_op_type type;
+	uint32_t data;
+};
+
+#define MCI_WRITE_OP(_cmd, _data)					\
+	{ .cmd = (_cmd), .type = MCI_OP_WRITE, .data = (_data) }
+#define MCI_WRITE_NO_POLL_OP(_cmd, _data)				\
+	{ .cmd = (_cmd), .type = MCI_OP_WRITE_NO_POLL, .data = (_data) }
+
+#define MCI_LOCAL_CMD(reg_num)						\
+	(MCI_INDIRECT_REG_CTRL_ADDR(reg_num) | MCI_INDIRECT_CTRL_LOCAL_PKT)
+#define MCI_REMOTE_CMD(reg_num)						\
+	(MCI_INDIRECT_REG_CTRL_ADDR(reg_num) | MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT))
+
+/* Command completion latency histogram: bucket n counts the commands that
+ * completed in less than 2^n us, the last one the slower commands.
+ */
+#define MCI_LAT_BUCKETS			12
+
+static struct {
+	uint32_t hist[MCI_LAT_BUCKETS];
+	uint32_t timeouts;
+	uint64_t max_us;
+} mci_cmd_stats;
+
 /* Write wrapper callback for debug:
  * will print written data in case LOG_LEVEL >= 40
  */
@@ -63,57 +104,110 @@ static uint32_t mci_mmio_read_32(uintptr_t addr)
 	return value;
 }
 
+static void mci_cmd_stats_add(uint64_t ticks)
+{
+	uint64_t us = MCI_TICKS_TO_US(ticks);
+	unsigned int bucket = 0;
+
+	while ((bucket < MCI_LAT_BUCKETS - 1) && (us >= (1ULL << bucket)))
+		bucket++;
+
+	mci_cmd_stats.hist[bucket]++;
+	if (us > mci_cmd_stats.max_us)
+		mci_cmd_stats.max_us = us;
+}
+
+static void mci_cmd_stats_print(int mci_index)
+{
+	unsigned int n;
+
+	INFO("MCI%d command latency: max %llu us, %u timeouts\n", mci_index,
+	     (unsigned long long)mci_cmd_stats.max_us, mci_cmd_stats.timeouts);
+	for (n = 0; n < MCI_LAT_BUCKETS; n++) {
+		if (!mci_cmd_stats.hist[n])
+			continue;
+		if (n < MCI_LAT_BUCKETS - 1)
+			INFO("    < %u us: %u\n", 1 << n, mci_cmd_stats.hist[n]);
+		else
+			INFO("   >= %u us: %u\n", 1 << (n - 1), mci_cmd_stats.hist[n]);
+	}
+}
+
 /* MCI indirect access command completion polling:
  * Each write/read command done via MCI indirect registers must be polled
  * for command completions status.
+ * The command usually completes within a few microseconds, so the status is
+ * busy-polled against a deadline on the generic counter.
  *
  * Returns 1 in case of error
  * Returns 0 in case of command completed successfully.
  */
 static int mci_poll_command_completion(int mci_index, int command_type)
 {
-	uint32_t mci_cmd_value = 0, retry_count = 100;
+	uint32_t mci_cmd_value;
 	uint32_t completion_flags = MCI_INDIRECT_CTRL_CMD_DONE;
+	uint64_t start, now;
 
 	/* Read commands require validating that requested data is ready */
 	if (command_type == MCI_CMD_READ)
 		completion_flags |= MCI_INDIRECT_CTRL_DATA_READY;
 
+	start = read_cntpct_el0();
 	do {
-		/* wait 1 ms before each polling */
-		mdelay(1);
-		mci_cmd_value = mci_mmio_read_32(MCI_ACCESS_CMD_REG(mci_index));
-	} while (((mci_cmd_value & completion_flags) != completion_flags) &&
-			 (retry_count-- > 0));
-
-	if (retry_count == 0) {
-		ERROR("%s: MCI command timeout (command status = 0x%x)\n", __func__, mci_cmd_value);
-		return 1;
-	}
+		/* Not traced: the status may be read many times per command */
+		mci_cmd_value = mmio_read_32(MCI_ACCESS_CMD_REG(mci_index));
+		now = read_cntpct_el0();
+		if ((mci_cmd_value & completion_flags) == completion_flags) {
+			mci_cmd_stats_add(now - start);
+			return 0;
+		}
+	} while (now - start < MCI_US_TO_TICKS(MCI_CMD_TIMEOUT_US));
 
-	return 0;
+	mci_cmd_stats.timeouts++;
+	ERROR("%s: MCI command timeout (command status = 0x%x)\n", __func__, mci_cmd_value);
+	return 1;
 }
 
-/* Routine to enable register-mode access to PHYs over MCI0 indirect read/write*/
-static void mci_enable_phy_regs_access(int mci_index)
+/* Apply a table of indirect register writes.
+ * All the operations are applied even if some of them fail, so the callers
+ * can complete the configuration on a best effort basis.
+ *
+ * Returns 1 if any of the polled commands failed
+ * Returns 0 in case all the commands completed successfully.
+ */
+static int mci_write_ops(int mci_index, const struct mci_reg_op *ops, unsigned int num)
 {
-	uint32_t reg_data = MCI_PHY_CTRL_MCI_PHY_REG_IF_MODE |
-			    MCI_PHY_CTRL_MCI_MAJOR | MCI_PHY_CTRL_MCI_MINOR;
+	unsigned int n;
+	int ret = 0;
+
+	for (n = 0; n < num; n++) {
+		mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), ops[n].data);
+		mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index), ops[n].cmd);
+		if (ops[n].type == MCI_OP_WRITE)
+			ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
+	}
 
-	/* Enable PHY REG access on remote (CP, device mode, GID=2) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT));
-	mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
+	return ret;
+}
+
+#define MCI_PHY_CTRL_REG_IF_VAL						\
+	(MCI_PHY_CTRL_MCI_PHY_REG_IF_MODE | MCI_PHY_CTRL_MCI_MAJOR |	\
+	 MCI_PHY_CTRL_MCI_MINOR)
 
+static const struct mci_reg_op mci_phy_regs_access_ops[] = {
+	/* Enable PHY REG access on remote (CP, device mode, GID=2) */
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_PHY_CTRL_REG_NUM),
+		     MCI_PHY_CTRL_REG_IF_VAL),
 	/* Enable PHY REG access localy (AP, host mode, GID=0) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  reg_data | MCI_PHY_CTRL_MCI_PHY_MODE_HOST);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_PHY_CTRL_REG_NUM),
+		     MCI_PHY_CTRL_REG_IF_VAL | MCI_PHY_CTRL_MCI_PHY_MODE_HOST),
+};
+
+/* Routine to enable register-mode access to PHYs over MCI0 indirect read/write*/
+static void mci_enable_phy_regs_access(int mci_index)
+{
+	mci_write_ops(mci_index, mci_phy_regs_access_ops,
+		      ARRAY_SIZE(mci_phy_regs_access_ops));
 }
 
 /* read mci0 PHY/CTRL registers via indirect (local) access */
@@ -133,69 +227,43 @@ static uint32_t mci_indirect_read(int reg_num, enum mci_register_type reg_type,
 	return mci_mmio_read_32(MCI_WRITE_READ_DATA_REG(mci_index));
 }
 
-/* Force MCI link speed to 8Gbps */
-static void mci_link_force_speed_8g(int mci_index)
-{
-	uint32_t reg_data;
+#define MCI_PWM2_SPEED_8G_VAL						\
+	(PWM2_SPEED_V3_8G | PWM2_SPEED_FORCE | PWM2_RX_LINE_EN | PWM2_TX_LINE_EN)
 
+/* The link is retrained by this sequence, so its commands are not polled */
+static const struct mci_reg_op mci_link_speed_8g_ops[] = {
 	/* Force link speed localy on AP PHY */
-	reg_data = PWM2_SPEED_V3_8G | PWM2_SPEED_FORCE |
-		   PWM2_RX_LINE_EN | PWM2_TX_LINE_EN;
-
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_PWM2_REG_NUM) |
-			  MCI_INDIRECT_CTRL_PHY_ACCESS_EN |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-
+	MCI_WRITE_NO_POLL_OP(MCI_LOCAL_CMD(MCI_PHY_PWM2_REG_NUM) |
+			     MCI_INDIRECT_CTRL_PHY_ACCESS_EN,
+			     MCI_PWM2_SPEED_8G_VAL),
 	/* Force link speed remotely on CP PHY */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_PWM2_REG_NUM) |
-			  MCI_INDIRECT_CTRL_PHY_ACCESS_EN |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT));
-
+	MCI_WRITE_NO_POLL_OP(MCI_REMOTE_CMD(MCI_PHY_PWM2_REG_NUM) |
+			     MCI_INDIRECT_CTRL_PHY_ACCESS_EN,
+			     MCI_PWM2_SPEED_8G_VAL),
 	/* Enable SW power state requests control mode */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_PHY_P0_IDLE_MIN_IDLE_COUNT |
-			  MCI_PHY_P0_IDLE_SW_PWR_REQ_EN |
-			  MCI_PHY_P0_IDLE_SW_RETRAIN_MODE);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_P0_IDLE_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-
+	MCI_WRITE_NO_POLL_OP(MCI_LOCAL_CMD(MCI_PHY_P0_IDLE_CTRL_REG_NUM),
+			     MCI_PHY_P0_IDLE_MIN_IDLE_COUNT |
+			     MCI_PHY_P0_IDLE_SW_PWR_REQ_EN |
+			     MCI_PHY_P0_IDLE_SW_RETRAIN_MODE),
 	/* Toggle power state request */
-	reg_data = MCI_PHY_CTRL_MCI_PHY_REG_IF_MODE |
-		   MCI_PHY_CTRL_MCI_PHY_MODE_HOST |
-		   MCI_PHY_CTRL_MCI_SLEEP_REQ |
-		   MCI_PHY_CTRL_MCI_MAJOR |
-		   MCI_PHY_CTRL_MCI_MINOR;
-
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-
-	reg_data &= ~MCI_PHY_CTRL_MCI_SLEEP_REQ;
-
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-
+	MCI_WRITE_NO_POLL_OP(MCI_LOCAL_CMD(MCI_PHY_CTRL_REG_NUM),
+			     MCI_PHY_CTRL_REG_IF_VAL | MCI_PHY_CTRL_MCI_PHY_MODE_HOST |
+			     MCI_PHY_CTRL_MCI_SLEEP_REQ),
+	MCI_WRITE_NO_POLL_OP(MCI_LOCAL_CMD(MCI_PHY_CTRL_REG_NUM),
+			     MCI_PHY_CTRL_REG_IF_VAL | MCI_PHY_CTRL_MCI_PHY_MODE_HOST),
 	/* Return power state requests control mode back to HW */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_PHY_P0_IDLE_MIN_IDLE_COUNT |
-			  MCI_PHY_P0_IDLE_SW_RETRAIN_MODE);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_P0_IDLE_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-
+	MCI_WRITE_NO_POLL_OP(MCI_LOCAL_CMD(MCI_PHY_P0_IDLE_CTRL_REG_NUM),
+			     MCI_PHY_P0_IDLE_MIN_IDLE_COUNT |
+			     MCI_PHY_P0_IDLE_SW_RETRAIN_MODE),
 	/* Reset all fields in link CRC control register */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), 0);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_LINK_CRC_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
+	MCI_WRITE_NO_POLL_OP(MCI_LOCAL_CMD(MCI_LINK_CRC_CTRL_REG_NUM), 0),
+};
+
+/* Force MCI link speed to 8Gbps */
+static void mci_link_force_speed_8g(int mci_index)
+{
+	mci_write_ops(mci_index, mci_link_speed_8g_ops,
+		      ARRAY_SIZE(mci_link_speed_8g_ops));
 }
 
 /* Perform 3 configurations in one command: PCI mode, queues separation and cache bit */
@@ -272,213 +340,130 @@ static int mci_axi_set_fifo_thresh(int mci_index)
 	return 1;
 }
 
-/* Reduce sequence FIFO timer expiration threshold for A1, including PIDI workaround */
-static int mci_axi_set_fifo_thresh_a1(int mci_index)
-{
-	uint32_t reg_data, ret = 0;
-
-	/* This configuration reduces sequence FIFO timer expiration threshold (to 0x7 instead of 0xA).
-	 * In MCI 1.6 version this configuration prevents possible functional issues.
-	 * In version 1.82 the configuration prevents performance degradation
-	 */
+#define MCI_PHY_CTRL_A1_VAL	(MCI_PHY_CTRL_MCI_MAJOR | MCI_PHY_CTRL_MCI_MINOR_A1)
+#define MCI_PHY_CTRL_A1_HOST_VAL						\
+	(MCI_PHY_CTRL_A1_VAL | MCI_PHY_CTRL_MCI_PHY_REG_IF_MODE |	\
+	 MCI_PHY_CTRL_MCI_PHY_MODE_HOST)
 
+/* This configuration reduces sequence FIFO timer expiration threshold (to 0x7 instead of 0xA).
+ * In MCI 1.6 version this configuration prevents possible functional issues.
+ * In version 1.82 the configuration prevents performance degradation
+ */
+static const struct mci_reg_op mci_fifo_thresh_a1_ops[] = {
 	/* Configure local AP side */
 	/* PIDI Workaround for entering PIDI mode */
-	reg_data = MCI_PHY_CTRL_PIDI_MODE | MCI_PHY_CTRL_MCI_PHY_REG_IF_MODE
-		| MCI_PHY_CTRL_MCI_PHY_MODE_HOST
-		| MCI_PHY_CTRL_MCI_MAJOR | MCI_PHY_CTRL_MCI_MINOR_A1;
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) | MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_PHY_CTRL_REG_NUM),
+		     MCI_PHY_CTRL_A1_HOST_VAL | MCI_PHY_CTRL_PIDI_MODE),
 	/* Reduce the threshold */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_IHB_MODE_CFG_REG_DEF_VAL_A1);
-
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_IHB_MODE_CFG_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_CTRL_IHB_MODE_CFG_REG_NUM),
+		     MCI_CTRL_IHB_MODE_CFG_REG_DEF_VAL_A1),
 	/* Exit PIDI mode */
-	reg_data = MCI_PHY_CTRL_MCI_PHY_REG_IF_MODE | MCI_PHY_CTRL_MCI_PHY_MODE_HOST
-		| MCI_PHY_CTRL_MCI_MAJOR | MCI_PHY_CTRL_MCI_MINOR_A1;
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) | MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_PHY_CTRL_REG_NUM),
+		     MCI_PHY_CTRL_A1_HOST_VAL),
 
 	/* Configure remote CP side */
 	/* PIDI Workaround for entering PIDI mode */
-	reg_data = MCI_PHY_CTRL_PIDI_MODE | MCI_PHY_CTRL_MCI_MAJOR | MCI_PHY_CTRL_MCI_MINOR_A1;
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) | MCI_CTRL_IHB_MODE_FWD_MOD);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) | MCI_CTRL_IHB_MODE_FWD_MOD,
+		     MCI_PHY_CTRL_A1_VAL | MCI_PHY_CTRL_PIDI_MODE),
 	/* Reduce the threshold */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_IHB_MODE_CFG_REG_DEF_VAL_A1);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_IHB_MODE_CFG_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT));
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_CTRL_IHB_MODE_CFG_REG_NUM),
+		     MCI_CTRL_IHB_MODE_CFG_REG_DEF_VAL_A1),
 	/* Exit PIDI mode */
-	reg_data = MCI_PHY_CTRL_MCI_MAJOR | MCI_PHY_CTRL_MCI_MINOR_A1;
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index), reg_data);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) | MCI_CTRL_IHB_MODE_FWD_MOD);
-
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
-	return ret;
-}
+	MCI_WRITE_OP(MCI_INDIRECT_REG_CTRL_ADDR(MCI_PHY_CTRL_REG_NUM) | MCI_CTRL_IHB_MODE_FWD_MOD,
+		     MCI_PHY_CTRL_A1_VAL),
+};
 
-/* Configure:
- * 1. AP & CP TX thresholds and delta configurations
- * 2. DLO & DLI FIFO full threshold
- * 3. RX thresholds and delta configurations
- * 4. CP AR and AW outstanding
- * 5. AP AR and AW outstanding
- */
-static int mci_axi_set_fifo_rx_tx_thresh_a1(int mci_index)
+/* Reduce sequence FIFO timer expiration threshold for A1, including PIDI workaround */
+static int mci_axi_set_fifo_thresh_a1(int mci_index)
 {
-	uint32_t ret = 0;
+	return mci_write_ops(mci_index, mci_fifo_thresh_a1_ops,
+			     ARRAY_SIZE(mci_fifo_thresh_a1_ops));
+}
 
+static const struct mci_reg_op mci_fifo_rx_tx_thresh_a1_ops[] = {
 	/* AP TX thresholds and delta configurations (IHB_reg 0x1) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_TX_MEM_CFG_REG_DEF_VAL);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_TX_MEM_CFG_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_CTRL_TX_MEM_CFG_REG_NUM),
+		     MCI_CTRL_TX_MEM_CFG_REG_DEF_VAL),
 	/* CP TX thresholds and delta configurations (IHB_reg 0x1) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_TX_MEM_CFG_REG_DEF_VAL);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_TX_MEM_CFG_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT));
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_CTRL_TX_MEM_CFG_REG_NUM),
+		     MCI_CTRL_TX_MEM_CFG_REG_DEF_VAL),
 	/* AP DLO & DLI FIFO full threshold & Auto-Link enable (IHB_reg 0x8) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_MCI_PHY_SET_REG_DEF_VAL | MCI_CTRL_MCI_PHY_SET_AUTO_LINK_EN(1));
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_MCI_PHY_SETTINGS_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_CTRL_MCI_PHY_SETTINGS_REG_NUM),
+		     MCI_CTRL_MCI_PHY_SET_REG_DEF_VAL | MCI_CTRL_MCI_PHY_SET_AUTO_LINK_EN(1)),
 	/* CP DLO & DLI FIFO full threshold (IHB_reg 0x8) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_MCI_PHY_SET_REG_DEF_VAL);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_MCI_PHY_SETTINGS_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT));
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_CTRL_MCI_PHY_SETTINGS_REG_NUM),
+		     MCI_CTRL_MCI_PHY_SET_REG_DEF_VAL),
 	/* AP RX thresholds and delta configurations (IHB_reg 0x0) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_RX_MEM_CFG_REG_DEF_VAL);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_RX_MEM_CFG_REG_NUM) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_CTRL_RX_MEM_CFG_REG_NUM),
+		     MCI_CTRL_RX_MEM_CFG_REG_DEF_VAL),
 	/* CP RX thresholds and delta configurations (IHB_reg 0x0) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_CTRL_RX_MEM_CFG_REG_DEF_VAL);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_CTRL_RX_MEM_CFG_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT));
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_CTRL_RX_MEM_CFG_REG_NUM),
+		     MCI_CTRL_RX_MEM_CFG_REG_DEF_VAL),
 	/* AP AR & AW maximum AXI outstanding request configuration (HB_reg 0xd) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_HB_CTRL_TX_CTRL_PRI_TH_QOS(8) |
-			  MCI_HB_CTRL_TX_CTRL_MAX_RD_CNT(7) |
-			  MCI_HB_CTRL_TX_CTRL_MAX_WR_CNT(7));
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_HB_CTRL_TX_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_HB_CTRL_TX_CTRL_REG_NUM) |
+		     MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB),
+		     MCI_HB_CTRL_TX_CTRL_PRI_TH_QOS(8) |
+		     MCI_HB_CTRL_TX_CTRL_MAX_RD_CNT(7) |
+		     MCI_HB_CTRL_TX_CTRL_MAX_WR_CNT(7)),
 	/* CP AR & AW maximum AXI outstanding request configuration (HB_reg 0xd) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(mci_index),
-			  MCI_HB_CTRL_TX_CTRL_PRI_TH_QOS(8) |
-			  MCI_HB_CTRL_TX_CTRL_MAX_RD_CNT(15) |
-			  MCI_HB_CTRL_TX_CTRL_MAX_WR_CNT(15));
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(mci_index),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_HB_CTRL_TX_CTRL_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB));
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
-	return ret;
-}
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_HB_CTRL_TX_CTRL_REG_NUM) |
+		     MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB),
+		     MCI_HB_CTRL_TX_CTRL_PRI_TH_QOS(8) |
+		     MCI_HB_CTRL_TX_CTRL_MAX_RD_CNT(15) |
+		     MCI_HB_CTRL_TX_CTRL_MAX_WR_CNT(15)),
+};
 
-/* configure MCI to allow read & write transactions to arrive at the same time.
- * Without the below configuration, MCI won't sent response to CPU for transactions
- * which arrived simultaneously and will lead to CPU hang.
- * The below will configure MCI to be able to pass transactions from/to CP/AP.
+/* Configure:
+ * 1. AP & CP TX thresholds and delta configurations
+ * 2. DLO & DLI FIFO full threshold
+ * 3. RX thresholds and delta configurations
+ * 4. CP AR and AW outstanding
+ * 5. AP AR and AW outstanding
  */
-int mci_enable_simultaneous_transactions(int mci_index)
+static int mci_axi_set_fifo_rx_tx_thresh_a1(int mci_index)
 {
-	uint32_t ret = 0;
+	return mci_write_ops(mci_index, mci_fifo_rx_tx_thresh_a1_ops,
+			     ARRAY_SIZE(mci_fifo_rx_tx_thresh_a1_ops));
+}
 
+static const struct mci_reg_op mci_simultaneous_transactions_ops[] = {
 	/* ID assignment (assigning global ID offset to CP) */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(0),
-			  MCI_DID_GLOBAL_ASSIGN_REQ_MCI_LOCAL_ID(2) |
-			  MCI_DID_GLOBAL_ASSIGN_REQ_MCI_COUNT(2) |
-			  MCI_DID_GLOBAL_ASSIGN_REQ_HOPS_NUM(2));
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(0),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_DID_GLOBAL_ASSIGNMENT_REQUEST_REG) |
-			  MCI_INDIRECT_CTRL_ASSIGN_CMD);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_INDIRECT_REG_CTRL_ADDR(MCI_DID_GLOBAL_ASSIGNMENT_REQUEST_REG) |
+		     MCI_INDIRECT_CTRL_ASSIGN_CMD,
+		     MCI_DID_GLOBAL_ASSIGN_REQ_MCI_LOCAL_ID(2) |
+		     MCI_DID_GLOBAL_ASSIGN_REQ_MCI_COUNT(2) |
+		     MCI_DID_GLOBAL_ASSIGN_REQ_HOPS_NUM(2)),
 	/* Assigning destination ID=3 to all transactions entering from AXI at AP */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(0),
-			  MCI_HB_CTRL_WIN0_DEST_VALID_FLAG(1) |
-			  MCI_HB_CTRL_WIN0_DEST_ID(3));
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(0),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_HB_CTRL_WIN0_DESTINATION_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_HB_CTRL_WIN0_DESTINATION_REG_NUM) |
+		     MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB),
+		     MCI_HB_CTRL_WIN0_DEST_VALID_FLAG(1) |
+		     MCI_HB_CTRL_WIN0_DEST_ID(3)),
 	/* Assigning destination ID=1 to all transactions entering from AXI at CP */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(0),
-			  MCI_HB_CTRL_WIN0_DEST_VALID_FLAG(1) |
-			  MCI_HB_CTRL_WIN0_DEST_ID(1));
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(0),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_HB_CTRL_WIN0_DESTINATION_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB));
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_HB_CTRL_WIN0_DESTINATION_REG_NUM) |
+		     MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB),
+		     MCI_HB_CTRL_WIN0_DEST_VALID_FLAG(1) |
+		     MCI_HB_CTRL_WIN0_DEST_ID(1)),
 	/* End address to all transactions entering from AXI at AP. This will lead to
 	 * get match for any AXI address, and receive destination ID=3 */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(0), 0xffffffff);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(0),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_HB_CTRL_WIN0_ADDRESS_MASK_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB) |
-			  MCI_INDIRECT_CTRL_LOCAL_PKT);
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
-
+	MCI_WRITE_OP(MCI_LOCAL_CMD(MCI_HB_CTRL_WIN0_ADDRESS_MASK_REG_NUM) |
+		     MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB),
+		     0xffffffff),
 	/* End address to all transactions entering from AXI at CP. This will lead to
 	 * get match for any AXI address, and receive destination ID=1 */
-	mci_mmio_write_32(MCI_WRITE_READ_DATA_REG(0), 0xffffffff);
-	mci_mmio_write_32(MCI_ACCESS_CMD_REG(0),
-			  MCI_INDIRECT_REG_CTRL_ADDR(MCI_HB_CTRL_WIN0_ADDRESS_MASK_REG_NUM) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_IHB_EXT) |
-			  MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB));
-	ret |= mci_poll_command_completion(mci_index, MCI_CMD_WRITE);
+	MCI_WRITE_OP(MCI_REMOTE_CMD(MCI_HB_CTRL_WIN0_ADDRESS_MASK_REG_NUM) |
+		     MCI_INDIRECT_CTRL_HOPID(GID_AXI_HB),
+		     0xffffffff),
+};
 
-	return ret;
+/* configure MCI to allow read & write transactions to arrive at the same time.
+ * Without the below configuration, MCI won't sent response to CPU for transactions
+ * which arrived simultaneously and will lead to CPU hang.
+ * The below will configure MCI to be able to pass transactions from/to CP/AP.
+ */
+int mci_enable_simultaneous_transactions(int mci_index)
+{
+	return mci_write_ops(mci_index, mci_simultaneous_transactions_ops,
+			     ARRAY_SIZE(mci_simultaneous_transactions_ops));
 }
 
 /* For A1 revision, configure the MCI link for performance improvement:
@@ -591,14 +576,22 @@ reboot:
  * - A0 revision configuration include MCI link initialization */
 int mci_initialize(int mci_index)
 {
-	INFO("MCI%d initialization:\n", mci_index);
+	int rval;
 
-	if (apn806_rev_id_get() == APN806_REV_ID_A0)
-		return mci_link_init_a0(0);
+	INFO("MCI%d initialization:\n", mci_index);
+	/* Only report the commands of this link */
+	memset(&mci_cmd_stats, 0, sizeof(mci_cmd_stats));
+
+	if (apn806_rev_id_get() == APN806_REV_ID_A0) {
+		rval = mci_link_init_a0(0);
+	} else {
+		/* Else, for A1 configure MCI for improved performance */
+		mci_configure_a1(0);
+		rval = 1; /* Link is always guaranteed for A1 */
+	}
 
-	/* Else, for A1 configure MCI for improved performance */
-	mci_configure_a1(0);
-	return 1; /* Link is always guaranteed for A1 */
+	mci_cmd_stats_print(mci_index);
+	return rval;
 }
 
 /* MCIx indirect access register are based by default at 0xf4000000/0xf6000000
@@ -35,6 +35,7 @@
 #include <plat_def.h>
 #include <apn806_setup.h>
 #include <amb_adec.h>
+#include <boot_timeline.h>
 #include <iob.h>
 #include <icu.h>
 #include <mmio.h>
@@ -368,6 +369,8 @@ void amb_bridge_init(int cp_index)
 
 void cp110_init(int cp_index)
 {
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL31_CP_INIT_START(cp_index));
+
 	/* configure AXI-MBUS windows for CP0*/
 	init_amb_adec(cp_index);
 
@@ -391,6 +394,8 @@ void cp110_init(int cp_index)
 
 	/* Open AMB bridge for comphy for CP0 & CP1*/
 	amb_bridge_init(cp_index);
+
+	BOOT_TIMELINE_RECORD(BOOT_TL_BL31_CP_INIT_END(cp_index));
 }
 
 /* Do the minimal setup required to configure the CP in BLE */
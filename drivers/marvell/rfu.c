@@ -48,8 +48,6 @@
 /* Physical address of the base of the window = {Addr[19:0],20`h0} */
 #define ADDRESS_SHIFT			(20 - 4)
 #define ADDRESS_MASK			(0xFFFFFFF0)
-#define RFU_WIN_ALIGNMENT_1M		(0x100000)
-#define RFU_WIN_ALIGNMENT_64K		(0x10000)
 
 /* AP registers */
 #define RFU_WIN_ALR_OFFSET(win)		(rfu_base + 0x0 + (0x10 * win))
@@ -61,33 +59,6 @@
 uintptr_t rfu_base;
 
 
-static void rfu_win_check(struct rfu_win *win, uint32_t win_num)
-{
-	uint64_t base_addr, win_size;
-	uint32_t alignment_value = RFU_WIN_ALIGNMENT_1M;
-
-	/* for RFU The base is always 1M aligned */
-	/* check if address is aligned to 1M */
-	base_addr = ((uint64_t)win->base_addr_high << 32) + win->base_addr_low;
-	if (IS_NOT_ALIGN(base_addr, RFU_WIN_ALIGNMENT_1M)) {
-		base_addr = ALIGN_UP(base_addr, RFU_WIN_ALIGNMENT_1M);
-		ERROR("Window %d: base address unaligned to 0x%x\n", win_num, RFU_WIN_ALIGNMENT_1M);
-		printf("Align up the base address to 0x%lx\n", base_addr);
-		win->base_addr_high = (uint32_t)(base_addr >> 32);
-		win->base_addr_low = (uint32_t)(base_addr);
-	}
-
-	/* size parameter validity check */
-	win_size = ((uint64_t)win->win_size_high << 32) + win->win_size_low;
-	if (IS_NOT_ALIGN(win_size, alignment_value)) {
-		win_size = ALIGN_UP(win_size, alignment_value);
-		ERROR("Window %d: window size unaligned to 0x%x\n", win_num, alignment_value);
-		printf("Aligning size to 0x%lx\n", win_size);
-		win->win_size_high = (uint32_t)(win_size >> 32);
-		win->win_size_low = (uint32_t)(win_size);
-	}
-}
-
 static void rfu_enable_win(struct rfu_win *win, uint32_t win_num)
 {
 	uint32_t alr, ahr;
@@ -165,8 +136,8 @@ int init_rfu(void)
 	if (win_count <= 0) {
 		INFO("no windows configurations found\n");
 	}
-	if (win_count > RFU_MAX_WIN_ID) {
-		INFO("number of windows is bigger than %d\n", RFU_MAX_WIN_ID);
+	if (win_count > RFU_MAX_WIN_ID - 1) {
+		INFO("number of windows is bigger than %d\n", RFU_MAX_WIN_ID - 1);
 		return 0;
 	}
 
@@ -177,15 +148,15 @@ int init_rfu(void)
 	/* disable all RFU windows */
 	for (win_id = 0; win_id < RFU_MAX_WIN_ID; win_id++) {
 		win_reg = mmio_read_32(RFU_WIN_ALR_OFFSET(win_id));
-		win_reg &= ~WIN_ENABLE_BIT;
-		mmio_write_32(RFU_WIN_ALR_OFFSET(win_id), win_reg);
+		if (win_reg & WIN_ENABLE_BIT) {
+			win_reg &= ~WIN_ENABLE_BIT;
+			mmio_write_32(RFU_WIN_ALR_OFFSET(win_id), win_reg);
+		}
 	}
 
 	/* enable relevant windows, starting from win_id=1 because index 0 dedicated for BootRom */
-	for (win_id = 1; win_id <= win_count; win_id++, win++) {
-		rfu_win_check(win, win_id);
+	for (win_id = 1; win_id <= win_count; win_id++, win++)
 		rfu_enable_win(win, win_id);
-	}
 
 #ifdef DEBUG_ADDR_MAP
 	dump_rfu();
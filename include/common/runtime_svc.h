@@ -62,6 +62,31 @@
  */
 #define MAX_RT_SVCS		128
 
+/*
+ * Statistics of the time spent in the runtime service handlers, per CPU and
+ * per SMC function ID, collected when ENABLE_RT_SVC_STATS is set. They are
+ * read with the PMF SMCs: RT_SVC_STATS_TID() gives the timestamp ID of a
+ * field of one of the entries of a CPU. Times are in system counter ticks.
+ */
+#define PMF_RT_SVC_STATS_SVC_ID		2
+
+#define RT_SVC_STATS_ENTRIES		16
+#define RT_SVC_STATS_BUCKETS		8
+
+#define RT_SVC_STATS_FID		0	/* SMC function ID */
+#define RT_SVC_STATS_COUNT		1	/* number of calls */
+#define RT_SVC_STATS_TOTAL		2	/* total time */
+#define RT_SVC_STATS_MAX		3	/* longest call */
+#define RT_SVC_STATS_HIST		4	/* calls taking < 4^(n+1) ticks */
+#define RT_SVC_STATS_FIELDS		(RT_SVC_STATS_HIST + RT_SVC_STATS_BUCKETS)
+
+#define RT_SVC_STATS_TID(_entry, _field)				\
+	((_entry) * RT_SVC_STATS_FIELDS + (_field))
+
+/* Number of calls that did not fit in the entries */
+#define RT_SVC_STATS_DROPPED_TID					\
+	RT_SVC_STATS_TID(RT_SVC_STATS_ENTRIES, 0)
+
 #ifndef __ASSEMBLY__
 
 /* Prototype for runtime service initializing function */
@@ -146,6 +171,13 @@ CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 void runtime_svc_init(void);
 uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
+extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
+#if ENABLE_RT_SVC_STATS
+uintptr_t rt_svc_stats_handle(uint32_t smc_fid, u_register_t x1,
+			      u_register_t x2, u_register_t x3,
+			      u_register_t x4, void *cookie, void *handle,
+			      u_register_t flags);
+#endif
 extern uintptr_t __RT_SVC_DESCS_START__;
 extern uintptr_t __RT_SVC_DESCS_END__;
 void init_crash_reporting(void);
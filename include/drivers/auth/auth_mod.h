@@ -54,12 +54,36 @@ typedef struct auth_img_desc_s {
 	auth_param_desc_t authenticated_data[COT_MAX_VERIFIED_PARAMS];
 } auth_img_desc_t;
 
+/*
+ * Hash check left to authenticate a raw image, see auth_mod_get_hash_check()
+ */
+typedef struct auth_hash_check_s {
+	void *data_ptr;
+	unsigned int data_len;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+} auth_hash_check_t;
+
 /* Public functions */
 void auth_mod_init(void);
 int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
+#if AUTH_VERIFY_IN_PLACE
+int auth_mod_verify_in_place(unsigned int img_id);
+#endif
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_get_hash_check(unsigned int img_id,
+			    void *img_ptr,
+			    unsigned int img_len,
+			    auth_hash_check_t *check);
+int auth_mod_verify_hash_check(unsigned int img_id,
+			       const auth_hash_check_t *check);
+#if ENABLE_STREAMING_HASH
+void auth_mod_hash_start(unsigned int img_id);
+void auth_mod_hash_update(unsigned int img_id, void *ptr, unsigned int len);
+void auth_mod_hash_abort(void);
+#endif
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t */
 #define REGISTER_COT(_cot) \
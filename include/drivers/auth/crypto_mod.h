@@ -61,6 +61,14 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Optional. Verify a hash computed over data supplied in several
+	 * chunks: start with the expected digest info, add the data and
+	 * compare. Only one such computation can be in progress at a time.
+	 * Return one of the 'enum crypto_ret_value' options */
+	int (*hash_init)(void *digest_info_ptr, unsigned int digest_info_len);
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+	int (*hash_final)(void);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -71,6 +79,9 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_init(void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_final(void);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -81,4 +92,19 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/* Macro to register a cryptographic library which can also verify a hash
+ * computed over data supplied in chunks */
+#define REGISTER_CRYPTO_LIB_HASH_STREAM(_name, _init, _verify_signature, \
+					_verify_hash, _hash_init, \
+					_hash_update, _hash_final) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.hash_init = _hash_init, \
+		.hash_update = _hash_update, \
+		.hash_final = _hash_final \
+	}
+
 #endif /* __CRYPTO_MOD_H__ */
@@ -32,5 +32,8 @@
 #define __MBEDTLS_COMMON_H__
 
 void mbedtls_init(void);
+#if MBEDTLS_PK_CACHE_ENTRIES
+void mbedtls_pk_cache_print_stats(void);
+#endif
 
 #endif /* __MBEDTLS_COMMON_H__ */
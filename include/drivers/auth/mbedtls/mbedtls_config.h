@@ -78,6 +78,9 @@
 #endif
 
 #define MBEDTLS_SHA256_C
+#if MBEDTLS_SHA256_CE
+#define MBEDTLS_SHA256_PROCESS_ALT
+#endif
 
 #define MBEDTLS_VERSION_C
 
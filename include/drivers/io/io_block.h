@@ -43,10 +43,20 @@ typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Optional block cache, only used when MAX_IO_BLOCK_CACHE_LINES is
+	 * defined by the platform. 'cache' is a DMA capable region split in
+	 * lines of 'cache_line_blocks' blocks, which is also the number of
+	 * blocks read ahead on a miss. Leave 'cache.length' to 0 to disable.
+	 */
+	io_block_spec_t	cache;
+	size_t		cache_line_blocks;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
 
 int register_io_dev_block(const struct io_dev_connector **dev_con);
+/* Only built with MAX_IO_BLOCK_CACHE_LINES */
+void io_block_print_stats(void);
 
 #endif /* __IO_BLOCK_H__ */
@@ -72,6 +72,7 @@ typedef struct io_dev_funcs {
 	int (*close)(io_entity_t *entity);
 	int (*dev_init)(io_dev_info_t *dev_info, const uintptr_t init_params);
 	int (*dev_close)(io_dev_info_t *dev_info);
+	int (*map)(io_entity_t *entity, size_t length, uintptr_t *address);
 } io_dev_funcs_t;
 
 
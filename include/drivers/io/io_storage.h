@@ -120,6 +120,8 @@ int io_read(uintptr_t handle, uintptr_t buffer, size_t length,
 int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 		size_t *length_written);
 
+int io_map(uintptr_t handle, size_t length, uintptr_t *address);
+
 int io_close(uintptr_t handle);
 
 
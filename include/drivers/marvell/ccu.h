@@ -37,6 +37,8 @@
 
 #include <stdint.h>
 
+#define CCU_MAX_WIN_NUM		(8)
+
 struct ccu_win {
 	uint32_t base_addr_high;
 	uint32_t base_addr_low;
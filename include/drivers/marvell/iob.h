@@ -35,6 +35,8 @@
 #ifndef _IOB_H_
 #define _IOB_H_
 
+#define IOB_MAX_WIN_NUM		(24)
+
 struct iob_win {
 	uint32_t base_addr_high;
 	uint32_t base_addr_low;
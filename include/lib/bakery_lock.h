@@ -59,17 +59,25 @@
 /*
  * Bakery locks are stored in coherent memory
  *
- * Each lock's data is contiguous and fully allocated by the compiler
+ * Each lock's data is contiguous and fully allocated by the compiler. It is
+ * padded to a whole number of 64-bit words so that the lock data of 4 CPUs
+ * can be read with a single access.
  */
+#define BAKERY_LOCK_DATA_PER_WORD	4
+#define BAKERY_LOCK_WORDS		((BAKERY_LOCK_MAX_CPUS +	\
+					  BAKERY_LOCK_DATA_PER_WORD - 1) / \
+					 BAKERY_LOCK_DATA_PER_WORD)
 
-typedef struct bakery_lock {
+typedef union bakery_lock {
 	/*
 	 * The lock_data is a bit-field of 2 members:
 	 * Bit[0]       : choosing. This field is set when the CPU is
 	 *                choosing its bakery number.
 	 * Bits[1 - 15] : number. This is the bakery number allocated.
 	 */
-	volatile uint16_t lock_data[BAKERY_LOCK_MAX_CPUS];
+	volatile uint16_t lock_data[BAKERY_LOCK_WORDS *
+				    BAKERY_LOCK_DATA_PER_WORD];
+	volatile uint64_t lock_words[BAKERY_LOCK_WORDS];
 } bakery_lock_t;
 
 #else
@@ -144,6 +144,40 @@
 #define CTX_SYSREGS_END		CTX_TIMER_SYSREGS_OFF
 #endif /* __NS_TIMER_SWITCH__ */
 
+/*
+ * Groups of EL1 system registers that el1_sysregs_context_save_mask() and
+ * el1_sysregs_context_restore_mask() handle as a unit. The AArch32 and timer
+ * groups are only switched when the build includes them in the context.
+ */
+#define CTX_EL1_GRP_SPSR_ELR_SHIFT		0
+#define CTX_EL1_GRP_SCTLR_ACTLR_SHIFT		1
+#define CTX_EL1_GRP_CPACR_CSSELR_SHIFT		2
+#define CTX_EL1_GRP_SP_ESR_SHIFT		3
+#define CTX_EL1_GRP_TTBR_SHIFT			4
+#define CTX_EL1_GRP_MAIR_AMAIR_SHIFT		5
+#define CTX_EL1_GRP_TCR_TPIDR_SHIFT		6
+#define CTX_EL1_GRP_TPIDR_EL0_SHIFT		7
+#define CTX_EL1_GRP_PAR_FAR_SHIFT		8
+#define CTX_EL1_GRP_AFSR_SHIFT			9
+#define CTX_EL1_GRP_CONTEXTIDR_VBAR_SHIFT	10
+#define CTX_EL1_GRP_AARCH32_SHIFT		11
+#define CTX_EL1_GRP_TIMER_SHIFT			12
+
+#define CTX_EL1_GRP_SPSR_ELR		(1 << CTX_EL1_GRP_SPSR_ELR_SHIFT)
+#define CTX_EL1_GRP_SCTLR_ACTLR		(1 << CTX_EL1_GRP_SCTLR_ACTLR_SHIFT)
+#define CTX_EL1_GRP_CPACR_CSSELR	(1 << CTX_EL1_GRP_CPACR_CSSELR_SHIFT)
+#define CTX_EL1_GRP_SP_ESR		(1 << CTX_EL1_GRP_SP_ESR_SHIFT)
+#define CTX_EL1_GRP_TTBR		(1 << CTX_EL1_GRP_TTBR_SHIFT)
+#define CTX_EL1_GRP_MAIR_AMAIR		(1 << CTX_EL1_GRP_MAIR_AMAIR_SHIFT)
+#define CTX_EL1_GRP_TCR_TPIDR		(1 << CTX_EL1_GRP_TCR_TPIDR_SHIFT)
+#define CTX_EL1_GRP_TPIDR_EL0		(1 << CTX_EL1_GRP_TPIDR_EL0_SHIFT)
+#define CTX_EL1_GRP_PAR_FAR		(1 << CTX_EL1_GRP_PAR_FAR_SHIFT)
+#define CTX_EL1_GRP_AFSR		(1 << CTX_EL1_GRP_AFSR_SHIFT)
+#define CTX_EL1_GRP_CONTEXTIDR_VBAR	(1 << CTX_EL1_GRP_CONTEXTIDR_VBAR_SHIFT)
+#define CTX_EL1_GRP_AARCH32		(1 << CTX_EL1_GRP_AARCH32_SHIFT)
+#define CTX_EL1_GRP_TIMER		(1 << CTX_EL1_GRP_TIMER_SHIFT)
+#define CTX_EL1_GRP_ALL			((1 << 13) - 1)
+
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the 'fp_regs'
  * structure at their correct offsets.
@@ -332,7 +366,9 @@ CASSERT(CTX_EL3STATE_OFFSET == __builtin_offsetof(cpu_context_t, el3state_ctx),
  * Function prototypes
  ******************************************************************************/
 void el1_sysregs_context_save(el1_sys_regs_t *regs);
+void el1_sysregs_context_save_mask(el1_sys_regs_t *regs, uint32_t mask);
 void el1_sysregs_context_restore(el1_sys_regs_t *regs);
+void el1_sysregs_context_restore_mask(el1_sys_regs_t *regs, uint32_t mask);
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
 void fpregs_context_restore(fp_regs_t *regs);
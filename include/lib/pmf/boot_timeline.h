@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BOOT_TIMELINE_H__
+#define __BOOT_TIMELINE_H__
+
+/*
+ * This header is shared with the host side decoder in tools/boot_timeline, so
+ * it must only depend on the standard C headers.
+ */
+#include <stdint.h>
+
+/* PMF service ID of the boot timeline */
+#define PMF_BOOT_TIMELINE_SVC_ID	1
+
+/* Magic number identifying an initialized timeline ("BTLN") */
+#define BOOT_TIMELINE_MAGIC		0x4e4c5442
+
+/*
+ * Boot timeline events. Each event is a PMF local timestamp identifier and has
+ * a single slot in the timeline, holding the CNTPCT value captured when the
+ * event was last recorded, or 0 if it was never recorded.
+ */
+#define BOOT_TL_BLE_ENTRY		0
+#define BOOT_TL_BLE_DRAM_INIT_START	1
+#define BOOT_TL_BLE_DRAM_INIT_END	2
+#define BOOT_TL_BLE_EXIT		3
+#define BOOT_TL_BL1_ENTRY		4
+#define BOOT_TL_BL1_EXIT		5
+#define BOOT_TL_BL2_ENTRY		6
+#define BOOT_TL_BL2_LOAD_IMAGES_START	7
+#define BOOT_TL_BL2_LOAD_IMAGES_END	8
+#define BOOT_TL_BL2_EXIT		9
+#define BOOT_TL_BL31_ENTRY		10
+#define BOOT_TL_BL31_RT_SVC_INIT_START	11
+#define BOOT_TL_BL31_RT_SVC_INIT_END	12
+#define BOOT_TL_BL31_EXIT		13
+#define BOOT_TL_BL31_CP0_INIT_START	14
+#define BOOT_TL_BL31_CP0_INIT_END	15
+#define BOOT_TL_BL31_CP1_INIT_START	16
+#define BOOT_TL_BL31_CP1_INIT_END	17
+#define BOOT_TL_STAGE_EVENTS		24
+
+/* Marvell CP110 initialization, possibly done by a secondary CPU */
+#define BOOT_TL_BL31_CP_INIT_START(_cp)					\
+	(BOOT_TL_BL31_CP0_INIT_START + 2 * (_cp))
+#define BOOT_TL_BL31_CP_INIT_END(_cp)					\
+	(BOOT_TL_BL31_CP0_INIT_END + 2 * (_cp))
+
+/* Per image events, recorded for image IDs below BOOT_TL_MAX_IMAGES */
+#define BOOT_TL_IMG_LOAD_START		0
+#define BOOT_TL_IMG_LOAD_END		1
+#define BOOT_TL_IMG_AUTH_START		2
+#define BOOT_TL_IMG_AUTH_END		3
+#define BOOT_TL_IMG_EVENTS		4
+#define BOOT_TL_MAX_IMAGES		24
+
+#define BOOT_TL_IMG_EVENT(_image_id, _ev)				\
+	(BOOT_TL_STAGE_EVENTS + (_image_id) * BOOT_TL_IMG_EVENTS + (_ev))
+
+#define BOOT_TL_NUM_EVENTS						\
+	(BOOT_TL_STAGE_EVENTS + BOOT_TL_MAX_IMAGES * BOOT_TL_IMG_EVENTS)
+
+/*
+ * Layout of the timeline in the memory region provided by the platform. It
+ * is handed over from one boot stage to the next in place.
+ */
+typedef struct boot_timeline {
+	uint32_t magic;
+	uint32_t num_events;
+	/* Frequency of the counter, as read from CNTFRQ_EL0 */
+	uint64_t cntfrq;
+	uint64_t ts[BOOT_TL_NUM_EVENTS];
+} boot_timeline_t;
+
+#if ENABLE_BOOT_TIMELINE
+void boot_timeline_init(void);
+void boot_timeline_record(unsigned int event);
+
+#define BOOT_TIMELINE_RECORD(_event)					\
+	boot_timeline_record(_event)
+
+#define BOOT_TIMELINE_RECORD_IMAGE(_image_id, _ev)			\
+	do {								\
+		if ((_image_id) < BOOT_TL_MAX_IMAGES)			\
+			boot_timeline_record(				\
+				BOOT_TL_IMG_EVENT(_image_id, _ev));	\
+	} while (0)
+#else
+#define BOOT_TIMELINE_RECORD(_event)
+#define BOOT_TIMELINE_RECORD_IMAGE(_image_id, _ev)
+#endif /* ENABLE_BOOT_TIMELINE */
+
+#endif /* __BOOT_TIMELINE_H__ */
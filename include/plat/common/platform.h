@@ -210,6 +210,10 @@ void bl2_plat_get_bl32_meminfo(struct meminfo *mem_info);
 /*******************************************************************************
  * Optional BL2 functions (may be overridden)
  ******************************************************************************/
+#if BL2_PARALLEL_AUTH
+int bl2_plat_secondary_start(unsigned int core_pos);
+void bl2_plat_secondary_stop(unsigned int core_pos);
+#endif
 
 /*******************************************************************************
  * Mandatory BL2U functions.
@@ -0,0 +1,63 @@
+/*
+ * ***************************************************************************
+ * Copyright (C) 2016 Marvell International Ltd.
+ * ***************************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of Marvell nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************
+ */
+
+#ifndef __PLAT_DRAM_CACHE_H__
+#define __PLAT_DRAM_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct dram_config;
+
+/*
+ * Initialize the DRAM from the training result saved on an earlier boot, or
+ * run the full training and save its result. Used by BLE when built with
+ * DRAM_TRAINING_CACHE.
+ */
+int ble_dram_cache_init(struct dram_config *cfg, uint32_t clk_mode);
+
+/*
+ * Board hooks of the DRAM training cache. plat_dram_cache_read/write() access
+ * the region reserved for the cache on the boot device.
+ * plat_dram_training_get/set() export the result of the last training from
+ * the DRAM controller and PHY, and program it back. The default hooks return
+ * -ENODEV, which makes BLE always run the full training.
+ */
+int plat_dram_cache_read(void *buf, size_t len);
+int plat_dram_cache_write(const void *buf, size_t len);
+int plat_dram_training_get(void *buf, size_t max_len, size_t *len);
+int plat_dram_training_set(struct dram_config *cfg, const void *buf,
+			   size_t len);
+
+#endif /* __PLAT_DRAM_CACHE_H__ */
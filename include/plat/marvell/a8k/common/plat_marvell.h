@@ -105,6 +105,9 @@ void *plat_get_skip_image_data(void);
 /* FIP TOC validity check */
 int marvell_io_is_toc_valid(void);
 
+/* Image source lookup statistics */
+void marvell_io_print_stats(void);
+
 /*
  * Mandatory functions required in Marvell standard platforms
  */
@@ -116,6 +119,7 @@ void plat_marvell_gic_init(void);
  */
 void psci_arch_init(void);
 void plat_marvell_system_reset(void);
+void marvell_program_mailbox(uintptr_t address);
 
 /*
  * Optional functions required in Marvell standard platforms
@@ -127,6 +131,9 @@ int plat_marvell_get_alt_image_source(
 	uintptr_t *image_spec);
 unsigned int plat_marvell_calc_core_pos(u_register_t mpidr);
 
+/* Read the DRAM SPD through I2C and check its CRC, used by BLE */
+int marvell_spd_read(uint8_t chip, int alen, uint8_t *spd, int len);
+
 #if PALLADIUM
 void marvell_bl1_setup_mpps(void);
 #endif
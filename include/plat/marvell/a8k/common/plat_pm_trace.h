@@ -71,21 +71,16 @@ struct pm_trace_ctrl {
 /* trace address definition */
 #define AP_MSS_TIMER_BASE		(MVEBU_REGS_BASE_MASK + 0x580110)
 
-#define AP_MSS_ATF_CORE_0_CTRL_BASE	(MVEBU_REGS_BASE_MASK + 0x522050)
-#define AP_MSS_ATF_CORE_1_CTRL_BASE	(MVEBU_REGS_BASE_MASK + 0x522060)
-#define AP_MSS_ATF_CORE_2_CTRL_BASE	(MVEBU_REGS_BASE_MASK + 0x522070)
-#define AP_MSS_ATF_CORE_3_CTRL_BASE	(MVEBU_REGS_BASE_MASK + 0x522080)
-#define AP_MSS_ATF_CORE_CTRL_BASE	(AP_MSS_ATF_CORE_0_CTRL_BASE)
-
-#define AP_MSS_ATF_CORE_0_INFO_BASE	(MVEBU_REGS_BASE_MASK + 0x5220D0)
-#define AP_MSS_ATF_CORE_0_INFO_TRACE	(MVEBU_REGS_BASE_MASK + 0x5220D4)
-#define AP_MSS_ATF_CORE_1_INFO_BASE	(MVEBU_REGS_BASE_MASK + 0x5228D0)
-#define AP_MSS_ATF_CORE_1_INFO_TRACE	(MVEBU_REGS_BASE_MASK + 0x5228D4)
-#define AP_MSS_ATF_CORE_2_INFO_BASE	(MVEBU_REGS_BASE_MASK + 0x5230D0)
-#define AP_MSS_ATF_CORE_2_INFO_TRACE	(MVEBU_REGS_BASE_MASK + 0x5230D4)
-#define AP_MSS_ATF_CORE_3_INFO_BASE	(MVEBU_REGS_BASE_MASK + 0x5238D0)
-#define AP_MSS_ATF_CORE_3_INFO_TRACE	(MVEBU_REGS_BASE_MASK + 0x5238D4)
-#define AP_MSS_ATF_CORE_INFO_BASE	(AP_MSS_ATF_CORE_0_INFO_BASE)
+#define AP_MSS_ATF_CORE_CTRL_BASE	(MVEBU_REGS_BASE_MASK + 0x522050)
+#define AP_MSS_ATF_CORE_CTRL_SIZE	(0x10)
+#define AP_MSS_ATF_CORE_CTRL(core)	(AP_MSS_ATF_CORE_CTRL_BASE + \
+					 ((core) * AP_MSS_ATF_CORE_CTRL_SIZE))
+
+#define AP_MSS_ATF_CORE_INFO_BASE	(MVEBU_REGS_BASE_MASK + 0x5220D0)
+#define AP_MSS_ATF_CORE_INFO(core)	(AP_MSS_ATF_CORE_INFO_BASE + \
+					 ((core) * AP_MSS_ATF_CORE_INFO_SIZE * \
+					  AP_MSS_ATF_CORE_ENTRY_SIZE))
+#define AP_MSS_ATF_CORE_TRACE_OFFSET	(0x4)
 
 /* trace info definition */
 #define TRACE_PWR_DOMAIN_OFF			(0x10000)
@@ -98,15 +93,7 @@ struct pm_trace_ctrl {
 
 #if defined(SCP_IMAGE) && defined(PM_TRACE_ENABLE)
 
-/* trace API definition */
-void pm_core_0_trace(unsigned int trace);
-void pm_core_1_trace(unsigned int trace);
-void pm_core_2_trace(unsigned int trace);
-void pm_core_3_trace(unsigned int trace);
-
-typedef void (*core_trace_func)(unsigned int);
-
-extern core_trace_func funcTbl[PLATFORM_CORE_COUNT];
+#define PM_TRACE(trace, core)	pm_trace_add(trace, core)
 
 #else
 
@@ -40,4 +40,8 @@
  ******************************************************************************/
 void plat_delay_timer_init(void);
 
+/* CP110 initialization on a secondary CPU (CP110_PARALLEL_INIT) */
+int a8k_bl31_cp_init_start(int cp_index);
+void a8k_bl31_cp_init_join(void);
+
 #endif /* __PLAT_PRIVATE_H__ */
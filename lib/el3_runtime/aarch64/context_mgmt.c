@@ -40,6 +40,11 @@
 #include <smcc_helpers.h>
 #include <string.h>
 
+/*
+ * EL1 system register groups switched by cm_el1_sysregs_context_save() and
+ * cm_el1_sysregs_context_restore(), see cm_set_el1_sysregs_switch_mask().
+ */
+static uint32_t el1_sysregs_switch_mask = CTX_EL1_GRP_ALL;
 
 /*******************************************************************************
  * Context management library initialisation routine. This library is used by
@@ -256,6 +261,22 @@ void cm_prepare_el3_exit(uint32_t security_state)
 	cm_set_next_context(ctx);
 }
 
+/*******************************************************************************
+ * This function limits the EL1 system registers switched by the next two
+ * functions to the CTX_EL1_GRP_* groups set in 'mask'. It is meant to be
+ * called once, before the first world switch, by a Secure payload dispatcher
+ * that knows its Secure payload never writes the registers of the other
+ * groups. Those registers then keep the value programmed by the normal world
+ * while the Secure payload runs, and their copy in the secure context is never
+ * used. cm_prepare_el3_exit() always restores the complete EL1 context.
+ ******************************************************************************/
+void cm_set_el1_sysregs_switch_mask(uint32_t mask)
+{
+	assert((mask & ~CTX_EL1_GRP_ALL) == 0);
+
+	el1_sysregs_switch_mask = mask;
+}
+
 /*******************************************************************************
  * The next four functions are used by runtime services to save and restore
  * EL1 context on the 'cpu_context' structure for the specified security
@@ -268,7 +289,8 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx);
 
-	el1_sysregs_context_save(get_sysregs_ctx(ctx));
+	el1_sysregs_context_save_mask(get_sysregs_ctx(ctx),
+				      el1_sysregs_switch_mask);
 }
 
 void cm_el1_sysregs_context_restore(uint32_t security_state)
@@ -278,7 +300,8 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx);
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+	el1_sysregs_context_restore_mask(get_sysregs_ctx(ctx),
+					 el1_sysregs_switch_mask);
 }
 
 /*******************************************************************************
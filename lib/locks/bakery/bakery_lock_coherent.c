@@ -55,7 +55,9 @@
  * when translation is enabled).
  *
  * Note that the ARM architecture guarantees single-copy atomicity for aligned
- * accesses regardless of status of address translation.
+ * accesses regardless of status of address translation. Each access to the
+ * coherent memory is a round trip to the interconnect, so the lock data of
+ * the contenders is read 4 CPUs at a time with aligned 64-bit accesses.
  */
 
 #define assert_bakery_entry_valid(entry, bakery) do {	\
@@ -63,11 +65,17 @@
 	assert(entry < BAKERY_LOCK_MAX_CPUS);		\
 } while (0)
 
+/* Extract the lock data of a CPU from a word of lock data */
+#define bakery_word_data(word, cpu)					\
+	((unsigned int)((word) >> (16 * ((cpu) % BAKERY_LOCK_DATA_PER_WORD))) \
+	 & 0xFFFF)
+
 /* Obtain a ticket for a given CPU */
 static unsigned int bakery_get_ticket(bakery_lock_t *bakery, unsigned int me)
 {
 	unsigned int my_ticket, their_ticket;
-	unsigned int they;
+	unsigned int they, word;
+	uint64_t lock_word;
 
 	/* Prevent recursive acquisition */
 	assert(!bakery_ticket_number(bakery->lock_data[me]));
@@ -84,10 +92,14 @@ static unsigned int bakery_get_ticket(bakery_lock_t *bakery, unsigned int me)
 	 */
 	my_ticket = 0;
 	bakery->lock_data[me] = make_bakery_data(CHOOSING_TICKET, my_ticket);
-	for (they = 0; they < BAKERY_LOCK_MAX_CPUS; they++) {
-		their_ticket = bakery_ticket_number(bakery->lock_data[they]);
-		if (their_ticket > my_ticket)
-			my_ticket = their_ticket;
+	for (word = 0; word < BAKERY_LOCK_WORDS; word++) {
+		lock_word = bakery->lock_words[word];
+		for (they = 0; they < BAKERY_LOCK_DATA_PER_WORD; they++) {
+			their_ticket = bakery_ticket_number(
+				bakery_word_data(lock_word, they));
+			if (their_ticket > my_ticket)
+				my_ticket = their_ticket;
+		}
 	}
 
 	/*
@@ -117,6 +129,7 @@ void bakery_lock_get(bakery_lock_t *bakery)
 	unsigned int they, me;
 	unsigned int my_ticket, my_prio, their_ticket;
 	unsigned int their_bakery_data;
+	uint64_t lock_word = 0;
 
 	me = plat_my_core_pos();
 
@@ -131,13 +144,17 @@ void bakery_lock_get(bakery_lock_t *bakery)
 	 */
 	my_prio = PRIORITY(my_ticket, me);
 	for (they = 0; they < BAKERY_LOCK_MAX_CPUS; they++) {
+		if ((they % BAKERY_LOCK_DATA_PER_WORD) == 0)
+			lock_word = bakery->lock_words[they /
+						BAKERY_LOCK_DATA_PER_WORD];
+
 		if (me == they)
 			continue;
 
 		/* Wait for the contender to get their ticket */
-		do {
+		their_bakery_data = bakery_word_data(lock_word, they);
+		while (bakery_is_choosing(their_bakery_data))
 			their_bakery_data = bakery->lock_data[they];
-		} while (bakery_is_choosing(their_bakery_data));
 
 		/*
 		 * If the other party is a contender, they'll have non-zero
@@ -149,12 +166,13 @@ void bakery_lock_get(bakery_lock_t *bakery)
 			 * They have higher priority (lower value). Wait for
 			 * their ticket value to change (either release the lock
 			 * to have it dropped to 0; or drop and probably content
-			 * again for the same lock to have an even higher value)
+			 * again for the same lock to have an even higher value).
+			 * The word read may predate a wait on another
+			 * contender, so check their entry before any wfe.
 			 */
-			do {
+			while (their_ticket ==
+			       bakery_ticket_number(bakery->lock_data[they]))
 				wfe();
-			} while (their_ticket ==
-				bakery_ticket_number(bakery->lock_data[they]));
 		}
 	}
 	/* Lock acquired */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <arch_helpers.h>
+#include <boot_timeline.h>
+#include <cassert.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <string.h>
+
+/*
+ * The boot timeline lives in a memory region reserved by the platform, which
+ * must be accessible to all the boot stages recording events and survive the
+ * handover from one stage to the next. Each stage cleans the slots it writes
+ * to the point of coherency, as the next one may run with the data cache off.
+ */
+#if !defined(PLAT_BOOT_TIMELINE_BASE) || !defined(PLAT_BOOT_TIMELINE_SIZE)
+#error "ENABLE_BOOT_TIMELINE requires PLAT_BOOT_TIMELINE_BASE/SIZE"
+#endif
+
+CASSERT(sizeof(boot_timeline_t) <= PLAT_BOOT_TIMELINE_SIZE,
+	assert_boot_timeline_size);
+
+#define BOOT_TIMELINE	((boot_timeline_t *)PLAT_BOOT_TIMELINE_BASE)
+
+#ifdef IMAGE_BLE
+/*
+ * The timeline is usually in DRAM, which is only available at the end of BLE.
+ * Until boot_timeline_init() is called, BLE keeps its timestamps here.
+ */
+static unsigned long long ble_ts[BOOT_TL_STAGE_EVENTS];
+static int timeline_ready;
+#endif
+
+static void boot_timeline_reset(void)
+{
+	memset(BOOT_TIMELINE, 0, sizeof(boot_timeline_t));
+	BOOT_TIMELINE->magic = BOOT_TIMELINE_MAGIC;
+	BOOT_TIMELINE->num_events = BOOT_TL_NUM_EVENTS;
+	flush_dcache_range((uintptr_t)BOOT_TIMELINE, sizeof(boot_timeline_t));
+}
+
+/*
+ * Start a new timeline. This is called by the first boot stage that can
+ * access the timeline memory; the later stages only add events to it.
+ */
+void boot_timeline_init(void)
+{
+	boot_timeline_reset();
+
+#ifdef IMAGE_BLE
+	memcpy(BOOT_TIMELINE->ts, ble_ts, sizeof(ble_ts));
+	flush_dcache_range((uintptr_t)BOOT_TIMELINE->ts, sizeof(ble_ts));
+	timeline_ready = 1;
+#endif
+}
+
+void boot_timeline_record(unsigned int event)
+{
+	unsigned long long ts = read_cntpct_el0();
+
+	if (event >= BOOT_TL_NUM_EVENTS)
+		return;
+
+#ifdef IMAGE_BLE
+	if (!timeline_ready) {
+		if (event < BOOT_TL_STAGE_EVENTS)
+			ble_ts[event] = ts;
+		return;
+	}
+#endif
+
+	/* Start a timeline if no earlier stage did, e.g. BLE was skipped */
+	if (BOOT_TIMELINE->magic != BOOT_TIMELINE_MAGIC)
+		boot_timeline_reset();
+
+	if (BOOT_TIMELINE->cntfrq == 0) {
+		BOOT_TIMELINE->cntfrq = read_cntfrq_el0();
+		flush_dcache_range((uintptr_t)&BOOT_TIMELINE->cntfrq,
+				   sizeof(BOOT_TIMELINE->cntfrq));
+	}
+
+	BOOT_TIMELINE->ts[event] = ts;
+	flush_dcache_range((uintptr_t)&BOOT_TIMELINE->ts[event],
+			   sizeof(BOOT_TIMELINE->ts[event]));
+}
+
+#if defined(IMAGE_BL31) && ENABLE_PMF && ENABLE_BOOT_TIMELINE
+/*
+ * PMF time-stamp retrieval handler. The timeline is not per-CPU, so the same
+ * value is returned whatever the MPIDR is.
+ */
+static unsigned long long boot_timeline_get_ts(unsigned int tid,
+					       u_register_t mpidr,
+					       unsigned int flags)
+{
+	unsigned int event = tid & PMF_TID_MASK;
+
+	if ((BOOT_TIMELINE->magic != BOOT_TIMELINE_MAGIC) ||
+	    (event >= BOOT_TL_NUM_EVENTS))
+		return 0;
+
+	if (flags & PMF_CACHE_MAINT)
+		inv_dcache_range((uintptr_t)&BOOT_TIMELINE->ts[event],
+				 sizeof(BOOT_TIMELINE->ts[event]));
+
+	return BOOT_TIMELINE->ts[event];
+}
+
+PMF_REGISTER_SERVICE_SMC_OWN(boot_timeline, PMF_ARM_TIF_IMPL_ID,
+	PMF_BOOT_TIMELINE_SVC_ID, BOOT_TL_NUM_EVENTS, NULL,
+	boot_timeline_get_ts)
+#endif /* IMAGE_BL31 && ENABLE_PMF && ENABLE_BOOT_TIMELINE */
@@ -29,6 +29,235 @@
  */
 
 #include <stddef.h> /* size_t */
+#include <stdint.h> /* uintptr_t */
+
+#if OPTIMIZED_MEM_FUNCS
+/*
+ * Word-wide implementations of the mem* routines.
+ *
+ * Only naturally aligned word accesses are ever issued, so these routines
+ * remain safe when the MMU is off (all memory is Device-nGnRnE) and when
+ * building with -mstrict-align. When the source and destination do not
+ * share the same alignment inside a word, the byte loops are used.
+ *
+ * Note that SIMD registers are not used because the firmware is built with
+ * -mgeneral-regs-only and does not save the FP/SIMD context at EL3. On
+ * AArch64 the 4-word unrolled loops are emitted as LDP/STP pairs.
+ */
+typedef uintptr_t mem_word_t;
+
+#define WSIZE		sizeof(mem_word_t)
+#define WMASK		(WSIZE - 1)
+#define WALIGNED(p)	(((uintptr_t)(p) & WMASK) == 0)
+/* 0x0101...01 and 0x8080...80 patterns of the word size */
+#define WONES		((mem_word_t)-1 / 0xff)
+#define WHIGHS		(WONES << 7)
+/* Non-zero if any byte of @w is zero */
+#define WHASZERO(w)	(((w) - WONES) & ~(w) & WHIGHS)
+
+/*
+ * Fill @count bytes of memory pointed to by @dst with @val
+ */
+void *memset(void *dst, int val, size_t count)
+{
+	unsigned char *ptr = dst;
+	mem_word_t *wptr;
+	mem_word_t wval;
+
+	while (count && !WALIGNED(ptr)) {
+		*ptr++ = val;
+		count--;
+	}
+
+	wptr = (mem_word_t *)ptr;
+	wval = WONES * (unsigned char)val;
+	while (count >= 4 * WSIZE) {
+		wptr[0] = wval;
+		wptr[1] = wval;
+		wptr[2] = wval;
+		wptr[3] = wval;
+		wptr += 4;
+		count -= 4 * WSIZE;
+	}
+	while (count >= WSIZE) {
+		*wptr++ = wval;
+		count -= WSIZE;
+	}
+
+	ptr = (unsigned char *)wptr;
+	while (count--)
+		*ptr++ = val;
+
+	return dst;
+}
+
+/*
+ * Compare @len bytes of @s1 and @s2
+ */
+int memcmp(const void *s1, const void *s2, size_t len)
+{
+	const char *s = s1;
+	const char *d = s2;
+	const mem_word_t *ws;
+	const mem_word_t *wd;
+	char dc;
+	char sc;
+
+	if ((((uintptr_t)s ^ (uintptr_t)d) & WMASK) == 0) {
+		while (len && !WALIGNED(s)) {
+			sc = *s++;
+			dc = *d++;
+			if (sc - dc)
+				return (sc - dc);
+			len--;
+		}
+
+		/* Skip over the equal words, the byte loop finds the delta */
+		ws = (const mem_word_t *)s;
+		wd = (const mem_word_t *)d;
+		while (len >= WSIZE && *ws == *wd) {
+			ws++;
+			wd++;
+			len -= WSIZE;
+		}
+		s = (const char *)ws;
+		d = (const char *)wd;
+	}
+
+	while (len--) {
+		sc = *s++;
+		dc = *d++;
+		if (sc - dc)
+			return (sc - dc);
+	}
+
+	return 0;
+}
+
+/*
+ * Copy @len bytes from @src to @dst
+ */
+void *memcpy(void *dst, const void *src, size_t len)
+{
+	const char *s = src;
+	char *d = dst;
+	const mem_word_t *ws;
+	mem_word_t *wd;
+	mem_word_t w0, w1, w2, w3;
+
+	if ((((uintptr_t)s ^ (uintptr_t)d) & WMASK) == 0) {
+		while (len && !WALIGNED(d)) {
+			*d++ = *s++;
+			len--;
+		}
+
+		ws = (const mem_word_t *)s;
+		wd = (mem_word_t *)d;
+		while (len >= 4 * WSIZE) {
+			w0 = ws[0];
+			w1 = ws[1];
+			w2 = ws[2];
+			w3 = ws[3];
+			wd[0] = w0;
+			wd[1] = w1;
+			wd[2] = w2;
+			wd[3] = w3;
+			ws += 4;
+			wd += 4;
+			len -= 4 * WSIZE;
+		}
+		while (len >= WSIZE) {
+			*wd++ = *ws++;
+			len -= WSIZE;
+		}
+		s = (const char *)ws;
+		d = (char *)wd;
+	}
+
+	while (len--)
+		*d++ = *s++;
+
+	return dst;
+}
+
+/*
+ * Move @len bytes from @src to @dst
+ */
+void *memmove(void *dst, const void *src, size_t len)
+{
+	const mem_word_t *ws;
+	mem_word_t *wd;
+
+	/*
+	 * The following test makes use of unsigned arithmetic overflow to
+	 * more efficiently test the condition !(src <= dst && dst < str+len).
+	 * It also avoids the situation where the more explicit test would give
+	 * incorrect results were the calculation str+len to overflow (though
+	 * that issue is probably moot as such usage is probably undefined
+	 * behaviour and a bug anyway.
+	 */
+	if ((size_t)dst - (size_t)src >= len) {
+		/* destination not in source data, so can safely use memcpy */
+		return memcpy(dst, src, len);
+	} else {
+		/* copy backwards... */
+		const char *end = dst;
+		const char *s = (const char *)src + len;
+		char *d = (char *)dst + len;
+
+		if ((((uintptr_t)s ^ (uintptr_t)d) & WMASK) == 0) {
+			while (d != end && !WALIGNED(d))
+				*--d = *--s;
+
+			ws = (const mem_word_t *)s;
+			wd = (mem_word_t *)d;
+			while ((size_t)((char *)wd - end) >= WSIZE)
+				*--wd = *--ws;
+			s = (const char *)ws;
+			d = (char *)wd;
+		}
+
+		while (d != end)
+			*--d = *--s;
+	}
+	return dst;
+}
+
+/*
+ * Scan @len bytes of @src for value @c
+ */
+void *memchr(const void *src, int c, size_t len)
+{
+	const unsigned char *s = src;
+	const mem_word_t *ws;
+	mem_word_t pattern;
+
+	while (len && !WALIGNED(s)) {
+		if (*s == (unsigned char)c)
+			return (void *) s;
+		s++;
+		len--;
+	}
+
+	/* Stop on the first word containing @c, the byte loop locates it */
+	ws = (const mem_word_t *)s;
+	pattern = WONES * (unsigned char)c;
+	while (len >= WSIZE && !WHASZERO(*ws ^ pattern)) {
+		ws++;
+		len -= WSIZE;
+	}
+
+	s = (const unsigned char *)ws;
+	while (len--) {
+		if (*s == (unsigned char)c)
+			return (void *) s;
+		s++;
+	}
+
+	return NULL;
+}
+
+#else /* OPTIMIZED_MEM_FUNCS */
 
 /*
  * Fill @count bytes of memory pointed to by @dst with @val
@@ -119,3 +348,4 @@ void *memchr(const void *src, int c, size_t len)
 
 	return NULL;
 }
+#endif /* OPTIMIZED_MEM_FUNCS */
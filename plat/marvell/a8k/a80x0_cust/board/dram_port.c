@@ -133,9 +133,13 @@ int update_dram_info(struct dram_config *cfg)
 		 * prior to accessing the DRAM configuration data
 		 */
 		i2c_read(I2C_SPD_P0_ADDR, 0x0, 1, tm->spd_data.all_bytes, 1);
-		/* read data from spd */
-		i2c_read(I2C_SPD_ADDR, 0x0, 1, tm->spd_data.all_bytes,
-			 sizeof(tm->spd_data.all_bytes));
+		/* read data from spd and check its CRC */
+		if (marvell_spd_read(I2C_SPD_ADDR, 1, tm->spd_data.all_bytes,
+				     sizeof(tm->spd_data.all_bytes))) {
+			/* do not train with a corrupted SPD */
+			WARN("Using the static DRAM topology of the board\n");
+			tm->cfg_src = MV_DDR_CFG_DEFAULT;
+		}
 	}
 
 	return 0;
@@ -40,5 +40,6 @@
 #define CP_COUNT		2	/* A80x0 has both CP0 & CP1 */
 #define I2C_SPD_ADDR		0x53	/* Access SPD data */
 #define I2C_SPD_P0_ADDR		0x36	/* Select SPD data page 0 */
+#define CONFIG_SYS_I2C_SPEED	400000	/* SPD EEPROM supports fast-mode */
 
 #endif /* __MVEBU_DEF_H__ */
@@ -64,9 +64,13 @@ BLE_PORTING_SOURCES	:=	$(PLAT_FAMILY_BASE)/$(PLAT)/board/dram_port.c \
 
 BLE_SOURCES		:=	plat/marvell/common/sys_info.c		 \
 				plat/marvell/a8k/common/plat_ble_setup.c \
+				plat/marvell/a8k/common/plat_ble_spd.c	 \
 				$(MARVELL_DRV_BASE)/mochi/cp110_setup.c	 \
 				$(MARVELL_DRV_BASE)/i2c/a8k_i2c.c	 \
 				$(BLE_PORTING_SOURCES)
+ifeq (${DRAM_TRAINING_CACHE}, 1)
+BLE_SOURCES		+=	$(PLAT_COMMON_BASE)/plat_ble_dram_cache.c
+endif
 ifeq (${PCI_EP_SUPPORT}, 1)
 BLE_SOURCES		+=	plat/marvell/common/pci_ep_setup.c	 \
 				$(MARVELL_DRV_BASE)/dw-pcie-ep.c	 \
@@ -80,7 +84,8 @@ endif
 BL1_SOURCES		+=	$(PLAT_COMMON_BASE)/aarch64/plat_helpers.S \
 				lib/cpus/aarch64/cortex_a72.S
 
-MARVELL_DRV		:= 	$(MARVELL_DRV_BASE)/rfu.c	\
+MARVELL_DRV		:= 	$(MARVELL_DRV_BASE)/addr_map.c	\
+				$(MARVELL_DRV_BASE)/rfu.c	\
 				$(MARVELL_DRV_BASE)/iob.c	\
 				$(MARVELL_DRV_BASE)/mci.c	\
 				$(MARVELL_DRV_BASE)/amb_adec.c	\
@@ -104,6 +109,26 @@ BL31_SOURCES		+=	lib/cpus/aarch64/cortex_a72.S		       \
 				$(MARVELL_MOCHI_DRV)			       \
 				$(MARVELL_GIC_SOURCES)
 
+# Secondary CPUs used by BL2 to authenticate images
+ifeq (${BL2_PARALLEL_AUTH},1)
+BL2_SOURCES		+=	$(PLAT_COMMON_BASE)/plat_bl2_secondary.c	       \
+				$(PLAT_COMMON_BASE)/aarch64/plat_bl2_secondary.S \
+				$(PLAT_COMMON_BASE)/aarch64/plat_helpers.S
+endif
+
+# Secondary CPU used by BL31 to configure CP0. The power of the CPUs is
+# controlled by the MSS firmware when there is one.
+ifneq (${SCP_BL2},)
+ifeq (${CP110_PARALLEL_INIT},1)
+$(warning CP110_PARALLEL_INIT is not supported with SCP_BL2, disabled)
+override CP110_PARALLEL_INIT := 0
+endif
+endif
+ifeq (${CP110_PARALLEL_INIT},1)
+BL31_SOURCES		+=	$(PLAT_COMMON_BASE)/plat_bl31_secondary.c	\
+				$(PLAT_COMMON_BASE)/aarch64/plat_bl31_secondary.S
+endif
+
 # Add trace functionality for PM
 ifneq (${SCP_BL2},)
 BL31_SOURCES		+=	$(PLAT_COMMON_BASE)/plat_pm_trace.c
@@ -114,6 +139,12 @@ endif
 # It is not needed since Marvell platform already used the new platform APIs.
 ENABLE_PLAT_COMPAT	:= 	0
 
+# Images are copied out of the boot device bounce buffers with memcpy()
+OPTIMIZED_MEM_FUNCS	:= 	1
+
+# The FIP is in DRAM, so the certificates are authenticated where they lie
+AUTH_VERIFY_IN_PLACE	:= 	1
+
 # MSS (SCP) build
 ifneq (${SCP_BL2},)
 include plat/marvell/a8k/common/mss/mss_common.mk
@@ -51,6 +51,10 @@
 #define MVEBU_RFU_BASE			(MVEBU_REGS_BASE + 0x6F0000)
 #define MVEBU_CCU_BASE			(MVEBU_REGS_BASE + 0x4000)
 #define MVEBU_LLC_BASE			(MVEBU_REGS_BASE + 0x8000)
+/* CPU start address and reset, for the cluster selected by the private UID */
+#define MVEBU_PRIVATE_UID_REG		0x30
+#define MVEBU_CCU_RVBAR(i)		(MVEBU_REGS_BASE + 0x640 + (i * 4))
+#define MVEBU_CCU_CPU_UN_RESET		(MVEBU_REGS_BASE + 0x650)
 #define MVEBU_IOB_BASE(cp_index)	(MVEBU_CP_REGS_BASE(cp_index) + \
 								0x190000)
 #define MVEBU_DRAM_MAC_BASE		(MVEBU_REGS_BASE + 0x20000)
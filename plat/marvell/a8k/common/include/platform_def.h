@@ -199,4 +199,11 @@
 #define PLAT_MARVELL_MAILBOX_BASE	(MARVELL_TRUSTED_SRAM_BASE + 0x400)
 #define PLAT_MARVELL_MAILBOX_SIZE	0x100
 
+/*
+ * Boot timeline, written by all the boot stages from BLE onwards and read by
+ * BL31 (upper half of the shared RAM)
+ */
+#define PLAT_BOOT_TIMELINE_BASE		(MARVELL_SHARED_RAM_BASE + 0x800)
+#define PLAT_BOOT_TIMELINE_SIZE		0x800
+
 #endif /* __PLATFORM_DEF_H__ */
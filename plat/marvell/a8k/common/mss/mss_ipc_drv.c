@@ -32,6 +32,7 @@
  ***************************************************************************
  */
 
+#include <arch_helpers.h>
 #include <debug.h>
 #include <string.h>
 #include <mss_ipc_drv.h>
@@ -108,6 +109,8 @@ int mv_pm_ipc_msg_tx(unsigned int channel_id, unsigned int direction,
 	unsigned int addr = mv_pm_ipc_queue_addr_get(channel_id, direction);
 
 	mmio_write_32(addr + IPC_MSG_POWER_STATE_LOC, cluster_power_state);
+	/* the message must be complete when MSS sees it occupied */
+	dsb();
 	mmio_write_32(addr + IPC_MSG_STATE_LOC, IPC_MSG_OCCUPY);
 
 	return 0;
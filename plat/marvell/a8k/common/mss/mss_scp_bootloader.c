@@ -38,6 +38,7 @@
 #include <arch_helpers.h> /* for cache maintanance operations */
 #include <platform_def.h>
 #include <delay_timer.h>
+#include <string.h>
 #include <apn806_setup.h>
 
 #include <plat_pm_trace.h>
@@ -64,7 +65,8 @@
 #define MSS_AEBR_MASK			0xFFF
 #define MSS_AIBR_MASK			0xFFF
 
-#define MSS_DMA_TIMEOUT			1000
+/* Time allowed for the transfer of a single DMA_SIZE chunk */
+#define MSS_DMA_TIMEOUT_US		50000
 #define MSS_EXTERNAL_SPACE		0x50000000
 #define MSS_EXTERNAL_ACCESS_BIT		28
 #define MSS_EXTERNAL_ADDR_MASK		0xfffffff
@@ -72,6 +74,9 @@
 
 #define DMA_SIZE			128
 
+#define MSS_US_TO_TICKS(us)		((us) * (uint64_t)COUNTER_FREQUENCY / 1000000)
+#define MSS_TICKS_TO_US(ticks)		((ticks) * 1000000 / COUNTER_FREQUENCY)
+
 #define MSS_HANDSHAKE_TIMEOUT		50
 /* TODO: Fix this */
 #define AP_MSS_REG_BASE			(MVEBU_REGS_BASE + 0x580000)
@@ -100,14 +105,70 @@ static int mss_check_image_ready(struct mss_pm_ctrl_block *mss_pm_crtl)
 }
 
 
-static int mss_image_load(uint32_t src_addr, uint32_t size, uintptr_t  mss_regs)
+/*
+ * The DMA engine has a single descriptor, so the image is moved one DMA_SIZE
+ * chunk at a time. The loader below is driven by mss_dma_load_poll(), which
+ * never blocks: it either finds the engine still busy, or retires the chunk
+ * in flight and issues the next one.
+ *
+ * TODO: this does not verify what was written to the MSS RAM. Verify the
+ * destination once it can be read back from the AP, or once the image comes
+ * with its own checksum.
+ */
+struct mss_dma_load {
+	uintptr_t mss_regs;
+	uint32_t src_addr;
+	uint32_t size;
+	uint32_t chunk;			/* chunk in flight */
+	uint32_t num_chunks;
+	uint64_t chunk_start;		/* CNTPCT when the chunk was issued */
+	uint64_t min_ticks;
+	uint64_t max_ticks;
+	uint64_t total_ticks;
+};
+
+static struct mss_dma_load mss_load;
+
+static void mss_dma_issue_chunk(struct mss_dma_load *ld)
+{
+	uint32_t offset = ld->chunk * DMA_SIZE;
+
+	/* write destination and source addresses */
+	mmio_write_32(MSS_DMA_SRCBR(ld->mss_regs),
+		      MSS_EXTERNAL_SPACE |
+		      ((ld->src_addr & MSS_EXTERNAL_ADDR_MASK) + offset));
+	mmio_write_32(MSS_DMA_DSTBR(ld->mss_regs), offset);
+
+	dsb(); /* make sure DMA data is ready before triggering it */
+
+	/* set the DMA control register */
+	mmio_write_32(MSS_DMA_CTRLR(ld->mss_regs), ((MSS_DMA_CTRLR_REQ_SET
+		      << MSS_DMA_CTRLR_REQ_OFFSET) |
+		      (DMA_SIZE << MSS_DMA_CTRLR_SIZE_OFFSET)));
+
+	/* Time the chunk from the last register write */
+	ld->chunk_start = read_cntpct_el0();
+}
+
+/*
+ * Start loading the image to the MSS RAM. The image at src_addr must not be
+ * modified until mss_dma_load_wait() has returned.
+ */
+static void mss_dma_load_start(uint32_t src_addr, uint32_t size,
+			       uintptr_t mss_regs)
 {
-	uint32_t i, loop_num, timeout;
+	struct mss_dma_load *ld = &mss_load;
 
 	NOTICE("Loading MSS image from address 0x%x Size 0x%x to MSS at 0x%x\n",
 	       src_addr, size, (uint32_t)mss_regs);
-	/* load image to MSS RAM using DMA */
-	loop_num = (size / DMA_SIZE) + (((size & (DMA_SIZE - 1)) == 0) ? 0 : 1);
+
+	memset(ld, 0, sizeof(*ld));
+	ld->mss_regs = mss_regs;
+	ld->src_addr = src_addr;
+	ld->size = size;
+	ld->num_chunks = (size / DMA_SIZE) +
+			 (((size & (DMA_SIZE - 1)) == 0) ? 0 : 1);
+	ld->min_ticks = UINT64_MAX;
 
 	/* set AXI External and Internal Address Bus extension */
 	mmio_write_32(MSS_AEBR(mss_regs), ((src_addr >> MSS_EXTERNAL_ACCESS_BIT)
@@ -115,42 +176,74 @@ static int mss_image_load(uint32_t src_addr, uint32_t size, uintptr_t  mss_regs)
 	mmio_write_32(MSS_AIBR(mss_regs), ((mss_regs >> MSS_INTERNAL_ACCESS_BIT)
 		      & MSS_AIBR_MASK));
 
-	for (i = 0; i < loop_num; i++) {
-		/* write destination and source addresses */
-		mmio_write_32(MSS_DMA_SRCBR(mss_regs),
-			      MSS_EXTERNAL_SPACE |
-			      ((src_addr & MSS_EXTERNAL_ADDR_MASK) +
-			      (i * DMA_SIZE)));
-		mmio_write_32(MSS_DMA_DSTBR(mss_regs), (i * DMA_SIZE));
-
-		dsb(); /* make sure DMA data is ready before triggering it */
-
-		/* set the DMA control register */
-		mmio_write_32(MSS_DMA_CTRLR(mss_regs), ((MSS_DMA_CTRLR_REQ_SET
-			      << MSS_DMA_CTRLR_REQ_OFFSET) |
-			      (DMA_SIZE << MSS_DMA_CTRLR_SIZE_OFFSET)));
-
-		/* Poll DMA_ACK at MSS_DMACTLR until it is ready */
-		timeout = MSS_DMA_TIMEOUT;
-		while (timeout) {
-			if ((mmio_read_32(MSS_DMA_CTRLR(mss_regs)) >>
-			     MSS_DMA_CTRLR_ACK_OFFSET & MSS_DMA_CTRLR_ACK_MASK)
-				== MSS_DMA_CTRLR_ACK_READY) {
-				break;
-			}
-
-			udelay(50);
-			timeout--;
-		}
+	mss_dma_issue_chunk(ld);
+}
+
+/*
+ * Make progress on the image load without blocking.
+ * Return 1 while the load is in progress, 0 once all the chunks have been
+ * transferred and -1 if the chunk in flight has timed out.
+ */
+static int mss_dma_load_poll(void)
+{
+	struct mss_dma_load *ld = &mss_load;
+	uint64_t ticks;
 
-		if (timeout == 0) {
-			ERROR("\nDMA failed to load MSS image\n");
-			return 1;
+	if (ld->chunk >= ld->num_chunks)
+		return 0;
+
+	ticks = read_cntpct_el0() - ld->chunk_start;
+
+	if (((mmio_read_32(MSS_DMA_CTRLR(ld->mss_regs)) >>
+	      MSS_DMA_CTRLR_ACK_OFFSET) & MSS_DMA_CTRLR_ACK_MASK) !=
+	    MSS_DMA_CTRLR_ACK_READY) {
+		if (ticks > MSS_US_TO_TICKS(MSS_DMA_TIMEOUT_US)) {
+			ERROR("DMA of MSS image chunk %d timed out\n",
+			      ld->chunk);
+			return -1;
 		}
+		return 1;
+	}
+
+	if (ticks < ld->min_ticks)
+		ld->min_ticks = ticks;
+	if (ticks > ld->max_ticks)
+		ld->max_ticks = ticks;
+	ld->total_ticks += ticks;
+
+	if (++ld->chunk == ld->num_chunks)
+		return 0;
+
+	mss_dma_issue_chunk(ld);
+
+	return 1;
+}
+
+/*
+ * Wait for the image load to complete and release the M3 from reset.
+ */
+static int mss_dma_load_wait(void)
+{
+	struct mss_dma_load *ld = &mss_load;
+	int ret;
+
+	do {
+		ret = mss_dma_load_poll();
+	} while (ret > 0);
+
+	if (ret != 0) {
+		ERROR("\nDMA failed to load MSS image\n");
+		return 1;
 	}
 
+	INFO("MSS image loaded, %d chunks in %llu us\n", ld->num_chunks,
+	     (unsigned long long)MSS_TICKS_TO_US(ld->total_ticks));
+	VERBOSE("MSS DMA chunk time: min %llu us max %llu us\n",
+		(unsigned long long)MSS_TICKS_TO_US(ld->min_ticks),
+		(unsigned long long)MSS_TICKS_TO_US(ld->max_ticks));
+
 	/* Release M3 from reset */
-	mmio_write_32(MSS_M3_RSTCR(mss_regs), (MSS_M3_RSTCR_RST_OFF <<
+	mmio_write_32(MSS_M3_RSTCR(ld->mss_regs), (MSS_M3_RSTCR_RST_OFF <<
 		      MSS_M3_RSTCR_RST_OFFSET));
 
 	NOTICE("Done\n");
@@ -198,10 +291,15 @@ int scp_bootloader_transfer(void *image, unsigned int image_size)
 	VERBOSE("mss_pm_crtl->pm_trace_info_core_size    = 0x%x\n",
 		mss_pm_crtl->pm_trace_info_core_size);
 
-	/* TODO: add checksum to image */
 	VERBOSE("Send info about the SCP_BL2 image to be transferred to SCP\n");
 	NOTICE("Load image to AP MSS\n");
-	ret = mss_image_load((uintptr_t)image, image_size, AP_MSS_REG_BASE);
+	mss_dma_load_start((uintptr_t)image, image_size, AP_MSS_REG_BASE);
+
+	/*
+	 * SCP_BL2 is loaded where BL31 goes next, so the transfer has to be
+	 * complete before BL2 moves on to the next image.
+	 */
+	ret = mss_dma_load_wait();
 	if (ret != 0) {
 		ERROR("SCP Image load failed\n");
 		return -1;
@@ -0,0 +1,132 @@
+/*
+ * ***************************************************************************
+ * Copyright (C) 2017 Marvell International Ltd.
+ * ***************************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of Marvell nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************
+ */
+
+#include <arch_helpers.h>
+#include <debug.h>
+#include <mmio.h>
+#include <platform.h>
+#include <platform_def.h>
+
+/*
+ * Secondary CPUs in BL2, used to authenticate images in parallel
+ * (BL2_PARALLEL_AUTH).
+ *
+ * A CPU is released from reset with the BL1 entry point as start address and
+ * the BL2 secondary entry point in the mailbox, which BL1 jumps to at EL3
+ * without any initialization. The entry point (plat_bl2_secondary.S) does
+ * the CPU setup that BL1 skipped, enables the MMU with the BL2 translation
+ * tables and calls the generic worker. When the worker returns, the CPU
+ * cleans its data cache, reports it is parked and waits for BL2 to put it
+ * back in reset, so that BL31 finds it off as expected by PSCI.
+ */
+
+/* Time given to a secondary CPU to park itself */
+#define A8K_BL2_SECONDARY_PARK_TIMEOUT	(COUNTER_FREQUENCY / 100)
+
+/* Written by the secondary CPU with its caches off, one per cache line */
+typedef struct a8k_bl2_secondary_state {
+	volatile uint32_t parked;
+} __aligned(CACHE_WRITEBACK_GRANULE) a8k_bl2_secondary_state_t;
+
+static a8k_bl2_secondary_state_t secondary_state[PLATFORM_CORE_COUNT];
+
+void a8k_bl2_secondary_entrypoint(void);
+
+static void a8k_bl2_program_mailbox(uintptr_t address)
+{
+	uintptr_t *mailbox = (void *)PLAT_MARVELL_MAILBOX_BASE;
+
+	*mailbox = address;
+#if PLAT_MARVELL_SHARED_RAM_CACHED
+	flush_dcache_range((uintptr_t)mailbox, sizeof(*mailbox));
+#endif
+}
+
+/* Called by plat_bl2_secondary.S with the MMU and data cache off */
+void a8k_bl2_secondary_parked(void)
+{
+	secondary_state[plat_my_core_pos()].parked = 1;
+	dsbsy();
+}
+
+int bl2_plat_secondary_start(unsigned int core_pos)
+{
+	unsigned int cluster = core_pos / PLAT_MARVELL_CLUSTER_CORE_COUNT;
+	unsigned int cpu_id = core_pos % PLAT_MARVELL_CLUSTER_CORE_COUNT;
+
+#ifdef SCP_IMAGE
+	/* The power of the CPUs is controlled by the MSS firmware */
+	return -1;
+#endif
+
+	/* The secondary CPU writes its state with the caches off */
+	secondary_state[core_pos].parked = 0;
+	flush_dcache_range((uintptr_t)&secondary_state[core_pos],
+			   sizeof(secondary_state[core_pos]));
+
+	a8k_bl2_program_mailbox((uintptr_t)a8k_bl2_secondary_entrypoint);
+
+	/* Same sequence as plat_marvell_cpu_on() in BL31 */
+	dsbsy();
+	mmio_write_32(MVEBU_REGS_BASE + MVEBU_PRIVATE_UID_REG, cluster + 0x4);
+	mmio_write_32(MVEBU_CCU_RVBAR(0) + (cpu_id << 2),
+		      PLAT_MARVELL_CPU_ENTRY_ADDR >> 16);
+	mmio_write_32(MVEBU_CCU_CPU_UN_RESET + (cpu_id << 2), 0x10001);
+
+	return 0;
+}
+
+void bl2_plat_secondary_stop(unsigned int core_pos)
+{
+	unsigned int cluster = core_pos / PLAT_MARVELL_CLUSTER_CORE_COUNT;
+	unsigned int cpu_id = core_pos % PLAT_MARVELL_CLUSTER_CORE_COUNT;
+	uint64_t start = read_cntpct_el0();
+
+	do {
+		inv_dcache_range((uintptr_t)&secondary_state[core_pos],
+				 sizeof(secondary_state[core_pos]));
+		if (secondary_state[core_pos].parked != 0)
+			break;
+	} while ((read_cntpct_el0() - start) < A8K_BL2_SECONDARY_PARK_TIMEOUT);
+
+	if (secondary_state[core_pos].parked == 0)
+		WARN("BL2: CPU %u did not park, resetting it\n", core_pos);
+
+	/* Put the CPU back in reset, BL31 releases it on PSCI CPU_ON */
+	mmio_write_32(MVEBU_REGS_BASE + MVEBU_PRIVATE_UID_REG, cluster + 0x4);
+	mmio_write_32(MVEBU_CCU_CPU_UN_RESET + (cpu_id << 2), 0x10000);
+
+	/* Do not leave the BL2 entry point behind for a later reset */
+	a8k_bl2_program_mailbox(0);
+}
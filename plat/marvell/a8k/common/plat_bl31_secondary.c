@@ -0,0 +1,163 @@
+/*
+ * ***************************************************************************
+ * Copyright (C) 2017 Marvell International Ltd.
+ * ***************************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of Marvell nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************
+ */
+
+#include <arch_helpers.h>
+#include <debug.h>
+#include <mmio.h>
+#include <plat_marvell.h>
+#include <plat_private.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <cp110_setup.h>
+
+/*
+ * CP110 initialization on a secondary CPU in BL31 (CP110_PARALLEL_INIT).
+ *
+ * While the primary CPU brings up the MCI link and configures CP1, CP0 is
+ * configured by a secondary CPU. Each CPU only writes to the register space
+ * of its own CP.
+ *
+ * The secondary CPU is released from reset with the BL1 entry point as start
+ * address and the BL31 secondary entry point in the mailbox, which BL1 jumps
+ * to at EL3. The entry point (plat_bl31_secondary.S) enables the MMU with the
+ * BL31 translation tables and configures the CP. The CPU then cleans its data
+ * cache, reports it is parked and waits for the primary CPU to put it back in
+ * reset, so that PSCI finds it off as expected.
+ */
+
+/* CPU configuring the CP, and time given to it to do so */
+#define A8K_CP_INIT_CPU			1
+#define A8K_CP_INIT_TIMEOUT		(COUNTER_FREQUENCY / 10)
+
+/* Time given to the secondary CPU to park itself */
+#define A8K_CP_INIT_PARK_TIMEOUT	(COUNTER_FREQUENCY / 100)
+
+/* Shared with the secondary CPU while its MMU is on */
+static struct {
+	int cp_index;
+	volatile uint32_t done;
+} cp_init;
+
+/* Written by the secondary CPU with its caches off, in its own cache line */
+typedef struct a8k_bl31_secondary_state {
+	volatile uint32_t parked;
+} __aligned(CACHE_WRITEBACK_GRANULE) a8k_bl31_secondary_state_t;
+
+static a8k_bl31_secondary_state_t secondary_state;
+
+void a8k_bl31_secondary_entrypoint(void);
+
+/* Called by plat_bl31_secondary.S with the MMU on */
+void a8k_bl31_secondary_main(void)
+{
+	cp110_init(cp_init.cp_index);
+
+	dsbsy();
+	cp_init.done = 1;
+}
+
+/* Called by plat_bl31_secondary.S with the MMU and data cache off */
+void a8k_bl31_secondary_parked(void)
+{
+	secondary_state.parked = 1;
+	dsbsy();
+}
+
+/*
+ * Start the configuration of a CP on the secondary CPU.
+ * Returns 0 on success, or -1 if the CP must be configured by the caller.
+ */
+int a8k_bl31_cp_init_start(int cp_index)
+{
+	unsigned int cluster = A8K_CP_INIT_CPU / PLAT_MARVELL_CLUSTER_CORE_COUNT;
+	unsigned int cpu_id = A8K_CP_INIT_CPU % PLAT_MARVELL_CLUSTER_CORE_COUNT;
+
+	cp_init.cp_index = cp_index;
+	cp_init.done = 0;
+
+	/* The secondary CPU writes its state with the caches off */
+	secondary_state.parked = 0;
+	flush_dcache_range((uintptr_t)&secondary_state, sizeof(secondary_state));
+
+	marvell_program_mailbox((uintptr_t)a8k_bl31_secondary_entrypoint);
+
+	/* Same sequence as plat_marvell_cpu_on() */
+	dsbsy();
+	mmio_write_32(MVEBU_REGS_BASE + MVEBU_PRIVATE_UID_REG, cluster + 0x4);
+	mmio_write_32(MVEBU_CCU_RVBAR(0) + (cpu_id << 2),
+		      PLAT_MARVELL_CPU_ENTRY_ADDR >> 16);
+	mmio_write_32(MVEBU_CCU_CPU_UN_RESET + (cpu_id << 2), 0x10001);
+
+	return 0;
+}
+
+/*
+ * Wait for the secondary CPU to complete the CP configuration and put it back
+ * in reset. If it did not complete in time, the CP is configured here.
+ */
+void a8k_bl31_cp_init_join(void)
+{
+	unsigned int cluster = A8K_CP_INIT_CPU / PLAT_MARVELL_CLUSTER_CORE_COUNT;
+	unsigned int cpu_id = A8K_CP_INIT_CPU % PLAT_MARVELL_CLUSTER_CORE_COUNT;
+	uint64_t start = read_cntpct_el0();
+
+	while (!cp_init.done &&
+	       (read_cntpct_el0() - start) < A8K_CP_INIT_TIMEOUT)
+		;
+
+	if (cp_init.done) {
+		start = read_cntpct_el0();
+		do {
+			inv_dcache_range((uintptr_t)&secondary_state,
+					 sizeof(secondary_state));
+			if (secondary_state.parked != 0)
+				break;
+		} while ((read_cntpct_el0() - start) < A8K_CP_INIT_PARK_TIMEOUT);
+	}
+
+	if (secondary_state.parked == 0)
+		WARN("BL31: CPU %u did not park, resetting it\n", A8K_CP_INIT_CPU);
+
+	mmio_write_32(MVEBU_REGS_BASE + MVEBU_PRIVATE_UID_REG, cluster + 0x4);
+	mmio_write_32(MVEBU_CCU_CPU_UN_RESET + (cpu_id << 2), 0x10000);
+
+	/* Do not leave this entry point behind, PSCI sets its own later */
+	marvell_program_mailbox(0);
+
+	if (!cp_init.done) {
+		WARN("BL31: CP%d was not configured by CPU %u, retrying\n",
+		     cp_init.cp_index, A8K_CP_INIT_CPU);
+		cp110_init(cp_init.cp_index);
+	}
+}
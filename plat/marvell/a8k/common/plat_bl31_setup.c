@@ -32,6 +32,7 @@
  ***************************************************************************
  */
 
+#include <addr_map.h>
 #include <plat_marvell.h>
 #include <plat_private.h>
 #include <apn806_setup.h>
@@ -76,9 +77,15 @@ void marvell_bl31_mss_init(void)
 /* This function overruns the same function in marvell_bl31_setup.c */
 void bl31_plat_arch_setup(void)
 {
+	int cp0_on_secondary = 0;
+
 	/* initiliaze the timer for mdelay/udelay functionality */
 	plat_delay_timer_init();
 
+	/* check the AP & CPs address decoding windows before programming any */
+	if (addr_map_validate() != 0)
+		panic();
+
 	/* configure apn806 */
 	apn806_init();
 
@@ -89,13 +96,25 @@ void bl31_plat_arch_setup(void)
 	 */
 	marvell_bl31_plat_arch_setup();
 
+#if CP110_PARALLEL_INIT
+	/* configure cp110 for CP0 on a secondary CPU, while the MCI link
+	 * and CP1 are configured here */
+	if (CP_COUNT == 2 && a8k_bl31_cp_init_start(0) == 0)
+		cp0_on_secondary = 1;
+#endif
 	/* configure cp110 for CP0*/
-	cp110_init(0);
+	if (!cp0_on_secondary)
+		cp110_init(0);
 
 	/* initialize MCI & CP1 */
 	if (CP_COUNT == 2 && mci_initialize(0))
 		cp110_init(1);
 
+#if CP110_PARALLEL_INIT
+	if (cp0_on_secondary)
+		a8k_bl31_cp_init_join();
+#endif
+
 	/* Should be called only after setting IOB windows */
 	marvell_bl31_mpp_init();
 
@@ -0,0 +1,261 @@
+/*
+ * ***************************************************************************
+ * Copyright (C) 2016 Marvell International Ltd.
+ * ***************************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of Marvell nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************
+ */
+
+#include <plat_def.h>
+#include <plat_dram_cache.h>
+#include <apn806_setup.h>
+#include <debug.h>
+#include <dram_if.h>
+#include <errno.h>
+#include <mmio.h>
+
+#include <mv_ddr_atf_wrapper.h>
+#include <apn806/mv_ddr_apn806.h>
+#include <apn806/mv_ddr_apn806_topology.h>
+
+/*
+ * DRAM training result cache.
+ *
+ * After a full training, the result exported by the board is stored in a
+ * region reserved on the boot device, together with a key identifying the
+ * memory configuration it was obtained with. On the next boots the result is
+ * programmed back instead of training again, as long as the key matches and
+ * the DRAM passes a short pattern test. Any failure falls back to a full
+ * training, which then refreshes the cache.
+ *
+ * The key covers the board topology map, which holds the SPD contents read
+ * from the DIMM, the AP revision and the clock mode sampled at reset.
+ */
+
+#define DRAM_CACHE_MAGIC	0x43545244	/* "DRTC" */
+#define DRAM_CACHE_VERSION	1
+
+#ifndef PLAT_DRAM_CACHE_MAX_SIZE
+#define PLAT_DRAM_CACHE_MAX_SIZE	0x800
+#endif
+
+/* Number of words checked by the pattern test at the bottom of DRAM */
+#define DRAM_CACHE_TEST_WORDS	64
+
+struct dram_cache_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t key;
+	uint32_t len;
+	uint32_t crc;
+};
+
+#define DRAM_CACHE_DATA_SIZE						\
+	(PLAT_DRAM_CACHE_MAX_SIZE - sizeof(struct dram_cache_hdr))
+
+static struct {
+	struct dram_cache_hdr hdr;
+	uint8_t data[DRAM_CACHE_DATA_SIZE];
+} dram_cache;
+
+#pragma weak plat_dram_cache_read
+#pragma weak plat_dram_cache_write
+#pragma weak plat_dram_training_get
+#pragma weak plat_dram_training_set
+
+int plat_dram_cache_read(void *buf __attribute__((unused)),
+			 size_t len __attribute__((unused)))
+{
+	return -ENODEV;
+}
+
+int plat_dram_cache_write(const void *buf __attribute__((unused)),
+			  size_t len __attribute__((unused)))
+{
+	return -ENODEV;
+}
+
+int plat_dram_training_get(void *buf __attribute__((unused)),
+			   size_t max_len __attribute__((unused)),
+			   size_t *len __attribute__((unused)))
+{
+	return -ENODEV;
+}
+
+int plat_dram_training_set(struct dram_config *cfg __attribute__((unused)),
+			   const void *buf __attribute__((unused)),
+			   size_t len __attribute__((unused)))
+{
+	return -ENODEV;
+}
+
+/* Bitwise CRC-32 (IEEE 802.3), BLE has no room for a table */
+static uint32_t dram_cache_crc32(uint32_t crc, const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+	int bit;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *p++;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+
+	return ~crc;
+}
+
+/* Key of the current memory configuration, taken before any training */
+static uint32_t dram_cache_key(uint32_t clk_mode)
+{
+	struct mv_ddr_topology_map *tm = mv_ddr_topology_map_get();
+	uint32_t rev = apn806_rev_id_get();
+	uint32_t key;
+
+	key = dram_cache_crc32(0, tm, sizeof(*tm));
+	key = dram_cache_crc32(key, &rev, sizeof(rev));
+
+	return dram_cache_crc32(key, &clk_mode, sizeof(clk_mode));
+}
+
+static uint32_t dram_cache_pattern(uint32_t i)
+{
+	uint32_t pattern = 0x01010101 << (i & 7);
+
+	return ((i & 1) ? ~pattern : pattern) ^ i;
+}
+
+/* Check that the DRAM holds a few patterns at its base */
+static int dram_cache_test(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < DRAM_CACHE_TEST_WORDS; i++)
+		mmio_write_32(MARVELL_DRAM1_BASE + i * sizeof(uint32_t),
+			      dram_cache_pattern(i));
+
+	for (i = 0; i < DRAM_CACHE_TEST_WORDS; i++)
+		if (mmio_read_32(MARVELL_DRAM1_BASE + i * sizeof(uint32_t)) !=
+		    dram_cache_pattern(i))
+			return -EIO;
+
+	return 0;
+}
+
+/*
+ * Initialize the DRAM from the cached training result.
+ * Returns 0 if the DRAM is ready, otherwise a full training is required.
+ */
+static int dram_cache_restore(struct dram_config *cfg, uint32_t key)
+{
+	struct dram_cache_hdr *hdr = &dram_cache.hdr;
+	int ret;
+
+	ret = plat_dram_cache_read(&dram_cache, sizeof(dram_cache));
+	if (ret != 0) {
+		VERBOSE("DRAM cache: not available (%d)\n", ret);
+		return ret;
+	}
+
+	if ((hdr->magic != DRAM_CACHE_MAGIC) ||
+	    (hdr->version != DRAM_CACHE_VERSION) ||
+	    (hdr->len > DRAM_CACHE_DATA_SIZE) ||
+	    (hdr->crc != dram_cache_crc32(0, dram_cache.data, hdr->len))) {
+		NOTICE("DRAM cache: no valid training result, training\n");
+		return -EINVAL;
+	}
+
+	if (hdr->key != key) {
+		NOTICE("DRAM cache: memory configuration changed, training\n");
+		return -ESTALE;
+	}
+
+	ret = plat_dram_training_set(cfg, dram_cache.data, hdr->len);
+	if (ret != 0) {
+		WARN("DRAM cache: failed to restore the training (%d)\n", ret);
+		return ret;
+	}
+
+	ret = dram_cache_test();
+	if (ret != 0) {
+		WARN("DRAM cache: DRAM test failed, training\n");
+		return ret;
+	}
+
+	NOTICE("DRAM cache: training restored\n");
+	return 0;
+}
+
+/* Store the result of a successful full training */
+static void dram_cache_save(uint32_t key)
+{
+	struct dram_cache_hdr *hdr = &dram_cache.hdr;
+	size_t len;
+	int ret;
+
+	ret = plat_dram_training_get(dram_cache.data, sizeof(dram_cache.data),
+				     &len);
+	if (ret != 0) {
+		VERBOSE("DRAM cache: no training result to save (%d)\n", ret);
+		return;
+	}
+
+	if (len > sizeof(dram_cache.data)) {
+		WARN("DRAM cache: training result too large (%zu)\n", len);
+		return;
+	}
+
+	hdr->magic = DRAM_CACHE_MAGIC;
+	hdr->version = DRAM_CACHE_VERSION;
+	hdr->key = key;
+	hdr->len = len;
+	hdr->crc = dram_cache_crc32(0, dram_cache.data, len);
+
+	ret = plat_dram_cache_write(&dram_cache, sizeof(*hdr) + len);
+	if (ret != 0)
+		WARN("DRAM cache: failed to save the training (%d)\n", ret);
+	else
+		NOTICE("DRAM cache: training saved\n");
+}
+
+int ble_dram_cache_init(struct dram_config *cfg, uint32_t clk_mode)
+{
+	uint32_t key = dram_cache_key(clk_mode);
+	int ret;
+
+	/* Skip the training if a valid result was saved on an earlier boot */
+	if (dram_cache_restore(cfg, key) == 0)
+		return 0;
+
+	ret = dram_init(cfg);
+	if (ret == 0)
+		dram_cache_save(key);
+
+	return ret;
+}
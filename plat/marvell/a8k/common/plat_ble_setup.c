@@ -32,9 +32,11 @@
  ***************************************************************************
  */
 
+#include <boot_timeline.h>
 #include <plat_marvell.h>
 #include <plat_config.h>
 #include <plat_def.h>
+#include <plat_dram_cache.h>
 #include <debug.h>
 #include <sys_info.h>
 #include <dram_if.h>
@@ -246,6 +248,17 @@ static void ble_plat_mmap_config(int restore)
 	}
 }
 
+/* Return the CPU/DDR clock mode sampled at reset */
+static uint32_t ble_plat_clk_freq_mode(void)
+{
+	uint32_t reg_val;
+
+	reg_val = mmio_read_32(MVEBU_AP_SAR_REG_BASE(FREQ_MODE_AP_SAR_REG_NUM));
+	reg_val &= SAR_CLOCK_FREQ_MODE_MASK;
+
+	return reg_val >> SAR_CLOCK_FREQ_MODE_OFFSET;
+}
+
 /******************************************************************************
  * Setup Adaptive Voltage Switching - this is required for some platforms
  *****************************************************************************/
@@ -267,10 +280,7 @@ static void ble_plat_avs_config(void)
 
 	case MVEBU_70X0_DEV_ID:
 		/* Only fix AVS for CPU clocks lower than 1600MHz on A70x0 */
-		reg_val = mmio_read_32(MVEBU_AP_SAR_REG_BASE(
-						FREQ_MODE_AP_SAR_REG_NUM));
-		reg_val &= SAR_CLOCK_FREQ_MODE_MASK;
-		reg_val >>= SAR_CLOCK_FREQ_MODE_OFFSET;
+		reg_val = ble_plat_clk_freq_mode();
 		if ((reg_val > CPU_1600_DDR_900_RCLK_900_2) &&
 		    (reg_val < CPU_DDR_RCLK_INVALID))
 			mmio_write_32(AVS_EN_CTRL_REG, AVS_A7K_LOW_CLK_VALUE);
@@ -394,7 +404,13 @@ int ble_plat_setup(int *skip)
 	cfg = (struct dram_config *)plat_get_dram_data();
 
 	/* Kick it in */
+	BOOT_TIMELINE_RECORD(BOOT_TL_BLE_DRAM_INIT_START);
+#if DRAM_TRAINING_CACHE
+	ret = ble_dram_cache_init(cfg, ble_plat_clk_freq_mode());
+#else
 	ret = dram_init(cfg);
+#endif
+	BOOT_TIMELINE_RECORD(BOOT_TL_BLE_DRAM_INIT_END);
 
 	/* Restore the original CCU configuration before exit from BLE */
 	ble_plat_mmap_config(MMAP_RESTORE_SAVED);
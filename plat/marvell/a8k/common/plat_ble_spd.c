@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <plat_marvell.h>
+#include <debug.h>
+#include <a8k_i2c.h>
+
+/*
+ * The first two 128 bytes blocks of a DDR4 SPD page 0 (base configuration and
+ * module parameters) are protected by a CRC-16, stored in their last 2 bytes
+ */
+#define SPD_CRC_BLOCK_SIZE		128
+#define SPD_CRC_BLOCKS			2
+#define SPD_READ_RETRIES		3
+
+static uint16_t spd_crc16(const uint8_t *buf, int len)
+{
+	uint16_t crc = 0;
+	int bit;
+
+	while (len--) {
+		crc ^= (uint16_t)*buf++ << 8;
+		for (bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+	}
+
+	return crc;
+}
+
+/* Return the number of complete SPD blocks in 'spd' with a wrong CRC */
+static int spd_crc_errors(const uint8_t *spd, int len)
+{
+	const uint8_t *blk;
+	int errors = 0;
+
+	if (len > SPD_CRC_BLOCKS * SPD_CRC_BLOCK_SIZE)
+		len = SPD_CRC_BLOCKS * SPD_CRC_BLOCK_SIZE;
+
+	for (blk = spd; blk + SPD_CRC_BLOCK_SIZE <= spd + len;
+	     blk += SPD_CRC_BLOCK_SIZE) {
+		if (spd_crc16(blk, SPD_CRC_BLOCK_SIZE - 2) !=
+		    (blk[SPD_CRC_BLOCK_SIZE - 2] |
+		     (blk[SPD_CRC_BLOCK_SIZE - 1] << 8)))
+			errors++;
+	}
+
+	return errors;
+}
+
+/*
+ * Read 'len' bytes of the currently selected SPD page, and check the CRC of
+ * the base configuration and module parameters blocks it covers. The read is
+ * retried on an I2C error or a CRC mismatch, so that a corrupted transfer does
+ * not end up in the DRAM training. On failure the caller should not use the
+ * data, which is that of the last read.
+ */
+int marvell_spd_read(uint8_t chip, int alen, uint8_t *spd, int len)
+{
+	int retry;
+
+	for (retry = 0; retry < SPD_READ_RETRIES; retry++) {
+		if (i2c_read(chip, 0x0, alen, spd, len))
+			continue;
+		if (spd_crc_errors(spd, len) == 0)
+			return 0;
+	}
+
+	WARN("SPD read failed after %d attempts\n", SPD_READ_RETRIES);
+	return -1;
+}
@@ -44,17 +44,17 @@
 #include <plat_pm_trace.h>
 #endif
 
-#define MVEBU_PRIVATE_UID_REG		0x30
 #define MVEBU_RFU_GLOBL_SW_RST		0x84
-#define MVEBU_CCU_RVBAR(i)		(MVEBU_REGS_BASE + 0x640 + (i * 4))
-#define MVEBU_CCU_CPU_UN_RESET		(MVEBU_REGS_BASE + 0x650)
 
 #define MPIDR_CPU_GET(mpidr)		((mpidr) & MPIDR_CPU_MASK)
 #define MPIDR_CLUSTER_GET(mpidr)	MPIDR_AFFLVL1_VAL((mpidr))
 
 #ifdef SCP_IMAGE
-/* this lock synchronize AP multiple cores execution with MSS */
-DEFINE_BAKERY_LOCK(pm_sys_lock);
+/*
+ * There is no lock around the MSS IPC: each core only writes to its own IPC
+ * channel and to its own bits in the MSS SISR, which is a write-1-to-set
+ * register. The MSS reads all the pending requests from the SISR at once.
+ */
 /*
  * this lock ensures core flow execution
  * "suspend->suspend finish", and "off-> on finish"
@@ -152,12 +152,6 @@ int a8k_pwr_domain_on(u_register_t mpidr)
 #ifdef SCP_IMAGE
 	unsigned int target = ((mpidr & 0xFF) + (((mpidr >> 8) & 0xFF) * 2));
 
-	/*
-	 * pm system synchronization - used to synchronize
-	 * multiple core access to MSS
-	 */
-	bakery_lock_get(&pm_sys_lock);
-
 	/* trace message */
 	PM_TRACE((TRACE_PWR_DOMAIN_ON | target), plat_my_core_pos());
 
@@ -167,9 +161,6 @@ int a8k_pwr_domain_on(u_register_t mpidr)
 	/* verify command execution before continue to ATF generic code */
 	__asm__ volatile("dsb sy");
 	__asm__ volatile("isb");
-
-	/* pm system synchronization */
-	bakery_lock_release(&pm_sys_lock);
 #else
 	/* proprietary CPU ON exection flow */
 	plat_marvell_cpu_on(mpidr);
@@ -198,12 +189,6 @@ void a8k_pwr_domain_off(const psci_power_state_t *target_state)
 	/* Prevent interrupts from spuriously waking up this cpu */
 	gicv2_cpuif_disable();
 
-	/*
-	 * pm system synchronization - used to synchronize
-	 * multiple core access to MSS
-	 */
-	bakery_lock_get(&pm_sys_lock);
-
 	/*
 	 * pm core flow synchronization - is used to protect
 	 * core execution flow, lock is
@@ -217,8 +202,8 @@ void a8k_pwr_domain_off(const psci_power_state_t *target_state)
 	/* send CPU OFF IPC Message to MSS */
 	mss_pm_ipc_msg_send(idx, target_state);
 
-	/* verify command execution before triggering MSS execution */
-	__asm__ volatile("isb");
+	/* make sure the message is visible to MSS before triggering it */
+	__asm__ volatile("dsb sy");
 
 	/* Trigger IPC message to MSS */
 	mss_pm_ipc_off_msg_trigger(idx);
@@ -226,9 +211,6 @@ void a8k_pwr_domain_off(const psci_power_state_t *target_state)
 	/* verify command execution before return to ATF generic code */
 	__asm__ volatile("dsb sy");
 	__asm__ volatile("isb");
-
-	/* pm system synchronization */
-	bakery_lock_release(&pm_sys_lock);
 #else
 	INFO("a8k_pwr_domain_off is not supported without SCP\n");
 	return;
@@ -247,12 +229,6 @@ void a8k_pwr_domain_suspend(const psci_power_state_t *target_state)
 	/* Prevent interrupts from spuriously waking up this cpu */
 	gicv2_cpuif_disable();
 
-	/*
-	 * pm system synchronization -used to synchronize
-	 * multiple core access to MSS
-	 */
-	bakery_lock_get(&pm_sys_lock);
-
 	/*
 	 * pm core flow synchronization - is used to protect
 	 * core execution flow, lock is
@@ -266,8 +242,8 @@ void a8k_pwr_domain_suspend(const psci_power_state_t *target_state)
 	/* send CPU Suspend IPC Message to MSS */
 	mss_pm_ipc_msg_send(idx, target_state);
 
-	/* verify command execution before triggering MSS execution */
-	__asm__ volatile("isb");
+	/* make sure the message is visible to MSS before triggering it */
+	__asm__ volatile("dsb sy");
 
 	/* Trigger IPC message to MSS */
 	mss_pm_ipc_suspend_msg_trigger(idx);
@@ -275,9 +251,6 @@ void a8k_pwr_domain_suspend(const psci_power_state_t *target_state)
 	/* verify command execution before return to ATF generic code */
 	__asm__ volatile("dsb sy");
 	__asm__ volatile("isb");
-
-	/* pm system synchronization */
-	bakery_lock_release(&pm_sys_lock);
 #else
 	INFO("a8k_pwr_domain_suspend is not supported without SCP\n");
 	return;
@@ -33,85 +33,50 @@
  */
 
 #include <mmio.h>
+#include <platform_def.h>
 #include <platform.h>
 #include <plat_pm_trace.h>
 #include <mss_mem.h>
 
 #ifdef PM_TRACE_ENABLE
 
-/* core trace APIs */
-core_trace_func funcTbl[PLATFORM_CORE_COUNT] = {
-	pm_core_0_trace,
-	pm_core_1_trace,
-	pm_core_2_trace,
-	pm_core_3_trace};
+/*
+ * Position of the next free entry in each core trace queue. Only the owner
+ * core writes its queue, so the position is kept here rather than read back
+ * from MSS SRAM on every trace.
+ */
+static struct pm_trace_pos {
+	unsigned int pos;
+	unsigned int valid;
+} __aligned(CACHE_WRITEBACK_GRANULE) pm_trace_pos[PLATFORM_CORE_COUNT];
 
 /*******************************************************************************
- * pm_core0_trace
- * pm_core1_trace
- * pm_core2_trace
- * pm_core_3trace
+ * pm_trace_add
  *
- * This functions set trace info into core cyclic trace queue in MSS SRAM
+ * This function sets trace info into the core cyclic trace queue in MSS SRAM
  * memory space
  ******************************************************************************/
-void pm_core_0_trace(unsigned int trace)
+void pm_trace_add(unsigned int trace, unsigned int core)
 {
-	unsigned int current_position_core_0 =
-			mmio_read_32(AP_MSS_ATF_CORE_0_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_0_INFO_BASE  +
-		     (current_position_core_0 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_0_INFO_TRACE +
-		     (current_position_core_0 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_0_CTRL_BASE,
-		     ((current_position_core_0 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
-}
+	struct pm_trace_pos *tp;
+	uintptr_t entry;
 
-void pm_core_1_trace(unsigned int trace)
-{
-	unsigned int current_position_core_1 =
-			mmio_read_32(AP_MSS_ATF_CORE_1_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_1_INFO_BASE +
-		     (current_position_core_1 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_1_INFO_TRACE +
-		     (current_position_core_1 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_1_CTRL_BASE,
-		     ((current_position_core_1 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
-}
+	if (core >= PLATFORM_CORE_COUNT)
+		return;
 
-void pm_core_2_trace(unsigned int trace)
-{
-	unsigned int current_position_core_2 =
-			mmio_read_32(AP_MSS_ATF_CORE_2_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_2_INFO_BASE +
-		     (current_position_core_2 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_2_INFO_TRACE +
-		     (current_position_core_2 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_2_CTRL_BASE,
-		     ((current_position_core_2 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
-}
+	tp = &pm_trace_pos[core];
+	if (!tp->valid) {
+		tp->pos = mmio_read_32(AP_MSS_ATF_CORE_CTRL(core)) &
+			  AP_MSS_ATF_TRACE_SIZE_MASK;
+		tp->valid = 1;
+	}
 
-void pm_core_3_trace(unsigned int trace)
-{
-	unsigned int current_position_core_3 =
-			mmio_read_32(AP_MSS_ATF_CORE_3_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_3_INFO_BASE +
-		     (current_position_core_3 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_3_INFO_TRACE +
-		     (current_position_core_3 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_3_CTRL_BASE,
-		     ((current_position_core_3 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
+	entry = AP_MSS_ATF_CORE_INFO(core) +
+		(tp->pos * AP_MSS_ATF_CORE_ENTRY_SIZE);
+	mmio_write_32(entry, mmio_read_32(AP_MSS_TIMER_BASE));
+	mmio_write_32(entry + AP_MSS_ATF_CORE_TRACE_OFFSET, trace);
+
+	tp->pos = (tp->pos + 1) & AP_MSS_ATF_TRACE_SIZE_MASK;
+	mmio_write_32(AP_MSS_ATF_CORE_CTRL(core), tp->pos);
 }
 #endif /* PM_TRACE_ENABLE */
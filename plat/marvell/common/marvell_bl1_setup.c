@@ -33,6 +33,9 @@
  */
 
 #include <console.h>
+#if MBEDTLS_PK_CACHE_ENTRIES
+#include <mbedtls_common.h>
+#endif
 #include <platform_def.h>
 #include <plat_marvell.h>
 #include <sp805.h>
@@ -147,6 +150,10 @@ void bl1_platform_setup(void)
 
 void bl1_plat_prepare_exit(entry_point_info_t *ep_info)
 {
+#if MBEDTLS_PK_CACHE_ENTRIES
+	/* BL2 has been authenticated */
+	mbedtls_pk_cache_print_stats();
+#endif
 #ifdef EL3_PAYLOAD_BASE
 	/*
 	 * Program the EL3 payload's entry point address into the CPUs mailbox
@@ -65,6 +65,9 @@
 #include <arm_def.h>
 #include <bl_common.h>
 #include <console.h>
+#if MBEDTLS_PK_CACHE_ENTRIES
+#include <mbedtls_common.h>
+#endif
 #include <platform_def.h>
 #include <plat_marvell.h>
 #include <string.h>
@@ -184,6 +187,12 @@ void bl2_plat_flush_bl31_params(void)
 {
 	flush_dcache_range((unsigned long)&bl31_params_mem,
 			sizeof(bl2_to_bl31_params_mem_t));
+
+	/* This is the last platform hook, all images have been loaded */
+	marvell_io_print_stats();
+#if MBEDTLS_PK_CACHE_ENTRIES
+	mbedtls_pk_cache_print_stats();
+#endif
 }
 
 /*******************************************************************************
@@ -65,6 +65,7 @@ BL2_SOURCES		+=	drivers/io/io_fip.c					\
 
 BL31_SOURCES		+=	$(MARVELL_PLAT_BASE)/common/marvell_bl31_setup.c	\
 				$(MARVELL_PLAT_BASE)/common/marvell_pm.c		\
+				$(MARVELL_PLAT_BASE)/common/marvell_sip_svc.c		\
 				$(MARVELL_PLAT_BASE)/common/marvell_topology.c		\
 				plat/common/aarch64/platform_mp_stack.S			\
 				plat/common/plat_psci_common.c				\
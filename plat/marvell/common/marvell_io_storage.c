@@ -136,19 +136,64 @@ static const struct plat_io_policy policies[] = {
 	},
 };
 
+/*
+ * Image sources resolved so far. A source is resolved once per boot stage
+ * and then handed out again without going through the policy check, which
+ * opens and closes the image to test that it is there.
+ */
+struct image_source {
+	unsigned int resolved;
+	uintptr_t dev_handle;
+	uintptr_t image_spec;
+};
+
+static struct image_source image_sources[ARRAY_SIZE(policies)];
+
+/* Lookup counters, reported by marvell_io_print_stats() */
+static struct {
+	unsigned int lookups;
+	unsigned int cache_hits;
+	unsigned int fip_reads;
+} io_stats;
+
+/* Set once the stage holds its own reference to the FIP device */
+static unsigned int fip_stage_ref;
+
 
 /* Weak definitions may be overridden in specific ARM standard platform */
 #pragma weak plat_marvell_io_setup
 #pragma weak plat_marvell_get_alt_image_source
 
 
+/*
+ * Take a reference to the FIP device. The first successful call checks the
+ * FIP header and indexes its ToC, and keeps a reference for the rest of the
+ * boot stage. The image loader closes the device after each image, which then
+ * only drops the reference taken for that image, so the FIP is read once.
+ */
+static int marvell_fip_dev_init(void)
+{
+	int result;
+
+	if (!fip_stage_ref) {
+		result = io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID);
+		if (result != 0)
+			return result;
+		io_stats.fip_reads++;
+		fip_stage_ref = 1;
+	}
+
+	return io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID);
+}
+
+
 static int open_fip(const uintptr_t spec)
 {
 	int result;
 	uintptr_t local_image_handle;
 
 	/* See if a Firmware Image Package is available */
-	result = io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID);
+	result = marvell_fip_dev_init();
 	if (result == 0) {
 		result = io_open(fip_dev_handle, spec, &local_image_handle);
 		if (result == 0) {
@@ -223,14 +268,38 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 {
 	int result;
 	const struct plat_io_policy *policy;
+	struct image_source *source;
 
 	assert(image_id < ARRAY_SIZE(policies));
 
+	io_stats.lookups++;
+	source = &image_sources[image_id];
+	if (source->resolved) {
+		/* The caller closes the device after each image */
+		if (source->dev_handle == fip_dev_handle) {
+			result = marvell_fip_dev_init();
+			if (result != 0)
+				return result;
+		}
+		io_stats.cache_hits++;
+		*dev_handle = source->dev_handle;
+		*image_spec = source->image_spec;
+		return 0;
+	}
+
 	policy = &policies[image_id];
 	result = policy->check(policy->image_spec);
 	if (result == 0) {
 		*image_spec = policy->image_spec;
 		*dev_handle = *(policy->dev_handle);
+
+		/*
+		 * Only the FIP and memmap sources of the policy are cached,
+		 * the alternative ones are platform specific
+		 */
+		source->dev_handle = *dev_handle;
+		source->image_spec = *image_spec;
+		source->resolved = 1;
 	} else {
 		VERBOSE("Trying alternative IO\n");
 		result = plat_marvell_get_alt_image_source(image_id, dev_handle,
@@ -240,6 +309,13 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 	return result;
 }
 
+/* Report how many image source lookups were served from the cache */
+void marvell_io_print_stats(void)
+{
+	INFO("IO: %u image source lookups, %u cached, %u FIP header reads\n",
+	     io_stats.lookups, io_stats.cache_hits, io_stats.fip_reads);
+}
+
 /*
  * See if a Firmware Image Package is available,
  * by checking if TOC is valid or not.
@@ -248,7 +324,9 @@ int marvell_io_is_toc_valid(void)
 {
 	int result;
 
-	result = io_dev_init(fip_dev_handle, (uintptr_t)FIP_IMAGE_ID);
+	result = marvell_fip_dev_init();
+	if (result == 0)
+		io_dev_close(fip_dev_handle);
 
 	return result == 0;
 }
@@ -0,0 +1,252 @@
+/*
+ * ***************************************************************************
+ * Copyright (C) 2017 Marvell International Ltd.
+ * ***************************************************************************
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of Marvell nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ***************************************************************************
+ */
+
+#include <arch_helpers.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <runtime_svc.h>
+#include <smcc_helpers.h>
+#include <string.h>
+#include <uuid.h>
+
+/* SiP Service calls common to all the Marvell platforms */
+#define MV_SIP_SVC_CALL_COUNT		0x8200ff00
+#define MV_SIP_SVC_UID			0x8200ff01
+#define MV_SIP_SVC_VERSION		0x8200ff03
+
+#define MV_SIP_SVC_VERSION_MAJOR	0x0
+#define MV_SIP_SVC_VERSION_MINOR	0x1
+
+/* SMC latency benchmark calls, see SMC_BENCHMARK */
+#define MV_SIP_BENCH_NULL		0xc200ff10
+#define MV_SIP_BENCH_CTX_SWITCH		0xc200ff11
+#define MV_SIP_BENCH_GET_STATS		0xc200ff12
+
+#define MV_SIP_BENCH_MAX_LOOPS		1000
+
+#define is_mv_sip_bench_fid(_fid)	(((_fid) >= MV_SIP_BENCH_NULL) && \
+					 ((_fid) <= MV_SIP_BENCH_GET_STATS))
+
+/* The PMF calls are only handled with PMF enabled */
+#if ENABLE_PMF
+#define MV_SIP_NUM_PMF_CALLS		PMF_NUM_SMC_CALLS
+#else
+#define MV_SIP_NUM_PMF_CALLS		0
+#endif
+
+/* The benchmark calls are only handled with SMC_BENCHMARK */
+#if SMC_BENCHMARK
+#define MV_SIP_NUM_BENCH_CALLS		3
+#else
+#define MV_SIP_NUM_BENCH_CALLS		0
+#endif
+
+#define MV_SIP_NUM_CALLS		(3 + MV_SIP_NUM_PMF_CALLS + \
+					 MV_SIP_NUM_BENCH_CALLS)
+
+/* Marvell SiP Service UUID */
+DEFINE_SVC_UUID(mv_sip_svc_uid,
+		0xdf617f51, 0x644e, 0x4a57, 0xa1, 0x3d,
+		0x32, 0x1f, 0x5b, 0x7e, 0x38, 0x72);
+
+#if SMC_BENCHMARK
+/*
+ * Latency of the SMC entry into EL3, from the counter value read by the
+ * caller just before the SMC to the entry into the SiP handler.
+ */
+struct mv_sip_bench_stats {
+	unsigned long long min;
+	unsigned long long max;
+	unsigned long long total;
+	unsigned int count;
+} __aligned(CACHE_WRITEBACK_GRANULE);
+
+static struct mv_sip_bench_stats mv_sip_bench_stats[PLATFORM_CORE_COUNT];
+
+static unsigned long long mv_sip_bench_null(unsigned long long entry_ts,
+					    u_register_t caller_ts)
+{
+	struct mv_sip_bench_stats *stats =
+		&mv_sip_bench_stats[plat_my_core_pos()];
+	unsigned long long ticks = entry_ts - caller_ts;
+
+	/* A counter value from the future is not a valid timestamp */
+	if (caller_ts > entry_ts)
+		return 0;
+
+	if ((stats->count == 0) || (ticks < stats->min))
+		stats->min = ticks;
+	if (ticks > stats->max)
+		stats->max = ticks;
+	stats->total += ticks;
+	stats->count++;
+
+	return ticks;
+}
+
+/*
+ * Save and restore the non-secure EL1 system registers, as done on each world
+ * switch, and return the minimum, average and maximum time of a save/restore
+ * pair. The registers are those of the caller, so restoring them is harmless.
+ */
+static uintptr_t mv_sip_bench_ctx_switch(void *handle, u_register_t loops)
+{
+	unsigned long long start, ticks, min = ~0ULL, max = 0, total = 0;
+	u_register_t i;
+
+	if ((loops == 0) || (loops > MV_SIP_BENCH_MAX_LOOPS))
+		SMC_RET1(handle, SMC_UNK);
+
+	for (i = 0; i < loops; i++) {
+		start = read_cntpct_el0();
+		cm_el1_sysregs_context_save(NON_SECURE);
+		cm_el1_sysregs_context_restore(NON_SECURE);
+		ticks = read_cntpct_el0() - start;
+
+		if (ticks < min)
+			min = ticks;
+		if (ticks > max)
+			max = ticks;
+		total += ticks;
+	}
+
+	SMC_RET4(handle, 0, min, total / loops, max);
+}
+
+/* Return and reset the SMC entry latency statistics of the calling CPU */
+static uintptr_t mv_sip_bench_get_stats(void *handle)
+{
+	struct mv_sip_bench_stats *stats =
+		&mv_sip_bench_stats[plat_my_core_pos()];
+	struct mv_sip_bench_stats cur = *stats;
+
+	if (cur.count == 0)
+		SMC_RET4(handle, 0, 0, 0, 0);
+
+	memset(stats, 0, sizeof(*stats));
+
+	SMC_RET4(handle, 0, cur.min, cur.total / cur.count, cur.max);
+}
+#endif /* SMC_BENCHMARK */
+
+static int32_t mv_sip_setup(void)
+{
+#if ENABLE_PMF
+	/* Initialize the PMF services exposed through SMCs */
+	if (pmf_setup() != 0)
+		return 1;
+#endif
+	return 0;
+}
+
+/*
+ * This function handles Marvell defined SiP Calls
+ */
+uintptr_t mv_sip_smc_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+#if SMC_BENCHMARK
+	/* Taken first, so that the benchmark calls see the least overhead */
+	unsigned long long entry_ts = read_cntpct_el0();
+#endif
+
+#if ENABLE_PMF
+	/* PMF calls, e.g. to read the boot timeline */
+	if (is_pmf_fid(smc_fid)) {
+		return pmf_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				handle, flags);
+	}
+#endif
+
+#if SMC_BENCHMARK
+	/*
+	 * The benchmark calls work on the non-secure context: a secure caller
+	 * would have its own EL1 registers saved into it.
+	 */
+	if (is_mv_sip_bench_fid(smc_fid) && !is_caller_non_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+#endif
+
+	switch (smc_fid) {
+	case MV_SIP_SVC_CALL_COUNT:
+		/* Return the number of Marvell SiP Service Calls */
+		SMC_RET1(handle, MV_SIP_NUM_CALLS);
+
+	case MV_SIP_SVC_UID:
+		/* Return UID to the caller */
+		SMC_UUID_RET(handle, mv_sip_svc_uid);
+
+	case MV_SIP_SVC_VERSION:
+		/* Return the version of current implementation */
+		SMC_RET2(handle, MV_SIP_SVC_VERSION_MAJOR,
+			 MV_SIP_SVC_VERSION_MINOR);
+
+#if SMC_BENCHMARK
+	case MV_SIP_BENCH_NULL:
+		/* x1: counter value read by the caller just before the SMC */
+		SMC_RET2(handle, 0, mv_sip_bench_null(entry_ts, x1));
+
+	case MV_SIP_BENCH_CTX_SWITCH:
+		/* x1: number of save/restore pairs to time */
+		return mv_sip_bench_ctx_switch(handle, x1);
+
+	case MV_SIP_BENCH_GET_STATS:
+		return mv_sip_bench_get_stats(handle);
+#endif
+
+	default:
+		WARN("Unimplemented Marvell SiP Service Call: 0x%x\n", smc_fid);
+		SMC_RET1(handle, SMC_UNK);
+	}
+}
+
+/* Define a runtime service descriptor for fast SMC calls */
+DECLARE_RT_SVC(
+	mv_sip_svc,
+	OEN_SIP_START,
+	OEN_SIP_END,
+	SMC_TYPE_FAST,
+	mv_sip_setup,
+	mv_sip_smc_handler
+);
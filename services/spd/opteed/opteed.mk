@@ -37,3 +37,10 @@ SPD_SOURCES		:=	services/spd/opteed/opteed_common.c	\
 				services/spd/opteed/opteed_pm.c
 
 NEED_BL32		:=	yes
+
+# Flag used to switch only the EL1 system registers that an AArch64 OPTEE can
+# modify on every world switch, instead of the complete EL1 context.
+OPTEED_LAZY_EL1_CTX	:=	0
+
+$(eval $(call assert_boolean,OPTEED_LAZY_EL1_CTX))
+$(eval $(call add_define,OPTEED_LAZY_EL1_CTX))
@@ -154,6 +154,18 @@ int32_t opteed_setup(void)
 				optee_ep_info->pc,
 				&opteed_sp_context[linear_id]);
 
+#if OPTEED_LAZY_EL1_CTX
+	/*
+	 * An AArch64 OPTEE cannot access the AArch32 banked registers and does
+	 * not use the IMPLEMENTATION DEFINED auxiliary fault status registers,
+	 * so they can be left alone on world switches.
+	 */
+	if (opteed_rw == OPTEE_AARCH64)
+		cm_set_el1_sysregs_switch_mask(CTX_EL1_GRP_ALL &
+					       ~(CTX_EL1_GRP_AARCH32 |
+						 CTX_EL1_GRP_AFSR));
+#endif
+
 	/*
 	 * All OPTEED initialization done. Now register our init function with
 	 * BL31 for deferred invocation
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host side decoder of the boot timeline recorded when the firmware is built
+ * with ENABLE_BOOT_TIMELINE=1. It accepts either a raw dump of the timeline
+ * memory region or a text file with one "<tid> <timestamp>" pair per line, as
+ * returned by the PMF_SMC_GET_TIMESTAMP calls, and prints a waterfall of the
+ * boot stages.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "boot_timeline.h"
+
+#define BAR_WIDTH	40
+#define MAX_SPANS	(16 + BOOT_TL_MAX_IMAGES * 2)
+
+typedef struct span {
+	const char *name;
+	const char *image;
+	uint64_t start;
+	uint64_t end;
+} span_t;
+
+static const struct {
+	const char *name;
+	unsigned int start;
+	unsigned int end;
+} stage_spans[] = {
+	{ "BLE",		BOOT_TL_BLE_ENTRY,	BOOT_TL_BLE_EXIT },
+	{ "  DRAM init",	BOOT_TL_BLE_DRAM_INIT_START,
+				BOOT_TL_BLE_DRAM_INIT_END },
+	{ "BL1",		BOOT_TL_BL1_ENTRY,	BOOT_TL_BL1_EXIT },
+	{ "BL2",		BOOT_TL_BL2_ENTRY,	BOOT_TL_BL2_EXIT },
+	{ "  load images",	BOOT_TL_BL2_LOAD_IMAGES_START,
+				BOOT_TL_BL2_LOAD_IMAGES_END },
+	{ "BL31",		BOOT_TL_BL31_ENTRY,	BOOT_TL_BL31_EXIT },
+	{ "  runtime services",	BOOT_TL_BL31_RT_SVC_INIT_START,
+				BOOT_TL_BL31_RT_SVC_INIT_END },
+	{ "  CP0 init",		BOOT_TL_BL31_CP0_INIT_START,
+				BOOT_TL_BL31_CP0_INIT_END },
+	{ "  CP1 init",		BOOT_TL_BL31_CP1_INIT_START,
+				BOOT_TL_BL31_CP1_INIT_END },
+};
+
+/* Image names, indexed by the image IDs in tbbr_img_def.h */
+static const char *image_names[BOOT_TL_MAX_IMAGES] = {
+	"FIP", "BL2", "SCP_BL2", "BL31", "BL32", "BL33",
+	"TB_FW cert", "trusted key cert", "SCP_FW key cert",
+	"SOC_FW key cert", "TOS_FW key cert", "NT_FW key cert",
+	"SCP_FW content cert", "SOC_FW content cert",
+	"TOS_FW content cert", "NT_FW content cert",
+	"NS_BL1U", "FWU cert", "SCP_BL2U", "BL2U", "NS_BL2U",
+};
+
+static uint64_t ts[BOOT_TL_NUM_EVENTS];
+static uint64_t cntfrq;
+
+static void usage(void)
+{
+	printf("usage: boot_timeline [-f <counter frequency>] <file>\n\n"
+	       "<file> is either a raw dump of the boot timeline memory or\n"
+	       "a list of \"<tid> <timestamp>\" lines read through PMF.\n");
+	exit(1);
+}
+
+static int read_dump(const unsigned char *buf, size_t len)
+{
+	boot_timeline_t tl;
+	unsigned int num;
+
+	if (len < sizeof(tl))
+		return -1;
+	memcpy(&tl, buf, sizeof(tl));
+	if (tl.magic != BOOT_TIMELINE_MAGIC)
+		return -1;
+
+	num = tl.num_events;
+	if (num > BOOT_TL_NUM_EVENTS)
+		num = BOOT_TL_NUM_EVENTS;
+	memcpy(ts, tl.ts, num * sizeof(ts[0]));
+	if (cntfrq == 0)
+		cntfrq = tl.cntfrq;
+	return 0;
+}
+
+static int read_text(char *buf)
+{
+	char *line, *end;
+	unsigned long long tid, val;
+	unsigned int nr = 0;
+
+	for (line = strtok(buf, "\n"); line != NULL;
+	     line = strtok(NULL, "\n")) {
+		errno = 0;
+		tid = strtoull(line, &end, 0);
+		if (end == line)
+			continue;
+		line = end;
+		val = strtoull(line, &end, 0);
+		if ((end == line) || (errno != 0))
+			continue;
+
+		/* Keep the local timestamp identifier of full PMF tids */
+		tid &= 0xff;
+		if (tid < BOOT_TL_NUM_EVENTS) {
+			ts[tid] = val;
+			nr++;
+		}
+	}
+
+	return (nr != 0) ? 0 : -1;
+}
+
+static int span_cmp(const void *a, const void *b)
+{
+	const span_t *sa = a, *sb = b;
+
+	if (sa->start != sb->start)
+		return (sa->start < sb->start) ? -1 : 1;
+	/* Enclosing spans first */
+	return (sa->end > sb->end) ? -1 : (sa->end < sb->end);
+}
+
+static unsigned long long to_us(uint64_t ticks)
+{
+	return (unsigned long long)(ticks * 1000000.0 / cntfrq);
+}
+
+static void print_bar(uint64_t first, uint64_t total, const span_t *s)
+{
+	unsigned int from, to, i;
+
+	from = (s->start - first) * BAR_WIDTH / total;
+	to = ((s->end ? s->end : s->start) - first) * BAR_WIDTH / total;
+	if (to == from)
+		to++;
+
+	putchar('|');
+	for (i = 0; i < BAR_WIDTH; i++)
+		putchar((i >= from && i < to) ? '#' : ' ');
+	putchar('|');
+}
+
+int main(int argc, char *argv[])
+{
+	span_t spans[MAX_SPANS];
+	unsigned int nr_spans = 0, i, id;
+	uint64_t first = UINT64_MAX, last = 0, total;
+	unsigned char *buf;
+	size_t len;
+	FILE *fp;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			cntfrq = strtoull(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+	if (optind + 1 != argc)
+		usage();
+
+	fp = fopen(argv[optind], "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Cannot open %s: %s\n", argv[optind],
+			strerror(errno));
+		return 1;
+	}
+	fseek(fp, 0, SEEK_END);
+	len = ftell(fp);
+	rewind(fp);
+	buf = malloc(len + 1);
+	if ((buf == NULL) || (fread(buf, 1, len, fp) != len)) {
+		fprintf(stderr, "Cannot read %s\n", argv[optind]);
+		return 1;
+	}
+	buf[len] = '\0';
+	fclose(fp);
+
+	if ((read_dump(buf, len) != 0) && (read_text((char *)buf) != 0)) {
+		fprintf(stderr, "%s is not a boot timeline\n", argv[optind]);
+		return 1;
+	}
+	free(buf);
+
+	if (cntfrq == 0) {
+		fprintf(stderr, "Unknown counter frequency, use -f\n");
+		return 1;
+	}
+
+	for (i = 0; i < sizeof(stage_spans) / sizeof(stage_spans[0]); i++) {
+		if (ts[stage_spans[i].start] == 0)
+			continue;
+		spans[nr_spans].name = stage_spans[i].name;
+		spans[nr_spans].image = NULL;
+		spans[nr_spans].start = ts[stage_spans[i].start];
+		spans[nr_spans].end = ts[stage_spans[i].end];
+		nr_spans++;
+	}
+
+	for (id = 0; id < BOOT_TL_MAX_IMAGES; id++) {
+		static const char * const ops[] = { "  load ", "  auth " };
+		unsigned int op;
+
+		for (op = 0; op < 2; op++) {
+			unsigned int ev = BOOT_TL_IMG_EVENT(id, op * 2);
+
+			if (ts[ev] == 0)
+				continue;
+			spans[nr_spans].name = ops[op];
+			spans[nr_spans].image = image_names[id];
+			spans[nr_spans].start = ts[ev];
+			spans[nr_spans].end = ts[ev + 1];
+			nr_spans++;
+		}
+	}
+
+	for (i = 0; i < BOOT_TL_NUM_EVENTS; i++) {
+		if (ts[i] == 0)
+			continue;
+		if (ts[i] < first)
+			first = ts[i];
+		if (ts[i] > last)
+			last = ts[i];
+	}
+	if (nr_spans == 0) {
+		fprintf(stderr, "No boot stage recorded\n");
+		return 1;
+	}
+	total = (last > first) ? last - first : 1;
+
+	qsort(spans, nr_spans, sizeof(spans[0]), span_cmp);
+
+	printf("Boot timeline, %llu us from the first to the last event\n\n",
+	       to_us(last - first));
+	printf("%10s %10s  %s\n", "start(us)", "time(us)", "stage");
+	for (i = 0; i < nr_spans; i++) {
+		char name[64];
+
+		snprintf(name, sizeof(name), "%s%s", spans[i].name,
+			 spans[i].image ? spans[i].image : "");
+		printf("%10llu ", to_us(spans[i].start - first));
+		if (spans[i].end >= spans[i].start)
+			printf("%10llu  ", to_us(spans[i].end - spans[i].start));
+		else
+			printf("%10s  ", "-");
+		printf("%-28s ", name);
+		print_bar(first, total, &spans[i]);
+		putchar('\n');
+	}
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Validates the address decoding map of a board with
+ * drivers/marvell/addr_map.c and prints it. Built once per a8k board, with
+ * the board marvell_plat_config.c and plat_def.h.
+ */
+
+#include <stdio.h>
+#include <plat_def.h>
+#include <plat_config.h>
+#include <addr_map.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define PRINT_WIN(_unit, _n, _base, _size, _tid)			\
+	printf("  %-6s %2u  0x%010llx-0x%010llx  0x%010llx  0x%02x\n",	\
+	       _unit, _n, (unsigned long long)(_base),			\
+	       (unsigned long long)((_base) + (_size) - 1),		\
+	       (unsigned long long)(_size), (unsigned int)(_tid))
+
+#define WIN_BASE(_win)	(((uint64_t)(_win)->base_addr_high << 32) +	\
+			 (_win)->base_addr_low)
+#define WIN_SIZE(_win)	(((uint64_t)(_win)->win_size_high << 32) +	\
+			 (_win)->win_size_low)
+
+static void print_map(void)
+{
+	struct ccu_win *ccu_win;
+	struct rfu_win *rfu_win;
+	struct iob_win *iob_win;
+	struct amb_win *amb_win;
+	char unit[8];
+	uint32_t count, n;
+	int cp;
+
+	printf("  unit    #  range                       size          target\n");
+
+	marvell_get_ccu_memory_map(&ccu_win, &count);
+	for (n = 0; n < count; n++)
+		PRINT_WIN("CCU", n, WIN_BASE(&ccu_win[n]), WIN_SIZE(&ccu_win[n]),
+			  ccu_win[n].target_id);
+
+	marvell_get_rfu_memory_map(&rfu_win, &count);
+	for (n = 0; n < count; n++)
+		PRINT_WIN("RFU", n, WIN_BASE(&rfu_win[n]), WIN_SIZE(&rfu_win[n]),
+			  rfu_win[n].target_id);
+
+	for (cp = 0; cp < CP_COUNT; cp++) {
+		if (marvell_get_iob_memory_map(&iob_win, &count, cp))
+			continue;
+		snprintf(unit, sizeof(unit), "CP%d", cp);
+		for (n = 0; n < count; n++)
+			PRINT_WIN(unit, n, WIN_BASE(&iob_win[n]),
+				  WIN_SIZE(&iob_win[n]), iob_win[n].target_id);
+	}
+
+	/* The AMB base address is held in 64KB units */
+	marvell_get_amb_memory_map(&amb_win, &count);
+	for (n = 0; n < count; n++)
+		PRINT_WIN("AMB", n, (uint64_t)amb_win[n].base_addr << 16,
+			  amb_win[n].win_size, amb_win[n].attribute);
+}
+
+int main(int argc, char *argv[])
+{
+	/* Any fixup of the board tables is counted as an error */
+	CHECK(addr_map_validate() == 0);
+
+	printf("%s:\n", argv[0]);
+	print_map();
+
+	return test_report(argv[0]);
+}
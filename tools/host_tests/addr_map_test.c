@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the address decoding map validation of
+ * drivers/marvell/addr_map.c, built for the a80x0 (two CPs). The memory map
+ * getters of the board configuration are replaced by tables set up by each
+ * test.
+ */
+
+#include "../../drivers/marvell/addr_map.c"
+
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define MAX_TEST_WIN		32
+#define SZ_1M			0x100000UL
+#define SZ_16M			0x1000000UL
+
+static struct ccu_win ccu_map[MAX_TEST_WIN];
+static uint32_t ccu_count;
+static int ccu_max_win;
+
+static struct rfu_win rfu_map[MAX_TEST_WIN];
+static uint32_t rfu_count;
+
+static struct iob_win iob_map[CP_COUNT][MAX_TEST_WIN];
+static uint32_t iob_count[CP_COUNT];
+static int iob_present[CP_COUNT];
+static int iob_max_win;
+
+static struct amb_win amb_map[MAX_TEST_WIN];
+static uint32_t amb_count;
+
+int marvell_get_ccu_max_win(void)
+{
+	return ccu_max_win;
+}
+
+int marvell_get_ccu_memory_map(struct ccu_win **win, uint32_t *size)
+{
+	*win = ccu_map;
+	*size = ccu_count;
+	return 0;
+}
+
+int marvell_get_rfu_memory_map(struct rfu_win **win, uint32_t *size)
+{
+	*win = rfu_map;
+	*size = rfu_count;
+	return 0;
+}
+
+int marvell_get_iob_max_win(void)
+{
+	return iob_max_win;
+}
+
+int marvell_get_iob_memory_map(struct iob_win **win, uint32_t *size,
+			       int cp_index)
+{
+	if (!iob_present[cp_index]) {
+		*win = NULL;
+		*size = 0;
+		return 1;
+	}
+	*win = iob_map[cp_index];
+	*size = iob_count[cp_index];
+	return 0;
+}
+
+int marvell_get_amb_memory_map(struct amb_win **win, uint32_t *size)
+{
+	*win = amb_map;
+	*size = amb_count;
+	return 0;
+}
+
+#define SET_WIN(_win, _base, _size, _tid)				\
+	do {								\
+		(_win)->base_addr_high = (uint32_t)((uint64_t)(_base) >> 32); \
+		(_win)->base_addr_low = (uint32_t)(_base);		\
+		(_win)->win_size_high = (uint32_t)((uint64_t)(_size) >> 32); \
+		(_win)->win_size_low = (uint32_t)(_size);		\
+		(_win)->target_id = (_tid);				\
+	} while (0)
+
+#define WIN_BASE(_win)	(((uint64_t)(_win)->base_addr_high << 32) +	\
+			 (_win)->base_addr_low)
+#define WIN_SIZE(_win)	(((uint64_t)(_win)->win_size_high << 32) +	\
+			 (_win)->win_size_low)
+
+/* A valid map, close to the a80x0 board one */
+static void set_valid_map(void)
+{
+	memset(ccu_map, 0, sizeof(ccu_map));
+	memset(rfu_map, 0, sizeof(rfu_map));
+	memset(iob_map, 0, sizeof(iob_map));
+	memset(amb_map, 0, sizeof(amb_map));
+
+	SET_WIN(&ccu_map[0], 0xf2000000, 0xe000000, IO_0_TID);
+	ccu_count = 1;
+	ccu_max_win = 8;
+
+	SET_WIN(&rfu_map[0], 0xf4000000, 0x2000000, MCI_0_TID);
+	SET_WIN(&rfu_map[1], 0xfa000000, SZ_16M, MCI_0_TID);
+	SET_WIN(&rfu_map[2], MVEBU_MCI_REG_BASE_REMAP(0), SZ_1M, MCI_0_TID);
+	SET_WIN(&rfu_map[3], MVEBU_MCI_REG_BASE_REMAP(1), SZ_1M, MCI_1_TID);
+	rfu_count = 4;
+
+	SET_WIN(&iob_map[0][0], 0xf7000000, SZ_16M, PEX1_TID);
+	SET_WIN(&iob_map[0][1], 0xf8000000, SZ_16M, PEX2_TID);
+	SET_WIN(&iob_map[0][2], 0xf6000000, SZ_16M, PEX0_TID);
+	iob_count[0] = 3;
+	iob_present[0] = 1;
+	SET_WIN(&iob_map[1][0], 0xfb000000, SZ_16M, PEX1_TID);
+	SET_WIN(&iob_map[1][1], 0xfc000000, SZ_16M, PEX2_TID);
+	SET_WIN(&iob_map[1][2], 0xfa000000, SZ_16M, PEX0_TID);
+	iob_count[1] = 3;
+	iob_present[1] = 1;
+	iob_max_win = 16;
+
+	/* Base address in 64KB units */
+	amb_map[0].base_addr = 0xf900;
+	amb_map[0].win_size = 0x200000;
+	amb_map[0].attribute = AMB_SPI0_CS0_ID;
+	amb_count = 1;
+}
+
+static void test_valid(void)
+{
+	struct ccu_win ccu_ref;
+	struct iob_win iob_ref;
+
+	set_valid_map();
+	ccu_ref = ccu_map[0];
+	iob_ref = iob_map[1][2];
+
+	CHECK(addr_map_validate() == 0);
+	/* Nothing is fixed up in a valid map */
+	CHECK(memcmp(&ccu_ref, &ccu_map[0], sizeof(ccu_ref)) == 0);
+	CHECK(memcmp(&iob_ref, &iob_map[1][2], sizeof(iob_ref)) == 0);
+	CHECK(amb_map[0].base_addr == 0xf900);
+	CHECK(amb_map[0].win_size == 0x200000);
+
+	/* Empty maps are valid */
+	ccu_count = rfu_count = amb_count = 0;
+	iob_present[0] = iob_present[1] = 0;
+	CHECK(addr_map_validate() == 0);
+}
+
+static void test_overlap(void)
+{
+	set_valid_map();
+
+	/* Adjacent windows do not overlap */
+	SET_WIN(&ccu_map[1], 0xf2000000UL + 0xe000000, SZ_16M, DRAM_0_TID);
+	ccu_count = 2;
+	CHECK(addr_map_validate() == 0);
+
+	/* Last MB of window 0 */
+	SET_WIN(&ccu_map[1], 0xf2000000UL + 0xe000000 - SZ_1M, SZ_16M,
+		DRAM_0_TID);
+	CHECK(addr_map_validate() == 1);
+
+	/* Window 2 contains window 0 */
+	SET_WIN(&ccu_map[1], 0x100000000UL, SZ_16M, DRAM_0_TID);
+	SET_WIN(&ccu_map[2], 0xf0000000, 0x10000000, DRAM_0_TID);
+	ccu_count = 3;
+	CHECK(addr_map_validate() == 1);
+
+	/* Above 4GB */
+	SET_WIN(&ccu_map[2], 0x100000000UL + SZ_16M - SZ_1M, SZ_1M,
+		DRAM_0_TID);
+	CHECK(addr_map_validate() == 1);
+
+	/* Each overlapping pair is counted */
+	set_valid_map();
+	SET_WIN(&rfu_map[4], 0xf4000000, SZ_1M, MCI_0_TID);
+	SET_WIN(&rfu_map[5], 0xf5000000, 0x6000000, MCI_0_TID);
+	rfu_count = 6;
+	CHECK(addr_map_validate() == 3);
+}
+
+static void test_iob_cp_overlap(void)
+{
+	set_valid_map();
+
+	/* CP1 window at the place of a CP0 one */
+	SET_WIN(&iob_map[1][1], 0xf8000000, SZ_16M, PEX2_TID);
+	CHECK(addr_map_validate() == 1);
+
+	/*
+	 * An overlap within a CP is found by the CP check and again by the
+	 * check of all the CPs
+	 */
+	set_valid_map();
+	SET_WIN(&iob_map[0][1], 0xf7800000, SZ_16M, PEX2_TID);
+	CHECK(addr_map_validate() == 2);
+
+	/* A CP without a memory map is skipped */
+	set_valid_map();
+	SET_WIN(&iob_map[1][1], 0xf8000000, SZ_16M, PEX2_TID);
+	iob_present[1] = 0;
+	CHECK(addr_map_validate() == 0);
+}
+
+static void test_fixup(void)
+{
+	set_valid_map();
+
+	/* Unaligned base, aligned up to 1MB */
+	SET_WIN(&ccu_map[0], 0xf2000800, 0xd000000, IO_0_TID);
+	CHECK(addr_map_validate() == 0);
+	CHECK(WIN_BASE(&ccu_map[0]) == 0xf2100000);
+	CHECK(WIN_SIZE(&ccu_map[0]) == 0xd000000);
+	/* Fixed up with a warning, not an error */
+	CHECK(addr_map_validate() == 0);
+
+	/* Unaligned size, rounded up to 1MB */
+	SET_WIN(&iob_map[0][0], 0xf7000000, 0xff0001, PEX1_TID);
+	CHECK(addr_map_validate() == 0);
+	CHECK(WIN_SIZE(&iob_map[0][0]) == SZ_16M);
+	CHECK(iob_map[0][0].target_id == PEX1_TID);
+
+	/* Alignment carried into the high word */
+	set_valid_map();
+	SET_WIN(&ccu_map[1], 0xfff00001, SZ_1M, DRAM_0_TID);
+	ccu_count = 2;
+	CHECK(addr_map_validate() == 0);
+	CHECK(ccu_map[1].base_addr_high == 1);
+	CHECK(ccu_map[1].base_addr_low == 0);
+
+	/* Empty window */
+	set_valid_map();
+	SET_WIN(&rfu_map[1], 0xfa000000, 0, MCI_0_TID);
+	CHECK(addr_map_validate() == 1);
+
+	/* Window moved by the fixup onto the next one */
+	set_valid_map();
+	SET_WIN(&iob_map[0][2], 0xf6000001, SZ_16M, PEX0_TID);
+	CHECK(addr_map_validate() == 2);
+	CHECK(WIN_BASE(&iob_map[0][2]) == 0xf6100000);
+}
+
+static void test_amb(void)
+{
+	set_valid_map();
+
+	/* The size must be a power of 2 */
+	amb_map[0].win_size = 0x180000;
+	CHECK(addr_map_validate() == 0);
+	CHECK(amb_map[0].win_size == 0x200000);
+	CHECK(amb_map[0].base_addr == 0xf900);
+
+	/* The base, in 64KB units, must be 1MB aligned */
+	amb_map[0].base_addr = 0xf901;
+	CHECK(addr_map_validate() == 0);
+	CHECK(amb_map[0].base_addr == 0xf910);
+	CHECK(amb_map[0].attribute == AMB_SPI0_CS0_ID);
+
+	amb_map[1].base_addr = 0xf920;
+	amb_map[1].win_size = 0x100000;
+	amb_map[1].attribute = AMB_SPI1_CS0_ID;
+	amb_count = 2;
+	CHECK(addr_map_validate() == 1);
+}
+
+static void test_window_count(void)
+{
+	uint32_t n;
+
+	/* The board limit applies when lower than the unit one */
+	set_valid_map();
+	for (n = 0; n < 5; n++)
+		SET_WIN(&ccu_map[n], 0x100000000UL + n * SZ_16M, SZ_16M,
+			DRAM_0_TID);
+	ccu_count = 5;
+	CHECK(addr_map_validate() == 0);
+	ccu_max_win = 4;
+	CHECK(addr_map_validate() == 1);
+	/* and is ignored when higher */
+	for (n = 5; n < CCU_MAX_WIN_NUM + 1; n++)
+		SET_WIN(&ccu_map[n], 0x100000000UL + n * SZ_16M, SZ_16M,
+			DRAM_0_TID);
+	ccu_count = CCU_MAX_WIN_NUM;
+	ccu_max_win = 16;
+	CHECK(addr_map_validate() == 0);
+	ccu_count = CCU_MAX_WIN_NUM + 1;
+	CHECK(addr_map_validate() == 1);
+
+	/* RFU window 0 is reserved */
+	set_valid_map();
+	for (n = 0; n < RFU_MAX_WIN_ID; n++)
+		SET_WIN(&rfu_map[n], 0xe0000000 + n * SZ_1M, SZ_1M, MCI_0_TID);
+	rfu_count = RFU_MAX_WIN_ID - 1;
+	CHECK(addr_map_validate() == 0);
+	rfu_count = RFU_MAX_WIN_ID;
+	CHECK(addr_map_validate() == 1);
+
+	/* IOB window 0 is reserved, for each CP */
+	set_valid_map();
+	iob_max_win = 4;
+	SET_WIN(&iob_map[1][3], 0xfd000000, SZ_16M, PEX0_TID);
+	iob_count[1] = 4;
+	CHECK(addr_map_validate() == 1);
+	iob_max_win = 5;
+	CHECK(addr_map_validate() == 0);
+
+	/* AMB */
+	set_valid_map();
+	for (n = 0; n < AMB_MAX_WIN_ID + 1; n++) {
+		amb_map[n].base_addr = 0xe000 + n * 0x10;
+		amb_map[n].win_size = SZ_1M;
+	}
+	amb_count = AMB_MAX_WIN_ID;
+	CHECK(addr_map_validate() == 0);
+	amb_count = AMB_MAX_WIN_ID + 1;
+	CHECK(addr_map_validate() == 1);
+}
+
+static void test_rfu_target(void)
+{
+	set_valid_map();
+	rfu_map[1].target_id = RFU_MAX_TID;
+	CHECK(addr_map_validate() == 1);
+	rfu_map[1].target_id = RFU_MAX_TID - 1;
+	CHECK(addr_map_validate() == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	test_valid();
+	test_overlap();
+	test_iob_cp_overlap();
+	test_fixup();
+	test_amb();
+	test_window_count();
+	test_rfu_target();
+
+	return test_report(argv[0]);
+}
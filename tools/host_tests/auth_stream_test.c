@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the image hash computed while the image is loaded
+ * (ENABLE_STREAMING_HASH). drivers/auth/auth_mod.c runs with crypto_mod.c and
+ * mbedtls_crypto.c over the fake mbed TLS of fake_mbedtls.c. The images are fed
+ * in chunks as load_image() does, and every result is compared with the one
+ * of the two-pass flow, where the whole image is hashed after it is loaded.
+ */
+
+#include <auth_mod.h>
+#include <crypto_mod.h>
+#include <platform.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fake_mbedtls.h"
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define IMAGE_SIZE		(100 * 1024 + 13)
+
+enum { CONTENT_CERT_ID, RAW_IMAGE_ID, OTHER_IMAGE_ID };
+
+/* A certificate holding the DigestInfo of the raw image */
+static unsigned char content_cert[FAKE_DIGEST_INFO_SIZE];
+static unsigned char image_hash_buf[FAKE_DIGEST_INFO_SIZE];
+static unsigned char image[IMAGE_SIZE];
+static unsigned char loaded[IMAGE_SIZE];
+/* Copy of the image at another address */
+static unsigned char moved[IMAGE_SIZE];
+
+static auth_param_type_desc_t raw_data = AUTH_PARAM_TYPE_DESC(
+		AUTH_PARAM_RAW_DATA, 0);
+static auth_param_type_desc_t image_hash = AUTH_PARAM_TYPE_DESC(
+		AUTH_PARAM_HASH, 1);
+
+static const auth_img_desc_t cot[] = {
+	[CONTENT_CERT_ID] = {
+		.img_id = CONTENT_CERT_ID,
+		.img_type = IMG_CERT,
+		.parent = NULL,
+		.authenticated_data = {
+			[0] = {
+				.type_desc = &image_hash,
+				.data = {
+					.ptr = (void *)image_hash_buf,
+					.len = sizeof(image_hash_buf),
+				},
+			},
+		},
+	},
+	[RAW_IMAGE_ID] = {
+		.img_id = RAW_IMAGE_ID,
+		.img_type = IMG_RAW,
+		.parent = &cot[CONTENT_CERT_ID],
+		.img_auth_methods = {
+			[0] = {
+				.type = AUTH_METHOD_HASH,
+				.param.hash = {
+					.data = &raw_data,
+					.hash = &image_hash,
+				},
+			},
+		},
+	},
+	/* Loaded from the same certificate, to interleave the two images */
+	[OTHER_IMAGE_ID] = {
+		.img_id = OTHER_IMAGE_ID,
+		.img_type = IMG_RAW,
+		.parent = &cot[CONTENT_CERT_ID],
+		.img_auth_methods = {
+			[0] = {
+				.type = AUTH_METHOD_HASH,
+				.param.hash = {
+					.data = &raw_data,
+					.hash = &image_hash,
+				},
+			},
+		},
+	},
+};
+REGISTER_COT(cot);
+
+/* Image parser: a certificate is its DigestInfo, raw images are the data */
+void img_parser_init(void)
+{
+}
+
+int img_parser_check_integrity(img_type_t img_type, void *img,
+			       unsigned int img_len)
+{
+	return 0;
+}
+
+int img_parser_get_auth_param(img_type_t img_type,
+			      const auth_param_type_desc_t *type_desc,
+			      void *img, unsigned int img_len,
+			      void **param_ptr, unsigned int *param_len)
+{
+	*param_ptr = img;
+	*param_len = img_len;
+	return 0;
+}
+
+/* The chain of trust used here has no signature nor counter */
+int plat_get_rotpk_info(void *cookie, void **key_ptr, unsigned int *key_len,
+			unsigned int *flags)
+{
+	return 1;
+}
+
+int plat_get_nv_ctr(void *cookie, unsigned int *nv_ctr)
+{
+	return 1;
+}
+
+int plat_set_nv_ctr(void *cookie, unsigned int nv_ctr)
+{
+	return 1;
+}
+
+/* Result of the two-pass flow: hash the whole image once loaded */
+static int two_pass(unsigned int img_id, void *img, unsigned int len)
+{
+	return auth_mod_verify_img(img_id, img, len);
+}
+
+/*
+ * Load @len bytes of the image at @dst in chunks of @chunk bytes, then
+ * authenticate it with @verify_len bytes at @verify_base. Returns the result,
+ * and in @hashed the number of bytes hashed by the crypto library.
+ */
+static int stream_load(unsigned int img_id, unsigned char *dst, size_t len,
+		       size_t chunk, void *verify_base, size_t verify_len,
+		       unsigned long long *hashed)
+{
+	size_t done, n;
+
+	fake_md_bytes = 0;
+	auth_mod_hash_start(img_id);
+	for (done = 0; done < len; done += n) {
+		n = len - done;
+		if (n > chunk)
+			n = chunk;
+		memcpy(dst + done, image + done, n);
+		auth_mod_hash_update(img_id, dst + done, n);
+	}
+	n = auth_mod_verify_img(img_id, verify_base, verify_len);
+	*hashed = fake_md_bytes;
+
+	return n;
+}
+
+/* The streamed result matches the two-pass one and the image is hashed once */
+static void test_chunks(void)
+{
+	static const size_t chunks[] = {
+		1, 7, 4096, 64 * 1024, IMAGE_SIZE,
+	};
+	unsigned long long hashed;
+	unsigned int i;
+	int rc;
+
+	for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+		rc = stream_load(RAW_IMAGE_ID, loaded, IMAGE_SIZE, chunks[i],
+				 loaded, IMAGE_SIZE, &hashed);
+		CHECK(rc == 0);
+		CHECK(rc == two_pass(RAW_IMAGE_ID, loaded, IMAGE_SIZE));
+		CHECK(hashed == IMAGE_SIZE);
+	}
+}
+
+/* A corrupted image is rejected by both flows */
+static void test_corrupted(void)
+{
+	unsigned long long hashed;
+	int rc;
+
+	image[IMAGE_SIZE / 2] ^= 0x10;
+	rc = stream_load(RAW_IMAGE_ID, loaded, IMAGE_SIZE, 4096,
+			 loaded, IMAGE_SIZE, &hashed);
+	CHECK(rc != 0);
+	CHECK((rc != 0) == (two_pass(RAW_IMAGE_ID, loaded, IMAGE_SIZE) != 0));
+	CHECK(hashed == IMAGE_SIZE);
+	image[IMAGE_SIZE / 2] ^= 0x10;
+}
+
+/*
+ * When the chunks do not match the image being verified, the streamed hash is
+ * dropped and the image is hashed again, giving the two-pass result.
+ */
+static void test_fallback(void)
+{
+	unsigned long long hashed;
+	int rc;
+
+	/* Only part of the image was hashed */
+	rc = stream_load(RAW_IMAGE_ID, loaded, IMAGE_SIZE - 100, 4096,
+			 loaded, IMAGE_SIZE, &hashed);
+	CHECK(rc == 0);
+	CHECK(hashed == (IMAGE_SIZE - 100) + IMAGE_SIZE);
+
+	/* The image is verified somewhere else than where it was loaded */
+	rc = stream_load(RAW_IMAGE_ID, loaded, IMAGE_SIZE, 4096,
+			 moved, IMAGE_SIZE, &hashed);
+	CHECK(rc == 0);
+	CHECK(hashed == 2ULL * IMAGE_SIZE);
+
+	/* The chunks are not contiguous */
+	fake_md_bytes = 0;
+	auth_mod_hash_start(RAW_IMAGE_ID);
+	auth_mod_hash_update(RAW_IMAGE_ID, loaded, 4096);
+	auth_mod_hash_update(RAW_IMAGE_ID, loaded + 8192, 4096);
+	CHECK(auth_mod_verify_img(RAW_IMAGE_ID, moved, IMAGE_SIZE) == 0);
+	CHECK(fake_md_bytes == 4096 + IMAGE_SIZE);
+
+	/* The load failed and the hash was dropped */
+	fake_md_bytes = 0;
+	auth_mod_hash_start(RAW_IMAGE_ID);
+	auth_mod_hash_update(RAW_IMAGE_ID, loaded, 4096);
+	auth_mod_hash_abort();
+	CHECK(auth_mod_verify_img(RAW_IMAGE_ID, moved, IMAGE_SIZE) == 0);
+	CHECK(fake_md_bytes == 4096 + IMAGE_SIZE);
+
+	/* Chunks of another image are ignored */
+	memcpy(loaded, image, IMAGE_SIZE);
+	fake_md_bytes = 0;
+	auth_mod_hash_start(RAW_IMAGE_ID);
+	auth_mod_hash_update(OTHER_IMAGE_ID, loaded, IMAGE_SIZE);
+	CHECK(auth_mod_verify_img(OTHER_IMAGE_ID, loaded, IMAGE_SIZE) == 0);
+	CHECK(fake_md_bytes == IMAGE_SIZE);
+	CHECK(auth_mod_verify_img(RAW_IMAGE_ID, loaded, IMAGE_SIZE) == 0);
+	CHECK(fake_md_bytes == 2ULL * IMAGE_SIZE);
+
+	/* Certificates are not streamed */
+	fake_md_bytes = 0;
+	auth_mod_hash_start(CONTENT_CERT_ID);
+	auth_mod_hash_update(CONTENT_CERT_ID, content_cert,
+			     sizeof(content_cert));
+	CHECK(fake_md_bytes == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long long hashed;
+	size_t i;
+
+	srand(1);
+	for (i = 0; i < IMAGE_SIZE; i++)
+		image[i] = rand();
+	memcpy(moved, image, IMAGE_SIZE);
+	fake_digest_info(image, IMAGE_SIZE, content_cert);
+
+	auth_mod_init();
+	if (auth_mod_verify_img(CONTENT_CERT_ID, content_cert,
+				sizeof(content_cert)) != 0) {
+		fprintf(stderr, "Failed to verify the certificate\n");
+		return 1;
+	}
+
+	test_chunks();
+	test_corrupted();
+	test_fallback();
+
+	/* Bytes read back by the hash check once the image is loaded */
+	auth_mod_hash_start(RAW_IMAGE_ID);
+	auth_mod_hash_update(RAW_IMAGE_ID, loaded, IMAGE_SIZE);
+	fake_md_bytes = 0;
+	CHECK(auth_mod_verify_img(RAW_IMAGE_ID, loaded, IMAGE_SIZE) == 0);
+	hashed = fake_md_bytes;
+	fake_md_bytes = 0;
+	CHECK(two_pass(RAW_IMAGE_ID, loaded, IMAGE_SIZE) == 0);
+	printf("%s: %u byte image read back by the hash check: "
+	       "%llu bytes streaming, %llu bytes two-pass\n",
+	       argv[0], IMAGE_SIZE, hashed, fake_md_bytes);
+	CHECK(hashed == 0);
+
+	return test_report(argv[0]);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host stress test and benchmark of the coherent bakery lock of
+ * lib/locks/bakery/bakery_lock_coherent.c, built for PLATFORM_CORE_COUNT CPUs,
+ * each CPU being a host thread. The lock is built with a word_ prefix, and the
+ * copy of its previous version in bakery_lock_entry.c, which reads the lock
+ * data one CPU entry at a time, with an entry_ prefix.
+ *
+ * The lock expects fully ordered memory, as the coherent memory is on the
+ * target, while host CPUs may reorder a store with a later load. All the
+ * threads are therefore run on a single host CPU, where they can be preempted
+ * at any instruction.
+ */
+
+#include <bakery_lock.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <utils.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+/*
+ * Lock acquisitions per CPU. The tickets keep growing while the lock has
+ * contenders, so a stress run stays within the 15-bit ticket numbers.
+ */
+#define STRESS_ROUNDS		(0x4000 / BAKERY_LOCK_MAX_CPUS)
+#define LATENCY_ROUNDS		100000
+
+void word_bakery_lock_get(bakery_lock_t *bakery);
+void word_bakery_lock_release(bakery_lock_t *bakery);
+void entry_bakery_lock_get(bakery_lock_t *bakery);
+void entry_bakery_lock_release(bakery_lock_t *bakery);
+
+struct bakery_impl {
+	const char *name;
+	void (*get)(bakery_lock_t *bakery);
+	void (*release)(bakery_lock_t *bakery);
+};
+
+static const struct bakery_impl impls[] = {
+	{ "entry scan", entry_bakery_lock_get, entry_bakery_lock_release },
+	{ "word scan", word_bakery_lock_get, word_bakery_lock_release },
+};
+
+static __thread unsigned int my_cpu;
+
+unsigned int plat_my_core_pos(void)
+{
+	return my_cpu;
+}
+
+static bakery_lock_t lock;
+static const struct bakery_impl *impl;
+static pthread_barrier_t start;
+static unsigned int owners;
+static unsigned int overlaps;
+static unsigned long counter;		/* Protected by the lock */
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int lock_is_free(void)
+{
+	unsigned int cpu;
+
+	for (cpu = 0; cpu < BAKERY_LOCK_MAX_CPUS; cpu++)
+		if (lock.lock_data[cpu] != 0)
+			return 0;
+	return 1;
+}
+
+static void *stress_cpu(void *arg)
+{
+	unsigned long val;
+	unsigned int n;
+
+	my_cpu = (uintptr_t)arg;
+	pthread_barrier_wait(&start);
+
+	for (n = 0; n < STRESS_ROUNDS; n++) {
+		impl->get(&lock);
+		if (__sync_add_and_fetch(&owners, 1) != 1)
+			__sync_add_and_fetch(&overlaps, 1);
+
+		val = counter;
+		/* Let the other CPUs contend while the lock is held */
+		if (((n + my_cpu) % 4) == 0)
+			sched_yield();
+		counter = val + 1;
+
+		__sync_sub_and_fetch(&owners, 1);
+		impl->release(&lock);
+	}
+
+	return NULL;
+}
+
+/* All the CPUs take the lock in turn. Returns the time per acquisition */
+static uint64_t stress(void)
+{
+	pthread_t threads[BAKERY_LOCK_MAX_CPUS];
+	uint64_t start_ns;
+	uintptr_t cpu;
+
+	counter = 0;
+	overlaps = 0;
+	pthread_barrier_init(&start, NULL, BAKERY_LOCK_MAX_CPUS + 1);
+	for (cpu = 0; cpu < BAKERY_LOCK_MAX_CPUS; cpu++)
+		if (pthread_create(&threads[cpu], NULL, stress_cpu,
+				   (void *)cpu) != 0) {
+			perror("pthread_create");
+			exit(1);
+		}
+
+	start_ns = now_ns();
+	pthread_barrier_wait(&start);
+	for (cpu = 0; cpu < BAKERY_LOCK_MAX_CPUS; cpu++)
+		pthread_join(threads[cpu], NULL);
+	start_ns = now_ns() - start_ns;
+	pthread_barrier_destroy(&start);
+
+	CHECK(overlaps == 0);
+	CHECK(counter == (unsigned long)STRESS_ROUNDS * BAKERY_LOCK_MAX_CPUS);
+	CHECK(lock_is_free());
+
+	return start_ns / ((uint64_t)STRESS_ROUNDS * BAKERY_LOCK_MAX_CPUS);
+}
+
+/*
+ * Each CPU takes the free lock in turn, from a single thread. Returns the
+ * time per acquisition and release.
+ */
+static uint64_t uncontended(void)
+{
+	uint64_t start_ns;
+	unsigned int n;
+
+	start_ns = now_ns();
+	for (n = 0; n < LATENCY_ROUNDS; n++) {
+		my_cpu = n % BAKERY_LOCK_MAX_CPUS;
+		impl->get(&lock);
+		impl->release(&lock);
+	}
+	start_ns = now_ns() - start_ns;
+	my_cpu = 0;
+
+	CHECK(lock_is_free());
+
+	return start_ns / LATENCY_ROUNDS;
+}
+
+int main(int argc, char *argv[])
+{
+	cpu_set_t cpus;
+	unsigned int i;
+	uint64_t contended_ns, free_ns;
+
+	CPU_ZERO(&cpus);
+	CPU_SET(sched_getcpu(), &cpus);
+	if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+		perror("sched_setaffinity");
+		return 1;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(impls); i++) {
+		impl = &impls[i];
+		free_ns = uncontended();
+		contended_ns = stress();
+		printf("%2d CPUs, %-10s: %4llu ns uncontended, %6llu ns contended\n",
+		       BAKERY_LOCK_MAX_CPUS, impl->name,
+		       (unsigned long long)free_ns,
+		       (unsigned long long)contended_ns);
+	}
+
+	return test_report(argv[0]);
+}
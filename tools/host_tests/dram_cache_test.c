@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the DRAM training cache of
+ * plat/marvell/a8k/common/plat_ble_dram_cache.c, built for the a80x0 platform
+ * definitions. The test is the board: it provides the cache hooks over a model
+ * of the boot device region, of the training result held by the DRAM
+ * controller and PHY, and of the DRAM, which only holds data when the
+ * programmed training matches the memory configuration. Each boot runs the
+ * DRAM initialization of BLE with a fresh controller.
+ */
+
+#include <plat_def.h>
+#include <plat_dram_cache.h>
+#include <apn806_setup.h>
+#include <dram_if.h>
+#include <errno.h>
+#include <mv_ddr_atf_wrapper.h>
+#include <apn806/mv_ddr_apn806_topology.h>
+#include <stdio.h>
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+/* Same default as plat_ble_dram_cache.c */
+#define PLAT_DRAM_CACHE_MAX_SIZE	0x800
+
+#define TRAINING_REGS		64
+#define DRAM_WORDS		64
+
+struct training {
+	uint32_t regs[TRAINING_REGS];
+};
+
+/* Memory configuration */
+static struct mv_ddr_topology_map topology;
+static uint32_t ap_rev, clk_mode;
+/* Change of the DRAM that the SPD does not show, e.g. a reworked board */
+static uint32_t dram_drift;
+
+/* Model of the boot device region reserved for the cache */
+static uint8_t boot_dev[PLAT_DRAM_CACHE_MAX_SIZE];
+static int boot_dev_present;
+static unsigned int boot_dev_writes;
+
+/* Model of the DRAM controller and PHY, and of the DRAM */
+static struct training ctrl;
+static uint32_t dram[DRAM_WORDS];
+static int training_fails;
+static unsigned int boots, trainings, restores;
+
+static struct dram_config dram_cfg;
+
+/* Training result of the current memory configuration */
+static void ideal_training(struct training *t)
+{
+	uint32_t seed = ap_rev * 0x9e3779b9 + clk_mode * 0x85ebca6b +
+			topology.speed_bin * 0xc2b2ae35 + topology.cfg_src +
+			dram_drift * 0x27d4eb2f;
+	unsigned int i;
+
+	for (i = 0; i < TRAINING_REGS; i++) {
+		seed ^= topology.spd_data.all_bytes[i * 8 % sizeof(
+				topology.spd_data.all_bytes)];
+		seed = seed * 1103515245 + 12345;
+		t->regs[i] = seed;
+	}
+}
+
+static int dram_works(void)
+{
+	struct training t;
+
+	ideal_training(&t);
+	return memcmp(&t, &ctrl, sizeof(t)) == 0;
+}
+
+struct mv_ddr_topology_map *mv_ddr_topology_map_get(void)
+{
+	return &topology;
+}
+
+int dram_init(struct dram_config *cfg)
+{
+	CHECK(cfg == &dram_cfg);
+	trainings++;
+	if (training_fails)
+		return -EIO;
+
+	ideal_training(&ctrl);
+	return 0;
+}
+
+int plat_dram_cache_read(void *buf, size_t len)
+{
+	if (!boot_dev_present)
+		return -ENODEV;
+
+	CHECK(len <= sizeof(boot_dev));
+	memcpy(buf, boot_dev, len);
+	return 0;
+}
+
+int plat_dram_cache_write(const void *buf, size_t len)
+{
+	if (!boot_dev_present)
+		return -ENODEV;
+
+	CHECK(len <= sizeof(boot_dev));
+	if (len > sizeof(boot_dev))
+		return -ENOSPC;
+
+	memset(boot_dev, 0xff, sizeof(boot_dev));
+	memcpy(boot_dev, buf, len);
+	boot_dev_writes++;
+	return 0;
+}
+
+int plat_dram_training_get(void *buf, size_t max_len, size_t *len)
+{
+	*len = sizeof(ctrl);
+	if (max_len < sizeof(ctrl))
+		return -ENOSPC;
+
+	memcpy(buf, &ctrl, sizeof(ctrl));
+	return 0;
+}
+
+int plat_dram_training_set(struct dram_config *cfg, const void *buf,
+			   size_t len)
+{
+	CHECK(cfg == &dram_cfg);
+	if (len != sizeof(ctrl))
+		return -EINVAL;
+
+	memcpy(&ctrl, buf, sizeof(ctrl));
+	restores++;
+	return 0;
+}
+
+/* The DRAM at the bottom of the address space, and the AP revision */
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	uintptr_t offset = addr - MARVELL_DRAM1_BASE;
+
+	if (addr == MVEBU_CSS_GWD_CTRL_IIDR2_REG)
+		return ap_rev << GWD_IIDR2_REV_ID_OFFSET;
+
+	CHECK(offset < sizeof(dram) && !(offset & 3));
+	if (offset >= sizeof(dram))
+		return 0;
+
+	/* A DRAM with a wrong training loses bits */
+	return dram_works() ? dram[offset / 4] : dram[offset / 4] & ~0x10;
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	uintptr_t offset = addr - MARVELL_DRAM1_BASE;
+
+	REQUIRE(offset < sizeof(dram) && !(offset & 3));
+
+	dram[offset / 4] = value;
+}
+
+/* Boot with a fresh DRAM controller, return the result of BLE */
+static int boot(void)
+{
+	memset(&ctrl, 0, sizeof(ctrl));
+	memset(dram, 0, sizeof(dram));
+	boots++;
+
+	return ble_dram_cache_init(&dram_cfg, clk_mode);
+}
+
+/* Boot, and check how the DRAM was initialized */
+static void check_boot(unsigned int trained, unsigned int restored,
+		       unsigned int saved)
+{
+	unsigned int t = trainings, r = restores, w = boot_dev_writes;
+
+	CHECK(boot() == 0);
+	CHECK(dram_works());
+	CHECK(trainings - t == trained);
+	/* A restored training is kept unless it failed */
+	CHECK(restores - r == restored);
+	CHECK(boot_dev_writes - w == saved);
+}
+
+static void setup_board(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < sizeof(topology.spd_data.all_bytes); i++)
+		topology.spd_data.all_bytes[i] = (uint8_t)(i * 7);
+	topology.if_act_mask = 0x1;
+	topology.speed_bin = 2400;
+	topology.cfg_src = MV_DDR_CFG_SPD;
+	ap_rev = APN806_REV_ID_A1;
+	clk_mode = 0x5;
+	dram_drift = 0;
+	training_fails = 0;
+	memset(boot_dev, 0xff, sizeof(boot_dev));
+	boot_dev_present = 1;
+}
+
+/* Without the boot device hooks, BLE trains on every boot */
+static void test_no_boot_device(void)
+{
+	setup_board();
+	boot_dev_present = 0;
+
+	check_boot(1, 0, 0);
+	check_boot(1, 0, 0);
+}
+
+/* The first boot trains and saves, the next ones restore */
+static void test_save_restore(void)
+{
+	setup_board();
+
+	check_boot(1, 0, 1);
+	check_boot(0, 1, 0);
+	check_boot(0, 1, 0);
+}
+
+/* Any change of the memory configuration makes BLE train again */
+static void test_config_change(void)
+{
+	setup_board();
+	check_boot(1, 0, 1);
+
+	/* Another DIMM */
+	topology.spd_data.all_bytes[320]++;
+	check_boot(1, 0, 1);
+	check_boot(0, 1, 0);
+
+	/* SPD read failed, the static topology of the board is used */
+	topology.cfg_src = MV_DDR_CFG_DEFAULT;
+	check_boot(1, 0, 1);
+
+	topology.speed_bin = 2133;
+	check_boot(1, 0, 1);
+
+	clk_mode = 0x3;
+	check_boot(1, 0, 1);
+
+	ap_rev = APN806_REV_ID_A0;
+	check_boot(1, 0, 1);
+	check_boot(0, 1, 0);
+}
+
+/* A damaged record is not used, and is replaced */
+static void test_corrupt_record(void)
+{
+	setup_board();
+	check_boot(1, 0, 1);
+
+	/* In the training result */
+	boot_dev[64] ^= 0x1;
+	check_boot(1, 0, 1);
+	check_boot(0, 1, 0);
+
+	/* In the header */
+	boot_dev[0] ^= 0x80;
+	check_boot(1, 0, 1);
+	check_boot(0, 1, 0);
+
+	/* Erased */
+	memset(boot_dev, 0xff, sizeof(boot_dev));
+	check_boot(1, 0, 1);
+}
+
+/* A restored training the DRAM does not work with is trained again */
+static void test_dram_test_failure(void)
+{
+	setup_board();
+	check_boot(1, 0, 1);
+
+	dram_drift = 1;
+	check_boot(1, 1, 1);
+	check_boot(0, 1, 0);
+}
+
+/* A failed training is reported and not saved */
+static void test_training_failure(void)
+{
+	unsigned int w;
+
+	setup_board();
+	training_fails = 1;
+	w = boot_dev_writes;
+	CHECK(boot() != 0);
+	CHECK(boot_dev_writes == w);
+
+	/* A saved result is kept until a training succeeds */
+	training_fails = 0;
+	check_boot(1, 0, 1);
+	topology.spd_data.all_bytes[0]++;
+	training_fails = 1;
+	CHECK(boot() != 0);
+	topology.spd_data.all_bytes[0]--;
+	training_fails = 0;
+	check_boot(0, 1, 0);
+}
+
+int main(int argc, char *argv[])
+{
+	test_no_boot_device();
+	test_save_restore();
+	test_config_change();
+	test_corrupt_record();
+	test_dram_test_failure();
+	test_training_failure();
+
+	printf("%u boots: %u full trainings, %u trainings restored\n",
+	       boots, trainings, restores);
+
+	return test_report(argv[0]);
+}
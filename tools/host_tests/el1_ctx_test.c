@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host check of the EL1 system register groups of
+ * lib/el3_runtime/aarch64/context.S. The AArch64 code cannot run on the host,
+ * so the test reads the source as preprocessed for the build configuration
+ * (CONTEXT_S) and checks that:
+ * - el1_sysregs_context_save_mask() and el1_sysregs_context_restore_mask()
+ *   put each register of the EL1 context in exactly one CTX_EL1_GRP_* group,
+ *   the same one in both functions;
+ * - every slot of the context but the alignment padding is switched;
+ * - the full save and restore pass CTX_EL1_GRP_ALL.
+ * It prints the system register accesses that the OPTEE dispatcher mask of
+ * OPTEED_LAZY_EL1_CTX saves on each SMC round trip.
+ */
+
+#include <context.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define STR(x)			#x
+#define XSTR(x)			STR(x)
+
+#define CTX_SLOTS		(CTX_SYSREGS_END / 8)
+#define CTX_EL1_GROUPS		13
+
+/* Mask set by the OPTEE dispatcher with OPTEED_LAZY_EL1_CTX=1 */
+#define OPTEED_LAZY_MASK	(CTX_EL1_GRP_ALL &			\
+				 ~(CTX_EL1_GRP_AARCH32 | CTX_EL1_GRP_AFSR))
+
+enum {
+	SAVE,
+	RESTORE,
+	FUNCS
+};
+
+static const char * const func_names[FUNCS] = {
+	[SAVE] = "el1_sysregs_context_save_mask",
+	[RESTORE] = "el1_sysregs_context_restore_mask",
+};
+
+#define SLOT_FREE		-1
+#define SLOT_SHARED		-2
+
+static int slot_group[FUNCS][CTX_SLOTS];
+static unsigned int group_regs[FUNCS][CTX_EL1_GROUPS];
+static unsigned int group_slots[FUNCS][CTX_EL1_GROUPS];
+static unsigned int full_mask_calls;
+
+/* Offset of a "[x0, #off]" operand, which may be "(base + off)" */
+static int parse_offset(const char *line)
+{
+	const char *p = strstr(line, "[x0, #");
+	char *end;
+	long off;
+
+	if (p == NULL)
+		return -1;
+	p += strlen("[x0, #");
+	if (*p == '(')
+		p++;
+	off = strtol(p, &end, 0);
+	while (*end == ' ')
+		end++;
+	if (*end == '+')
+		off += strtol(end + 1, &end, 0);
+
+	return (int)off;
+}
+
+static void use_slot(int func, int group, int off)
+{
+	int *slot;
+
+	CHECK(group >= 0);
+	CHECK(off >= 0 && (off % 8) == 0 && off / 8 < CTX_SLOTS);
+	if (group < 0 || off < 0 || (off % 8) != 0 || off / 8 >= CTX_SLOTS)
+		return;
+
+	group_slots[func][group]++;
+	slot = &slot_group[func][off / 8];
+	*slot = (*slot == SLOT_FREE) ? group : SLOT_SHARED;
+}
+
+static void parse_context_s(const char *path)
+{
+	char buf[256], *line;
+	int func = -1, group = -1, off;
+	unsigned int n;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if (f == NULL) {
+		perror(path);
+		exit(1);
+	}
+
+	while (fgets(buf, sizeof(buf), f) != NULL) {
+		line = buf + strspn(buf, " \t");
+		line[strcspn(line, "\n")] = '\0';
+
+		if (strncmp(line, "func ", 5) == 0) {
+			for (func = FUNCS - 1; func >= 0; func--)
+				if (strcmp(line + 5, func_names[func]) == 0)
+					break;
+			group = -1;
+		} else if (strncmp(line, "endfunc ", 8) == 0) {
+			func = -1;
+		} else if (func < 0) {
+			if (strcmp(line, "mov w1, #" XSTR(CTX_EL1_GRP_ALL)) == 0)
+				full_mask_calls++;
+		} else if (sscanf(line, "tbz w1, #%u, 1f", &n) == 1) {
+			CHECK(group < 0);
+			CHECK(n < CTX_EL1_GROUPS);
+			group = (n < CTX_EL1_GROUPS) ? (int)n : -1;
+		} else if (strcmp(line, "1:") == 0) {
+			group = -1;
+		} else if (strncmp(line, "stp ", 4) == 0 ||
+			   strncmp(line, "ldp ", 4) == 0) {
+			off = parse_offset(line);
+			use_slot(func, group, off);
+			use_slot(func, group, off + 8);
+		} else if (strncmp(line, "str ", 4) == 0 ||
+			   strncmp(line, "ldr ", 4) == 0) {
+			use_slot(func, group, parse_offset(line));
+		} else if (strncmp(line, "mrs ", 4) == 0 ||
+			   strncmp(line, "msr ", 4) == 0) {
+			/* Registers are only read by save, written by restore */
+			CHECK(line[2] == ((func == SAVE) ? 's' : 'r'));
+			CHECK(group >= 0);
+			if (group >= 0)
+				group_regs[func][group]++;
+		}
+	}
+
+	fclose(f);
+}
+
+/* The context is padded to 16 bytes before the timer registers and at its end */
+static int is_padding(unsigned int slot)
+{
+	unsigned int next = (slot + 1) * 8;
+
+	return ((slot % 2) == 1) &&
+	       ((next == CTX_TIMER_SYSREGS_OFF) || (next == CTX_SYSREGS_END));
+}
+
+static void test_groups(void)
+{
+	unsigned int slot, group, regs = 0, lazy_regs = 0;
+
+	for (slot = 0; slot < CTX_SLOTS; slot++) {
+		CHECK(slot_group[SAVE][slot] != SLOT_SHARED);
+		CHECK(slot_group[SAVE][slot] == slot_group[RESTORE][slot]);
+		if (slot_group[SAVE][slot] == SLOT_FREE)
+			CHECK(is_padding(slot));
+	}
+
+	for (group = 0; group < CTX_EL1_GROUPS; group++) {
+		/* One slot per register */
+		CHECK(group_regs[SAVE][group] == group_slots[SAVE][group]);
+		CHECK(group_regs[RESTORE][group] ==
+		      group_slots[RESTORE][group]);
+		CHECK(group_regs[SAVE][group] == group_regs[RESTORE][group]);
+		CHECK((CTX_EL1_GRP_ALL & (1 << group)) != 0);
+
+		regs += group_regs[SAVE][group];
+		if (OPTEED_LAZY_MASK & (1 << group))
+			lazy_regs += group_regs[SAVE][group];
+	}
+	CHECK(regs > 0);
+
+	/* el1_sysregs_context_save() and el1_sysregs_context_restore() */
+	CHECK(full_mask_calls == 2);
+
+	/* Each round trip saves and restores the contexts of both worlds */
+	printf("%u EL1 system register accesses per SMC round trip, %u with OPTEED_LAZY_EL1_CTX\n",
+	       4 * regs, 4 * lazy_regs);
+}
+
+int main(int argc, char *argv[])
+{
+	memset(slot_group, SLOT_FREE, sizeof(slot_group));
+	parse_context_s(CONTEXT_S);
+	test_groups();
+
+	return test_report(argv[0]);
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Minimal stand-in for the parts of mbed TLS used by
+ * drivers/auth/mbedtls/mbedtls_crypto.c, so that the bookkeeping around the
+ * library can be tested on the host without the mbed TLS sources. Nothing here
+ * is cryptographically meaningful:
+ *
+ * - the digest is 32 bytes of four FNV-1a lanes, computed incrementally;
+ * - an AlgorithmIdentifier is a single byte, FAKE_ALG_SHA256;
+ * - a DigestInfo is 0x30, FAKE_ALG_SHA256, 0x04 and the digest;
+ * - a public key is any buffer whose first byte is not 0, and a signature is
+ *   the digest of the data with every byte XORed with that first byte.
+ */
+
+#include <mbedtls/oid.h>
+#include <mbedtls_common.h>
+#include <string.h>
+#include "fake_mbedtls.h"
+
+unsigned int fake_pk_parsed;
+unsigned int fake_pk_freed;
+unsigned long long fake_md_bytes;
+
+static const mbedtls_md_info_t sha256_info = {
+	.type = MBEDTLS_MD_SHA256,
+	.size = FAKE_DIGEST_SIZE,
+};
+
+void mbedtls_init(void)
+{
+}
+
+int mbedtls_asn1_get_tag(unsigned char **p, const unsigned char *end,
+			 size_t *len, int tag)
+{
+	if ((*p >= end) || (**p != tag))
+		return -1;
+	(*p)++;
+	*len = end - *p;
+	return 0;
+}
+
+int mbedtls_asn1_get_alg(unsigned char **p, const unsigned char *end,
+			 mbedtls_asn1_buf *alg, mbedtls_asn1_buf *params)
+{
+	if (*p >= end)
+		return -1;
+	alg->tag = 0;
+	alg->p = *p;
+	alg->len = 1;
+	memset(params, 0, sizeof(*params));
+	(*p)++;
+	return 0;
+}
+
+int mbedtls_asn1_get_bitstring_null(unsigned char **p,
+				    const unsigned char *end, size_t *len)
+{
+	*len = end - *p;
+	return 0;
+}
+
+int mbedtls_oid_get_sig_alg(const mbedtls_asn1_buf *oid,
+			    mbedtls_md_type_t *md_alg,
+			    mbedtls_pk_type_t *pk_alg)
+{
+	if (*oid->p != FAKE_ALG_SHA256)
+		return -1;
+	*md_alg = MBEDTLS_MD_SHA256;
+	*pk_alg = MBEDTLS_PK_RSA;
+	return 0;
+}
+
+int mbedtls_oid_get_md_alg(const mbedtls_asn1_buf *oid,
+			   mbedtls_md_type_t *md_alg)
+{
+	if (*oid->p != FAKE_ALG_SHA256)
+		return -1;
+	*md_alg = MBEDTLS_MD_SHA256;
+	return 0;
+}
+
+const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t md_type)
+{
+	return (md_type == MBEDTLS_MD_SHA256) ? &sha256_info : NULL;
+}
+
+unsigned char mbedtls_md_get_size(const mbedtls_md_info_t *md_info)
+{
+	return md_info->size;
+}
+
+void mbedtls_md_init(mbedtls_md_context_t *ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+int mbedtls_md_setup(mbedtls_md_context_t *ctx,
+		     const mbedtls_md_info_t *md_info, int hmac)
+{
+	if ((md_info == NULL) || (hmac != 0))
+		return -1;
+	ctx->md_info = md_info;
+	return 0;
+}
+
+int mbedtls_md_starts(mbedtls_md_context_t *ctx)
+{
+	unsigned int i;
+
+	if (ctx->md_info == NULL)
+		return -1;
+	for (i = 0; i < 4; i++)
+		ctx->lanes[i] = 0xcbf29ce484222325ULL + i;
+	return 0;
+}
+
+int mbedtls_md_update(mbedtls_md_context_t *ctx, const unsigned char *input,
+		      size_t ilen)
+{
+	unsigned int i;
+
+	if (ctx->md_info == NULL)
+		return -1;
+	fake_md_bytes += ilen;
+	while (ilen-- > 0) {
+		for (i = 0; i < 4; i++)
+			ctx->lanes[i] = (ctx->lanes[i] ^ (*input + i)) *
+					0x100000001b3ULL;
+		input++;
+	}
+	return 0;
+}
+
+int mbedtls_md_finish(mbedtls_md_context_t *ctx, unsigned char *output)
+{
+	if (ctx->md_info == NULL)
+		return -1;
+	memcpy(output, ctx->lanes, FAKE_DIGEST_SIZE);
+	return 0;
+}
+
+void mbedtls_md_free(mbedtls_md_context_t *ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+int mbedtls_md(const mbedtls_md_info_t *md_info, const unsigned char *input,
+	       size_t ilen, unsigned char *output)
+{
+	mbedtls_md_context_t ctx;
+	int rc;
+
+	mbedtls_md_init(&ctx);
+	rc = mbedtls_md_setup(&ctx, md_info, 0);
+	if (rc == 0)
+		rc = mbedtls_md_starts(&ctx);
+	if (rc == 0)
+		rc = mbedtls_md_update(&ctx, input, ilen);
+	if (rc == 0)
+		rc = mbedtls_md_finish(&ctx, output);
+	mbedtls_md_free(&ctx);
+	return rc;
+}
+
+void mbedtls_pk_init(mbedtls_pk_context *ctx)
+{
+	ctx->key = 0;
+}
+
+void mbedtls_pk_free(mbedtls_pk_context *ctx)
+{
+	if (ctx->key != 0)
+		fake_pk_freed++;
+	ctx->key = 0;
+}
+
+int mbedtls_pk_parse_subpubkey(unsigned char **p, const unsigned char *end,
+			       mbedtls_pk_context *pk)
+{
+	if ((*p >= end) || (**p == 0))
+		return -1;
+	pk->key = **p;
+	*p = (unsigned char *)end;
+	fake_pk_parsed++;
+	return 0;
+}
+
+int mbedtls_pk_verify_ext(mbedtls_pk_type_t type, const void *options,
+			  mbedtls_pk_context *ctx, mbedtls_md_type_t md_alg,
+			  const unsigned char *hash, size_t hash_len,
+			  const unsigned char *sig, size_t sig_len)
+{
+	size_t i;
+
+	if ((ctx->key == 0) || (sig_len != hash_len))
+		return -1;
+	for (i = 0; i < hash_len; i++) {
+		if (sig[i] != (hash[i] ^ ctx->key))
+			return -1;
+	}
+	return 0;
+}
+
+/* Helpers for the tests */
+
+void fake_digest(const void *data, size_t len, unsigned char *digest)
+{
+	mbedtls_md(&sha256_info, data, len, digest);
+}
+
+size_t fake_digest_info(const void *data, size_t len, unsigned char *out)
+{
+	out[0] = MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE;
+	out[1] = FAKE_ALG_SHA256;
+	out[2] = MBEDTLS_ASN1_OCTET_STRING;
+	fake_digest(data, len, out + 3);
+	return FAKE_DIGEST_INFO_SIZE;
+}
+
+void fake_sign(const unsigned char *key, const void *data, size_t len,
+	       unsigned char *sig)
+{
+	unsigned int i;
+
+	fake_digest(data, len, sig);
+	for (i = 0; i < FAKE_DIGEST_SIZE; i++)
+		sig[i] ^= key[0];
+}
@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the FIP driver over the memmap driver. A FIP is built in memory
+ * and read through the IO layer, counting the reads that reach the backend.
+ * The test is also built with a ToC index smaller than the FIP, in which case
+ * the files that do not fit are looked up by scanning the ToC on the backend.
+ */
+
+#include <firmware_image_package.h>
+#include <io_driver.h>
+#include <io_fip.h>
+#include <io_memmap.h>
+#include <io_storage.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+/* Same default as io_fip.c */
+#ifndef PLAT_FIP_TOC_CACHE_ENTRIES
+#define PLAT_FIP_TOC_CACHE_ENTRIES	20
+#endif
+
+#define FIP_IMAGE_ID		0
+#define OTHER_FIP_IMAGE_ID	1
+#define NUM_FILES		6
+#define FILE_SIZE(_i)		(0x100 + (_i) * 0x40)
+#define FIP_SIZE		0x2000
+
+static unsigned char fip[FIP_SIZE] __attribute__((aligned(16)));
+static unsigned char other_fip[FIP_SIZE] __attribute__((aligned(16)));
+
+static const io_block_spec_t fip_block_spec = {
+	.offset = (uintptr_t)fip,
+	.length = FIP_SIZE,
+};
+
+static const io_block_spec_t other_fip_block_spec = {
+	.offset = (uintptr_t)other_fip,
+	.length = FIP_SIZE,
+};
+
+static const io_uuid_spec_t file_specs[NUM_FILES] = {
+	{ .uuid = UUID_TRUSTED_BOOT_FW_CERT },
+	{ .uuid = UUID_TRUSTED_KEY_CERT },
+	{ .uuid = UUID_SOC_FW_KEY_CERT },
+	{ .uuid = UUID_SOC_FW_CONTENT_CERT },
+	{ .uuid = UUID_EL3_RUNTIME_FIRMWARE_BL31 },
+	{ .uuid = UUID_TRUSTED_BOOT_FIRMWARE_BL2 },
+};
+static const io_uuid_spec_t missing_spec = {
+	.uuid = UUID_NON_TRUSTED_FIRMWARE_BL33,
+};
+
+static uintptr_t memmap_dev_handle;
+static uintptr_t fip_dev_handle;
+
+/* Reads done on the memmap device, i.e. on the FIP backend */
+static unsigned int backend_reads;
+
+int __real_io_read(uintptr_t handle, uintptr_t buffer, size_t length,
+		   size_t *length_read);
+
+int __wrap_io_read(uintptr_t handle, uintptr_t buffer, size_t length,
+		   size_t *length_read)
+{
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	if (entity->dev_handle->funcs->type() == IO_TYPE_MEMMAP)
+		backend_reads++;
+
+	return __real_io_read(handle, buffer, length, length_read);
+}
+
+int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			  uintptr_t *image_spec)
+{
+	if (image_id == FIP_IMAGE_ID)
+		*image_spec = (uintptr_t)&fip_block_spec;
+	else if (image_id == OTHER_FIP_IMAGE_ID)
+		*image_spec = (uintptr_t)&other_fip_block_spec;
+	else
+		return -ENOENT;
+
+	*dev_handle = memmap_dev_handle;
+	return 0;
+}
+
+static unsigned char file_byte(unsigned int file, size_t offset)
+{
+	return (unsigned char)(file * 0x31 + offset);
+}
+
+/* Build a FIP with NUM_FILES files, whose content depends on @serial */
+static void build_fip(uint32_t serial)
+{
+	fip_toc_header_t *header = (fip_toc_header_t *)fip;
+	fip_toc_entry_t *entry = (fip_toc_entry_t *)(header + 1);
+	size_t offset = sizeof(*header) + (NUM_FILES + 1) * sizeof(*entry);
+	unsigned int i;
+	size_t j;
+
+	memset(fip, 0, sizeof(fip));
+	header->name = TOC_HEADER_NAME;
+	header->serial_number = serial;
+
+	for (i = 0; i < NUM_FILES; i++, entry++) {
+		entry->uuid = file_specs[i].uuid;
+		entry->offset_address = offset;
+		entry->size = FILE_SIZE(i);
+		for (j = 0; j < FILE_SIZE(i); j++)
+			fip[offset + j] = file_byte(i + serial, j);
+		offset += FILE_SIZE(i);
+	}
+	/* The ToC end marker is the zeroed entry left here */
+}
+
+static void read_file(unsigned int i, uint32_t serial)
+{
+	static unsigned char buf[FIP_SIZE];
+	uintptr_t handle;
+	size_t size, bytes_read, j;
+	int bad = 0;
+
+	REQUIRE(io_open(fip_dev_handle, (uintptr_t)&file_specs[i],
+			&handle) == 0);
+	CHECK(io_size(handle, &size) == 0);
+	CHECK(size == FILE_SIZE(i));
+	CHECK(io_read(handle, (uintptr_t)buf, size, &bytes_read) == 0);
+	CHECK(bytes_read == size);
+	for (j = 0; j < size; j++)
+		bad |= buf[j] != file_byte(i + serial, j);
+	CHECK(!bad);
+	io_close(handle);
+}
+
+/* Opening and reading each file costs one backend read once indexed */
+static void test_toc_index(void)
+{
+	unsigned int i, reads, total_scan = 0, full_scan = 0;
+
+	build_fip(1);
+
+	backend_reads = 0;
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	/* The header, then the whole ToC */
+	CHECK(backend_reads == 2);
+
+	for (i = 0; i < NUM_FILES; i++) {
+		/* Without an index, each open reads the ToC up to the file */
+		full_scan += i + 1;
+		backend_reads = 0;
+		read_file(i, 1);
+		reads = backend_reads;
+		if (i < PLAT_FIP_TOC_CACHE_ENTRIES) {
+			CHECK(reads == 1);
+		} else {
+			/* ToC entries up to this file, then the payload */
+			CHECK(reads == i + 1 + 1);
+			total_scan += reads - 1;
+		}
+	}
+
+	/* Only a complete index knows that a file is missing */
+	backend_reads = 0;
+	{
+		uintptr_t handle;
+
+		CHECK(io_open(fip_dev_handle, (uintptr_t)&missing_spec,
+			      &handle) == -ENOENT);
+	}
+	if (NUM_FILES < PLAT_FIP_TOC_CACHE_ENTRIES)
+		CHECK(backend_reads == 0);
+	else
+		CHECK(backend_reads == NUM_FILES + 1);
+
+	printf("%u ToC entries indexed: %u ToC reads to open %u files, "
+	       "%u without index\n", PLAT_FIP_TOC_CACHE_ENTRIES,
+	       1 + total_scan, NUM_FILES, full_scan);
+
+	io_dev_close(fip_dev_handle);
+}
+
+/* Closing the device drops the index, a new FIP is seen on the next init */
+static void test_close_invalidates(void)
+{
+	unsigned int i;
+
+	build_fip(1);
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	read_file(0, 1);
+	io_dev_close(fip_dev_handle);
+
+	build_fip(2);
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	for (i = 0; i < NUM_FILES; i++)
+		read_file(i, 2);
+	io_dev_close(fip_dev_handle);
+
+	/* A bad header is rejected */
+	build_fip(1);
+	((fip_toc_header_t *)fip)->name = 0;
+	CHECK(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) != 0);
+	io_dev_close(fip_dev_handle);
+}
+
+/* Several files may be open and read alternately */
+static void test_open_files(void)
+{
+	uintptr_t h0, h1, h2;
+	unsigned char b0[16], b1[16];
+	size_t bytes_read, pos;
+	int bad = 0;
+
+	build_fip(1);
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	REQUIRE(io_open(fip_dev_handle, (uintptr_t)&file_specs[1], &h0) == 0);
+	REQUIRE(io_open(fip_dev_handle, (uintptr_t)&file_specs[4], &h1) == 0);
+	CHECK(io_open(fip_dev_handle, (uintptr_t)&file_specs[2], &h2) ==
+	      -ENOMEM);
+
+	for (pos = 0; pos < FILE_SIZE(1); pos += sizeof(b0)) {
+		CHECK(io_read(h0, (uintptr_t)b0, sizeof(b0), &bytes_read) == 0);
+		CHECK(io_read(h1, (uintptr_t)b1, sizeof(b1), &bytes_read) == 0);
+		bad |= b0[0] != file_byte(1 + 1, pos);
+		bad |= b0[15] != file_byte(1 + 1, pos + 15);
+		bad |= b1[0] != file_byte(4 + 1, pos);
+	}
+	CHECK(!bad);
+
+	/* Re-initialising the device must not pull the FIP under them */
+	CHECK(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	CHECK(io_read(h1, (uintptr_t)b1, sizeof(b1), &bytes_read) == 0);
+	CHECK(b1[0] == file_byte(4 + 1, pos));
+	io_dev_close(fip_dev_handle);
+
+	/* Nor may another package replace it */
+	memcpy(other_fip, fip, sizeof(fip));
+	CHECK(io_dev_init(fip_dev_handle, OTHER_FIP_IMAGE_ID) == -EBUSY);
+	CHECK(io_read(h1, (uintptr_t)b1, sizeof(b1), &bytes_read) == 0);
+	CHECK(b1[0] == file_byte(4 + 1, pos + sizeof(b1)));
+
+	io_close(h0);
+	io_close(h1);
+	io_dev_close(fip_dev_handle);
+}
+
+/* The backend is only held while files are open in the package */
+static void test_backend_release(void)
+{
+	uintptr_t fip_handle, memmap_handle;
+
+	build_fip(1);
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	/* The memmap device only supports one open file */
+	CHECK(io_open(memmap_dev_handle, (uintptr_t)&fip_block_spec,
+		      &memmap_handle) == 0);
+	io_close(memmap_handle);
+
+	REQUIRE(io_open(fip_dev_handle, (uintptr_t)&file_specs[0],
+			&fip_handle) == 0);
+	CHECK(io_open(memmap_dev_handle, (uintptr_t)&fip_block_spec,
+		      &memmap_handle) != 0);
+	io_close(fip_handle);
+
+	CHECK(io_open(memmap_dev_handle, (uintptr_t)&fip_block_spec,
+		      &memmap_handle) == 0);
+	io_close(memmap_handle);
+
+	/* A file cannot be opened while the backend is taken */
+	CHECK(io_open(memmap_dev_handle, (uintptr_t)&fip_block_spec,
+		      &memmap_handle) == 0);
+	CHECK(io_open(fip_dev_handle, (uintptr_t)&file_specs[0],
+		      &fip_handle) == -ENOENT);
+	io_close(memmap_handle);
+	read_file(0, 1);
+
+	io_dev_close(fip_dev_handle);
+
+	/* Without open files, the device can switch to another package */
+	build_fip(1);
+	memcpy(other_fip, fip, sizeof(fip));
+	build_fip(3);
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	REQUIRE(io_dev_init(fip_dev_handle, OTHER_FIP_IMAGE_ID) == 0);
+	read_file(2, 1);
+	io_dev_close(fip_dev_handle);
+}
+
+/*
+ * A user keeping the device initialised, e.g. for a boot stage, saves the
+ * header and ToC reads of the other initialisations
+ */
+static void test_init_refs(void)
+{
+	unsigned int i;
+
+	build_fip(1);
+	backend_reads = 0;
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	CHECK(backend_reads == 2);
+
+	for (i = 0; i < NUM_FILES; i++) {
+		backend_reads = 0;
+		REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+		read_file(i, 1);
+		io_dev_close(fip_dev_handle);
+		if (i < PLAT_FIP_TOC_CACHE_ENTRIES)
+			CHECK(backend_reads == 1);
+	}
+
+	/* The last close drops the index */
+	io_dev_close(fip_dev_handle);
+	build_fip(2);
+	backend_reads = 0;
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	CHECK(backend_reads == 2);
+	read_file(0, 2);
+	io_dev_close(fip_dev_handle);
+}
+
+/* Files can be mapped in place, within their bounds */
+static void test_map(void)
+{
+	fip_toc_entry_t *entry = (fip_toc_entry_t *)(fip +
+						     sizeof(fip_toc_header_t));
+	uintptr_t handle, addr;
+
+	build_fip(1);
+	REQUIRE(io_dev_init(fip_dev_handle, FIP_IMAGE_ID) == 0);
+	REQUIRE(io_open(fip_dev_handle, (uintptr_t)&file_specs[3],
+			&handle) == 0);
+
+	backend_reads = 0;
+	CHECK(io_map(handle, 0x10, &addr) == 0);
+	CHECK(addr == (uintptr_t)fip + entry[3].offset_address);
+	/* The cursor moved past the mapped bytes */
+	CHECK(io_map(handle, 0x10, &addr) == 0);
+	CHECK(addr == (uintptr_t)fip + entry[3].offset_address + 0x10);
+	CHECK(io_map(handle, FILE_SIZE(3), &addr) == -EINVAL);
+	CHECK(io_map(handle, FILE_SIZE(3) - 0x20, &addr) == 0);
+	CHECK(backend_reads == 0);
+
+	io_close(handle);
+	io_dev_close(fip_dev_handle);
+}
+
+int main(int argc, char *argv[])
+{
+	const io_dev_connector_t *memmap_con, *fip_con;
+
+	if ((register_io_dev_memmap(&memmap_con) != 0) ||
+	    (register_io_dev_fip(&fip_con) != 0) ||
+	    (io_dev_open(memmap_con, 0, &memmap_dev_handle) != 0) ||
+	    (io_dev_open(fip_con, 0, &fip_dev_handle) != 0)) {
+		fprintf(stderr, "Failed to set up the IO devices\n");
+		return 1;
+	}
+
+	test_toc_index();
+	test_close_invalidates();
+	test_open_files();
+	test_backend_release();
+	test_init_refs();
+	test_map();
+
+	return test_report(argv[0]);
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Stand-in for the mbed TLS ASN.1 parser used by the host tests. The fake
+ * encoding is described in fake_mbedtls.c.
+ */
+
+#ifndef __FAKE_MBEDTLS_ASN1_H__
+#define __FAKE_MBEDTLS_ASN1_H__
+
+#include <stddef.h>
+
+#define MBEDTLS_ASN1_OCTET_STRING	0x04
+#define MBEDTLS_ASN1_SEQUENCE		0x10
+#define MBEDTLS_ASN1_CONSTRUCTED	0x20
+
+typedef struct mbedtls_asn1_buf {
+	int		tag;
+	size_t		len;
+	unsigned char	*p;
+} mbedtls_asn1_buf;
+
+int mbedtls_asn1_get_tag(unsigned char **p, const unsigned char *end,
+			 size_t *len, int tag);
+int mbedtls_asn1_get_alg(unsigned char **p, const unsigned char *end,
+			 mbedtls_asn1_buf *alg, mbedtls_asn1_buf *params);
+int mbedtls_asn1_get_bitstring_null(unsigned char **p,
+				    const unsigned char *end, size_t *len);
+
+#endif /* __FAKE_MBEDTLS_ASN1_H__ */
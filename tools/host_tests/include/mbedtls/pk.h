@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Stand-in for the mbed TLS public key layer used by the host tests.
+ */
+
+#ifndef __FAKE_MBEDTLS_PK_H__
+#define __FAKE_MBEDTLS_PK_H__
+
+#include <mbedtls/md.h>
+
+typedef enum {
+	MBEDTLS_PK_NONE = 0,
+	MBEDTLS_PK_RSA,
+} mbedtls_pk_type_t;
+
+typedef struct {
+	/* Key byte the fake signatures are masked with, 0 when not parsed */
+	unsigned char	key;
+} mbedtls_pk_context;
+
+void mbedtls_pk_init(mbedtls_pk_context *ctx);
+void mbedtls_pk_free(mbedtls_pk_context *ctx);
+int mbedtls_pk_parse_subpubkey(unsigned char **p, const unsigned char *end,
+			       mbedtls_pk_context *pk);
+int mbedtls_pk_verify_ext(mbedtls_pk_type_t type, const void *options,
+			  mbedtls_pk_context *ctx, mbedtls_md_type_t md_alg,
+			  const unsigned char *hash, size_t hash_len,
+			  const unsigned char *sig, size_t sig_len);
+
+#endif /* __FAKE_MBEDTLS_PK_H__ */
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host version of the APN806 board topology of the mv_ddr library, reduced to
+ * a few of the fields a board fills in. The tests provide
+ * mv_ddr_topology_map_get().
+ */
+
+#ifndef __MV_DDR_APN806_TOPOLOGY_H__
+#define __MV_DDR_APN806_TOPOLOGY_H__
+
+#include <stdint.h>
+
+#define MV_DDR_SPD_DATA_BLOCK_SIZE	512
+
+enum mv_ddr_cfg_src {
+	MV_DDR_CFG_DEFAULT,
+	MV_DDR_CFG_SPD,
+};
+
+union mv_ddr_spd_data {
+	uint8_t all_bytes[MV_DDR_SPD_DATA_BLOCK_SIZE];
+};
+
+struct mv_ddr_topology_map {
+	uint32_t if_act_mask;
+	uint32_t speed_bin;
+	enum mv_ddr_cfg_src cfg_src;
+	union mv_ddr_spd_data spd_data;
+};
+
+struct mv_ddr_topology_map *mv_ddr_topology_map_get(void);
+
+#endif /* __MV_DDR_APN806_TOPOLOGY_H__ */
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the block device driver over a RAM disk. Reads of every
+ * position, length and buffer alignment are checked against the disk content,
+ * and the RAM disk records whether each transfer went to the driver's block
+ * buffer, to the block cache or straight to the caller's buffer. The test is
+ * built with and without MAX_IO_BLOCK_CACHE_LINES.
+ */
+
+#include <io_block.h>
+#include <io_driver.h>
+#include <io_storage.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define BLOCK_SIZE		512
+#define DISK_BLOCKS		64
+#define BOUNCE_BLOCKS		2
+/* The region opened on the device starts at this block */
+#define REGION_BLOCK		4
+#define REGION_SIZE		((DISK_BLOCKS - REGION_BLOCK) * BLOCK_SIZE)
+
+static unsigned char disk[DISK_BLOCKS * BLOCK_SIZE];
+static unsigned char bounce[BOUNCE_BLOCKS * BLOCK_SIZE]
+	__attribute__((aligned(BLOCK_SIZE)));
+#if MAX_IO_BLOCK_CACHE_LINES
+#define CACHE_LINE_BLOCKS	4
+static unsigned char cache[MAX_IO_BLOCK_CACHE_LINES * CACHE_LINE_BLOCKS *
+			   BLOCK_SIZE] __attribute__((aligned(BLOCK_SIZE)));
+#endif
+static unsigned char dst[REGION_SIZE + 2 * BLOCK_SIZE]
+	__attribute__((aligned(BLOCK_SIZE)));
+
+/* Transfers done by the RAM disk, to the block buffer or elsewhere */
+static struct {
+	unsigned int calls;
+	unsigned int direct_calls;
+	unsigned long long bounce_bytes;
+	unsigned long long cache_bytes;
+	unsigned long long direct_bytes;
+} xfers;
+
+static size_t ram_disk_read(int lba, uintptr_t buf, size_t size)
+{
+	/* Block devices transfer whole blocks by DMA */
+	CHECK((size % BLOCK_SIZE) == 0);
+	CHECK((buf % BLOCK_SIZE) == 0);
+	CHECK((lba >= 0) && ((lba * BLOCK_SIZE + size) <= sizeof(disk)));
+
+	xfers.calls++;
+	if ((buf >= (uintptr_t)bounce) &&
+	    (buf < (uintptr_t)bounce + sizeof(bounce))) {
+		CHECK(buf + size <= (uintptr_t)bounce + sizeof(bounce));
+		xfers.bounce_bytes += size;
+#if MAX_IO_BLOCK_CACHE_LINES
+	} else if ((buf >= (uintptr_t)cache) &&
+		   (buf < (uintptr_t)cache + sizeof(cache))) {
+		CHECK(buf + size <= (uintptr_t)cache + sizeof(cache));
+		xfers.cache_bytes += size;
+#endif
+	} else {
+		xfers.direct_calls++;
+		xfers.direct_bytes += size;
+	}
+
+	memcpy((void *)buf, disk + lba * BLOCK_SIZE, size);
+	return size;
+}
+
+static size_t ram_disk_write(int lba, const uintptr_t buf, size_t size)
+{
+	CHECK((size % BLOCK_SIZE) == 0);
+	CHECK((lba >= 0) && ((lba * BLOCK_SIZE + size) <= sizeof(disk)));
+
+	memcpy(disk + lba * BLOCK_SIZE, (void *)buf, size);
+	return size;
+}
+
+static io_block_dev_spec_t dev_spec = {
+	.buffer = {
+		.offset = (uintptr_t)bounce,
+		.length = sizeof(bounce),
+	},
+	.ops = {
+		.read = ram_disk_read,
+		.write = ram_disk_write,
+	},
+	.block_size = BLOCK_SIZE,
+#if MAX_IO_BLOCK_CACHE_LINES
+	.cache = {
+		.offset = (uintptr_t)cache,
+		.length = sizeof(cache),
+	},
+	.cache_line_blocks = CACHE_LINE_BLOCKS,
+#endif
+};
+
+static const io_block_spec_t region_spec = {
+	.offset = REGION_BLOCK * BLOCK_SIZE,
+	.length = REGION_SIZE,
+};
+
+static const io_dev_connector_t *block_con;
+static uintptr_t dev_handle;
+
+static void fill_disk(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(disk); i++)
+		disk[i] = rand();
+}
+
+/* Read @len bytes at @pos of the region into the destination at @misalign */
+static void check_read(size_t pos, size_t len, size_t misalign)
+{
+	uintptr_t handle;
+	size_t bytes_read;
+
+	memset(dst, 0xa5, sizeof(dst));
+
+	REQUIRE(io_open(dev_handle, (uintptr_t)&region_spec, &handle) == 0);
+	if (pos != 0)
+		CHECK(io_seek(handle, IO_SEEK_SET, pos) == 0);
+	CHECK(io_read(handle, (uintptr_t)dst + misalign, len,
+		      &bytes_read) == 0);
+	CHECK(bytes_read == len);
+	io_close(handle);
+
+	CHECK(memcmp(dst + misalign, disk + region_spec.offset + pos,
+		     len) == 0);
+	/* Nothing written around the destination */
+	CHECK((misalign == 0) || (dst[misalign - 1] == 0xa5));
+	CHECK(dst[misalign + len] == 0xa5);
+}
+
+/* Every combination of position, length and alignment returns the data */
+static void test_read_combinations(void)
+{
+	static const size_t lens[] = {
+		1, 17, BLOCK_SIZE - 1, BLOCK_SIZE, BLOCK_SIZE + 1,
+		3 * BLOCK_SIZE, 3 * BLOCK_SIZE + 100, 10 * BLOCK_SIZE - 3,
+	};
+	static const size_t offsets[] = {
+		0, 1, 8, 100, BLOCK_SIZE - 1,
+	};
+	unsigned int l, p, m, b;
+	size_t pos;
+
+	for (b = 0; b < 3; b++)
+	for (p = 0; p < sizeof(offsets) / sizeof(offsets[0]); p++)
+	for (l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+	for (m = 0; m < sizeof(offsets) / sizeof(offsets[0]); m++) {
+		pos = b * BLOCK_SIZE + offsets[p];
+		check_read(pos, lens[l], offsets[m]);
+	}
+
+	/* The whole region at once */
+	check_read(0, REGION_SIZE, 0);
+	check_read(0, REGION_SIZE, 1);
+}
+
+/* Aligned reads go straight to the caller's buffer in one transfer */
+static void test_read_direct(void)
+{
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(BLOCK_SIZE, 20 * BLOCK_SIZE, 0);
+	CHECK(xfers.calls == 1);
+	CHECK(xfers.direct_bytes == 20 * BLOCK_SIZE);
+	CHECK(xfers.bounce_bytes == 0);
+
+#if !MAX_IO_BLOCK_CACHE_LINES
+	/* Only the tail block goes through the block buffer */
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(BLOCK_SIZE, 20 * BLOCK_SIZE + 10, 0);
+	CHECK(xfers.calls == 2);
+	CHECK(xfers.direct_bytes == 20 * BLOCK_SIZE);
+	CHECK(xfers.bounce_bytes == BLOCK_SIZE);
+
+	/* Same offset within a block: head and tail are bounced */
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(BLOCK_SIZE + 100, 20 * BLOCK_SIZE, 100);
+	CHECK(xfers.calls == 3);
+	CHECK(xfers.direct_calls == 1);
+	CHECK(xfers.direct_bytes == 19 * BLOCK_SIZE);
+	CHECK(xfers.bounce_bytes == 2 * BLOCK_SIZE);
+
+	/* Different offsets: everything goes through the block buffer */
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(BLOCK_SIZE + 100, 20 * BLOCK_SIZE, 3);
+	CHECK(xfers.direct_calls == 0);
+	CHECK(xfers.bounce_bytes == 21 * BLOCK_SIZE);
+#endif
+}
+
+#if MAX_IO_BLOCK_CACHE_LINES
+/* Write @len bytes at @pos of the region from the source at @misalign */
+static void check_write(size_t pos, size_t len, size_t misalign)
+{
+	uintptr_t handle;
+	size_t bytes_written, i;
+
+	for (i = 0; i < len; i++)
+		dst[misalign + i] = rand();
+
+	REQUIRE(io_open(dev_handle, (uintptr_t)&region_spec, &handle) == 0);
+	if (pos != 0)
+		CHECK(io_seek(handle, IO_SEEK_SET, pos) == 0);
+	CHECK(io_write(handle, (uintptr_t)dst + misalign, len,
+		       &bytes_written) == 0);
+	CHECK(bytes_written == len);
+	io_close(handle);
+
+	CHECK(memcmp(disk + region_spec.offset + pos, dst + misalign,
+		     len) == 0);
+}
+
+/* The last line printed by the firmware, to check io_block_print_stats() */
+static char printed[128];
+
+void __wrap_tf_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vsnprintf(printed, sizeof(printed), fmt, args);
+	va_end(args);
+	fputs(printed, stdout);
+}
+
+/* Small reads hit the cache, which reads ahead and is written through */
+static void test_cache(void)
+{
+	unsigned int i;
+
+	/* Start from an empty cache */
+	io_dev_close(dev_handle);
+	REQUIRE(io_dev_open(block_con, (uintptr_t)&dev_spec,
+			    &dev_handle) == 0);
+
+	/* A miss reads a whole line ahead, the next reads are hits */
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(0, 16, 8);
+	check_read(100, 16, 0);
+	check_read(3 * BLOCK_SIZE + 10, 16, 0);
+	CHECK(xfers.calls == 1);
+	CHECK(xfers.cache_bytes == CACHE_LINE_BLOCKS * BLOCK_SIZE);
+	io_block_print_stats();
+	CHECK(strcmp(printed, "io_block 0: cache hits 2 misses 1\n") == 0);
+
+	/* Read ahead stops at the end of the region */
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(REGION_SIZE - 10, 10, 0);
+	CHECK(xfers.calls == 1);
+	CHECK(xfers.cache_bytes == BLOCK_SIZE);
+
+	/* Filling the other lines evicts the least recently used one */
+	check_read(0, 16, 0);
+	for (i = 1; i < MAX_IO_BLOCK_CACHE_LINES - 1; i++)
+		check_read(i * CACHE_LINE_BLOCKS * BLOCK_SIZE, 16, 0);
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(i * CACHE_LINE_BLOCKS * BLOCK_SIZE, 16, 0);
+	check_read(0, 16, 0);
+	CHECK(xfers.calls == 1);
+	check_read(REGION_SIZE - 10, 10, 0);
+	CHECK(xfers.calls == 2);
+
+	/* Writes reach the device and the cached copy */
+	check_read(0, 16, 0);
+	check_write(50, 100, 3);
+	check_write(BLOCK_SIZE, BLOCK_SIZE, 0);
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(0, 2 * BLOCK_SIZE + 1, 1);
+	CHECK(xfers.calls == 0);
+}
+#endif
+
+/* Bytes transferred by the device against bytes copied by the CPU */
+static void report_workload(const char *name, size_t pos, size_t len,
+			    size_t misalign)
+{
+	memset(&xfers, 0, sizeof(xfers));
+	check_read(pos, len, misalign);
+	printf("  %-28s %6zu bytes: %6llu transferred, %6llu bounced\n",
+	       name, len, xfers.direct_bytes + xfers.bounce_bytes +
+	       xfers.cache_bytes, xfers.bounce_bytes + xfers.cache_bytes);
+}
+
+int main(int argc, char *argv[])
+{
+	srand(1);
+	fill_disk();
+
+	if ((register_io_dev_block(&block_con) != 0) ||
+	    (io_dev_open(block_con, (uintptr_t)&dev_spec,
+			 &dev_handle) != 0)) {
+		fprintf(stderr, "Failed to set up the block device\n");
+		return 1;
+	}
+
+	test_read_combinations();
+	test_read_direct();
+#if MAX_IO_BLOCK_CACHE_LINES
+	test_cache();
+#endif
+
+	printf("%s: read workloads\n", argv[0]);
+	report_workload("FIP header", 0, 16, 8);
+	report_workload("aligned image", 0, 40 * BLOCK_SIZE + 300, 0);
+	report_workload("image at same offset", 200, 40 * BLOCK_SIZE, 200);
+	report_workload("image at other offset", 200, 40 * BLOCK_SIZE, 0);
+
+	io_dev_close(dev_handle);
+
+	return test_report(argv[0]);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the image source lookup of
+ * plat/marvell/common/marvell_io_storage.c over the FIP and memmap drivers.
+ * The images of a boot stage are loaded the way load_image() does, and the
+ * reads of the FIP header are counted by wrapping io_read().
+ */
+
+#include <firmware_image_package.h>
+#include <io_driver.h>
+#include <io_storage.h>
+#include <stdint.h>
+#include <string.h>
+#include <tbbr_img_def.h>
+
+#define FIP_SIZE		0x2000
+
+static unsigned char fip[FIP_SIZE] __attribute__((aligned(16)));
+
+/* The FIP of the platform is the test one */
+#define PLAT_MARVELL_FIP_BASE		((uintptr_t)fip)
+#define PLAT_MARVELL_FIP_MAX_SIZE	FIP_SIZE
+#include "../../plat/marvell/common/marvell_io_storage.c"
+
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define NUM_IMAGES		4
+#define IMAGE_SIZE(_i)		(0x100 + (_i) * 0x40)
+
+static const unsigned int image_ids[NUM_IMAGES] = {
+	BL2_IMAGE_ID, SCP_BL2_IMAGE_ID, BL31_IMAGE_ID, BL33_IMAGE_ID,
+};
+
+static const uuid_t image_uuids[NUM_IMAGES] = {
+	UUID_TRUSTED_BOOT_FIRMWARE_BL2, UUID_SCP_FIRMWARE_SCP_BL2,
+	UUID_EL3_RUNTIME_FIRMWARE_BL31, UUID_NON_TRUSTED_FIRMWARE_BL33,
+};
+
+/* Reads of the FIP header, and of anything else, on the memmap device */
+static unsigned int header_reads, backend_reads;
+
+int __real_io_read(uintptr_t handle, uintptr_t buffer, size_t length,
+		   size_t *length_read);
+
+int __wrap_io_read(uintptr_t handle, uintptr_t buffer, size_t length,
+		   size_t *length_read)
+{
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	if (entity->dev_handle->funcs->type() == IO_TYPE_MEMMAP) {
+		backend_reads++;
+		if (length == sizeof(fip_toc_header_t))
+			header_reads++;
+	}
+
+	return __real_io_read(handle, buffer, length, length_read);
+}
+
+static unsigned char image_byte(unsigned int image, size_t offset)
+{
+	return (unsigned char)(image * 0x31 + offset);
+}
+
+static void build_fip(void)
+{
+	fip_toc_header_t *header = (fip_toc_header_t *)fip;
+	fip_toc_entry_t *entry = (fip_toc_entry_t *)(header + 1);
+	size_t offset = sizeof(*header) + (NUM_IMAGES + 1) * sizeof(*entry);
+	unsigned int i;
+	size_t j;
+
+	memset(fip, 0, sizeof(fip));
+	header->name = TOC_HEADER_NAME;
+	header->serial_number = 1;
+
+	for (i = 0; i < NUM_IMAGES; i++, entry++) {
+		entry->uuid = image_uuids[i];
+		entry->offset_address = offset;
+		entry->size = IMAGE_SIZE(i);
+		for (j = 0; j < IMAGE_SIZE(i); j++)
+			fip[offset + j] = image_byte(i, j);
+		offset += IMAGE_SIZE(i);
+	}
+}
+
+/* The IO calls of load_image() for image @i */
+static void load_fip_image(unsigned int i)
+{
+	static unsigned char buf[FIP_SIZE];
+	uintptr_t dev_handle, image_spec, handle;
+	size_t size, bytes_read, j;
+	int bad = 0;
+
+	REQUIRE(plat_get_image_source(image_ids[i], &dev_handle,
+				      &image_spec) == 0);
+	CHECK(dev_handle == fip_dev_handle);
+	REQUIRE(io_open(dev_handle, image_spec, &handle) == 0);
+	CHECK(io_size(handle, &size) == 0);
+	CHECK(size == IMAGE_SIZE(i));
+	CHECK(io_read(handle, (uintptr_t)buf, size, &bytes_read) == 0);
+	CHECK(bytes_read == size);
+	for (j = 0; j < size; j++)
+		bad |= buf[j] != image_byte(i, j);
+	CHECK(!bad);
+	io_close(handle);
+	CHECK(io_dev_close(dev_handle) == 0);
+}
+
+/* Without a FIP, nothing is cached and the next lookup reads it again */
+static void test_no_fip(void)
+{
+	uintptr_t dev_handle, image_spec;
+
+	memset(fip, 0, sizeof(fip));
+	header_reads = 0;
+	CHECK(!marvell_io_is_toc_valid());
+	CHECK(plat_get_image_source(BL31_IMAGE_ID, &dev_handle,
+				    &image_spec) == -ENOENT);
+	CHECK(header_reads == 2);
+	CHECK(!fip_stage_ref);
+	CHECK(!image_sources[BL31_IMAGE_ID].resolved);
+}
+
+/* The FIP header and ToC are read once for the whole stage */
+static void test_stage(void)
+{
+	unsigned int i, round;
+
+	build_fip();
+	memset(&io_stats, 0, sizeof(io_stats));
+	header_reads = 0;
+	backend_reads = 0;
+	CHECK(marvell_io_is_toc_valid());
+	/* The header and the whole ToC */
+	CHECK(header_reads == 1);
+	CHECK(backend_reads == 2);
+
+	/* Images loaded twice, e.g. for authentication */
+	for (round = 0; round < 2; round++) {
+		for (i = 0; i < NUM_IMAGES; i++) {
+			backend_reads = 0;
+			load_fip_image(i);
+			/* Only the image */
+			CHECK(backend_reads == 1);
+		}
+	}
+
+	CHECK(header_reads == 1);
+	CHECK(io_stats.fip_reads == 1);
+	/* The FIP driver looks up the FIP itself, resolved without a FIP */
+	CHECK(io_stats.lookups == 1 + 2 * NUM_IMAGES);
+	CHECK(io_stats.cache_hits == 1 + NUM_IMAGES);
+
+	/* The reference of the stage keeps the FIP usable */
+	{
+		uintptr_t handle;
+
+		REQUIRE(io_open(fip_dev_handle, (uintptr_t)&bl31_uuid_spec,
+				&handle) == 0);
+		io_close(handle);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	marvell_io_setup();
+
+	test_no_fip();
+	test_stage();
+
+	return test_report(argv[0]);
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the MCI indirect access engine of drivers/marvell/mci.c. The
+ * driver is built into the test to reach its operation tables, and runs over
+ * a simulated register file: an indirect command completes after a set number
+ * of status reads, and each status read advances the generic counter by 1 us.
+ */
+
+#include "../../drivers/marvell/mci.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define TICKS_PER_US		(COUNTER_FREQUENCY / 1000000)
+#define MAX_LOG			64
+
+/* Indirect commands issued, in order */
+static struct {
+	int unit;
+	uint32_t cmd;
+	uint32_t data;
+} cmd_log[MAX_LOG];
+static unsigned int num_cmds;
+
+static struct {
+	uint32_t data;
+	uint32_t cmd;
+	unsigned int busy_reads;	/* Status reads left before completion */
+} units[MCI_MAX_UNIT_ID];
+
+/* Simulation settings */
+static unsigned int complete_after;	/* Status reads before completion */
+static int never_complete;
+static int no_data_ready;
+static uint32_t read_data;		/* Returned by indirect reads */
+
+static uint64_t now;
+static unsigned long status_reads;
+static unsigned int resets;
+
+uint64_t read_cntpct_el0(void)
+{
+	return now;
+}
+
+void plat_marvell_system_reset(void)
+{
+	resets++;
+}
+
+static int unit_of(uintptr_t addr, uintptr_t *offset)
+{
+	int i;
+
+	for (i = 0; i < MCI_MAX_UNIT_ID; i++) {
+		if ((addr & ~0xfUL) == MVEBU_MCI_REG_BASE_REMAP(i)) {
+			*offset = addr - MVEBU_MCI_REG_BASE_REMAP(i);
+			return i;
+		}
+	}
+	return -1;
+}
+
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	uintptr_t offset;
+	uint32_t status;
+	int i;
+
+	/* APN806 A1 */
+	if (addr == MVEBU_CSS_GWD_CTRL_IIDR2_REG)
+		return APN806_REV_ID_A1 << GWD_IIDR2_REV_ID_OFFSET;
+
+	i = unit_of(addr, &offset);
+	if (i < 0) {
+		CHECK(!"read of an unexpected register");
+		return 0;
+	}
+	if (offset == 0)
+		return units[i].data;
+
+	CHECK(offset == 4);
+	status_reads++;
+	now += TICKS_PER_US;
+	status = units[i].cmd;
+	if (never_complete)
+		return status;
+	if (units[i].busy_reads > 0) {
+		units[i].busy_reads--;
+		return status;
+	}
+	status |= MCI_INDIRECT_CTRL_CMD_DONE;
+	if (((units[i].cmd & 0xf) == MCI_INDIRECT_CTRL_READ_CMD) &&
+	    !no_data_ready)
+		status |= MCI_INDIRECT_CTRL_DATA_READY;
+	return status;
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	uintptr_t offset;
+	int i;
+
+	i = unit_of(addr, &offset);
+	if (i < 0) {
+		CHECK(!"write to an unexpected register");
+		return;
+	}
+	if (offset == 0) {
+		units[i].data = value;
+		return;
+	}
+
+	CHECK(offset == 4);
+	units[i].cmd = value;
+	units[i].busy_reads = complete_after;
+	if ((value & 0xf) == MCI_INDIRECT_CTRL_READ_CMD)
+		units[i].data = read_data;
+	if (num_cmds < MAX_LOG) {
+		cmd_log[num_cmds].unit = i;
+		cmd_log[num_cmds].cmd = value;
+		cmd_log[num_cmds].data = units[i].data;
+	}
+	num_cmds++;
+}
+
+static void reset_sim(void)
+{
+	memset(units, 0, sizeof(units));
+	memset(&mci_cmd_stats, 0, sizeof(mci_cmd_stats));
+	num_cmds = 0;
+	status_reads = 0;
+	complete_after = 0;
+	never_complete = 0;
+	no_data_ready = 0;
+	read_data = 0;
+}
+
+/* The commands issued are those of the table, on the requested unit */
+static void check_log(const struct mci_reg_op *ops, unsigned int num, int unit)
+{
+	unsigned int n;
+
+	REQUIRE(num_cmds == num);
+	for (n = 0; n < num; n++) {
+		CHECK(cmd_log[n].unit == unit);
+		CHECK(cmd_log[n].cmd == ops[n].cmd);
+		CHECK(cmd_log[n].data == ops[n].data);
+	}
+}
+
+/* Polled commands wait for completion, and their latency is recorded */
+static void test_write_ops(void)
+{
+	unsigned int num = ARRAY_SIZE(mci_simultaneous_transactions_ops);
+
+	reset_sim();
+	complete_after = 3;
+	CHECK(mci_enable_simultaneous_transactions(1) == 0);
+	check_log(mci_simultaneous_transactions_ops, num, 1);
+	CHECK(status_reads == 4 * num);
+	/* 4 us per command: the "< 8 us" bucket */
+	CHECK(mci_cmd_stats.hist[3] == num);
+	CHECK(mci_cmd_stats.max_us == 4);
+	CHECK(mci_cmd_stats.timeouts == 0);
+}
+
+/* The 8G link speed sequence retrains the link and is not polled */
+static void test_no_poll(void)
+{
+	reset_sim();
+	mci_link_force_speed_8g(0);
+	check_log(mci_link_speed_8g_ops, ARRAY_SIZE(mci_link_speed_8g_ops), 0);
+	CHECK(status_reads == 0);
+}
+
+/* A command that never completes times out after MCI_CMD_TIMEOUT_US, and the
+ * rest of the table is still applied.
+ */
+static void test_timeout(void)
+{
+	unsigned int num = ARRAY_SIZE(mci_fifo_thresh_a1_ops);
+
+	reset_sim();
+	never_complete = 1;
+	CHECK(mci_axi_set_fifo_thresh_a1(0) == 1);
+	check_log(mci_fifo_thresh_a1_ops, num, 0);
+	CHECK(mci_cmd_stats.timeouts == num);
+	CHECK(status_reads == num * (unsigned long)MCI_CMD_TIMEOUT_US);
+}
+
+/* Read commands also wait for the data to be ready */
+static void test_read(void)
+{
+	reset_sim();
+	read_data = MCI_HB_CTRL_TX_CTRL_PCIE_MODE;
+	complete_after = 2;
+	CHECK(mci_axi_set_pcie_mode(0) == 0);
+	CHECK(num_cmds == 2);
+
+	reset_sim();
+	read_data = 0;
+	CHECK(mci_axi_set_pcie_mode(0) == 1);
+
+	reset_sim();
+	read_data = MCI_HB_CTRL_TX_CTRL_PCIE_MODE;
+	no_data_ready = 1;
+	CHECK(mci_axi_set_pcie_mode(0) == 1);
+	CHECK(mci_cmd_stats.timeouts == 1);
+}
+
+/* A1 initialization, compared with the former 1 ms wait per status read */
+static void test_initialize(const char *name)
+{
+	unsigned int polled;
+
+	reset_sim();
+	complete_after = 5;
+	read_data = MCI_HB_CTRL_TX_CTRL_PCIE_MODE;
+	now = 0;
+	CHECK(mci_initialize(0) == 1);
+	CHECK(mci_cmd_stats.timeouts == 0);
+	CHECK(resets == 0);
+
+	polled = ARRAY_SIZE(mci_simultaneous_transactions_ops) +
+		 ARRAY_SIZE(mci_phy_regs_access_ops) + 2 +
+		 ARRAY_SIZE(mci_fifo_thresh_a1_ops) +
+		 ARRAY_SIZE(mci_fifo_rx_tx_thresh_a1_ops);
+	CHECK(num_cmds == polled);
+	printf("%s: A1 setup: %u commands in %llu us, at least %u us with "
+	       "a 1 ms wait per poll\n", name, num_cmds,
+	       (unsigned long long)(now / TICKS_PER_US), polled * 1000);
+
+	/* The second link only reports its own commands */
+	never_complete = 1;
+	CHECK(mci_initialize(1) == 1);
+	CHECK(mci_cmd_stats.timeouts != 0);
+	never_complete = 0;
+	CHECK(mci_initialize(1) == 1);
+	CHECK(mci_cmd_stats.timeouts == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	test_write_ops();
+	test_no_poll();
+	test_timeout();
+	test_read();
+	test_initialize(argv[0]);
+
+	return test_report(argv[0]);
+}
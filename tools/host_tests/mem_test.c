@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the mem* routines in lib/stdlib/mem.c. The file is built twice,
+ * with and without OPTIMIZED_MEM_FUNCS, and its functions are renamed with the
+ * opt_ and byte_ prefixes so that both can be compared with the C library for
+ * every length and alignment combination up to a few words. Run with -b to
+ * also compare the throughput of the two implementations.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define DECLARE_MEM_FUNCS(_p)						\
+	void *_p##memset(void *dst, int val, size_t count);		\
+	int _p##memcmp(const void *s1, const void *s2, size_t len);	\
+	void *_p##memcpy(void *dst, const void *src, size_t len);	\
+	void *_p##memmove(void *dst, const void *src, size_t len);	\
+	void *_p##memchr(const void *src, int c, size_t len)
+
+DECLARE_MEM_FUNCS(opt_);
+DECLARE_MEM_FUNCS(byte_);
+
+typedef struct {
+	const char *name;
+	void *(*memset)(void *dst, int val, size_t count);
+	int (*memcmp)(const void *s1, const void *s2, size_t len);
+	void *(*memcpy)(void *dst, const void *src, size_t len);
+	void *(*memmove)(void *dst, const void *src, size_t len);
+	void *(*memchr)(const void *src, int c, size_t len);
+	/* Set if memchr() converts @c to unsigned char, as ISO C requires */
+	int memchr_converts;
+} mem_impl_t;
+
+static const mem_impl_t impls[] = {
+	{ "byte", byte_memset, byte_memcmp, byte_memcpy, byte_memmove,
+	  byte_memchr, 0 },
+	{ "opt", opt_memset, opt_memcmp, opt_memcpy, opt_memmove,
+	  opt_memchr, 1 },
+};
+
+/* Longest buffer tested, and largest misalignment of each buffer */
+#define MAX_LEN		160
+#define MAX_ALIGN	16
+#define GUARD		16
+#define BUF_SIZE	(GUARD + MAX_ALIGN + MAX_LEN + GUARD)
+
+static unsigned char src_buf[BUF_SIZE] __attribute__((aligned(64)));
+static unsigned char dst_buf[BUF_SIZE] __attribute__((aligned(64)));
+static unsigned char ref_buf[BUF_SIZE] __attribute__((aligned(64)));
+
+static void fill_random(unsigned char *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = rand();
+}
+
+static int sign(int v)
+{
+	return (v > 0) - (v < 0);
+}
+
+static void test_memset(const mem_impl_t *impl)
+{
+	static const int vals[] = { 0, 0x5a, 0x80, 0xff, 0x1234 };
+	unsigned int a, v;
+	size_t len;
+	void *ret;
+
+	for (v = 0; v < sizeof(vals) / sizeof(vals[0]); v++)
+	for (a = 0; a < MAX_ALIGN; a++)
+	for (len = 0; len <= MAX_LEN; len++) {
+		fill_random(dst_buf, BUF_SIZE);
+		memcpy(ref_buf, dst_buf, BUF_SIZE);
+		ret = impl->memset(dst_buf + GUARD + a, vals[v], len);
+		memset(ref_buf + GUARD + a, vals[v], len);
+		CHECK(ret == dst_buf + GUARD + a);
+		CHECK(memcmp(dst_buf, ref_buf, BUF_SIZE) == 0);
+	}
+}
+
+static void test_memcpy(const mem_impl_t *impl)
+{
+	unsigned int sa, da;
+	size_t len;
+	void *ret;
+
+	for (sa = 0; sa < MAX_ALIGN; sa++)
+	for (da = 0; da < MAX_ALIGN; da++)
+	for (len = 0; len <= MAX_LEN; len++) {
+		fill_random(src_buf, BUF_SIZE);
+		fill_random(dst_buf, BUF_SIZE);
+		memcpy(ref_buf, dst_buf, BUF_SIZE);
+		ret = impl->memcpy(dst_buf + GUARD + da, src_buf + GUARD + sa,
+				   len);
+		memcpy(ref_buf + GUARD + da, src_buf + GUARD + sa, len);
+		CHECK(ret == dst_buf + GUARD + da);
+		CHECK(memcmp(dst_buf, ref_buf, BUF_SIZE) == 0);
+	}
+}
+
+static void test_memmove(const mem_impl_t *impl)
+{
+	unsigned int base;
+	int shift;
+	size_t len;
+	void *ret;
+
+	/* Overlapping moves in both directions, from every alignment */
+	for (base = GUARD; base < GUARD + MAX_ALIGN; base++)
+	for (shift = -(int)MAX_ALIGN; shift <= (int)MAX_ALIGN; shift++)
+	for (len = 0; len <= MAX_LEN - MAX_ALIGN; len++) {
+		fill_random(dst_buf, BUF_SIZE);
+		memcpy(ref_buf, dst_buf, BUF_SIZE);
+		ret = impl->memmove(dst_buf + base + shift, dst_buf + base,
+				    len);
+		memmove(ref_buf + base + shift, ref_buf + base, len);
+		CHECK(ret == dst_buf + base + shift);
+		CHECK(memcmp(dst_buf, ref_buf, BUF_SIZE) == 0);
+	}
+}
+
+static void test_memcmp(const mem_impl_t *impl)
+{
+	unsigned int sa, da;
+	size_t len, pos;
+
+	for (sa = 0; sa < MAX_ALIGN; sa++)
+	for (da = 0; da < MAX_ALIGN; da++)
+	for (len = 0; len <= MAX_LEN; len += 3) {
+		unsigned char *s1 = src_buf + GUARD + sa;
+		unsigned char *s2 = dst_buf + GUARD + da;
+
+		fill_random(s1, len);
+		memcpy(s2, s1, len);
+		CHECK(impl->memcmp(s1, s2, len) == 0);
+
+		/* A difference at each position, in both directions */
+		for (pos = 0; pos < len; pos++) {
+			s2[pos] ^= 0x80;
+			CHECK(sign(impl->memcmp(s1, s2, len)) ==
+			      sign(memcmp(s1, s2, len)));
+			CHECK(sign(impl->memcmp(s2, s1, len)) ==
+			      sign(memcmp(s2, s1, len)));
+			/* A later difference must not change the result */
+			if (pos + 1 < len) {
+				s2[len - 1] ^= 0x01;
+				CHECK(sign(impl->memcmp(s1, s2, len)) ==
+				      sign(memcmp(s1, s2, len)));
+				s2[len - 1] ^= 0x01;
+			}
+			s2[pos] ^= 0x80;
+		}
+	}
+}
+
+static void test_memchr(const mem_impl_t *impl)
+{
+	static const int chars[] = { 0, 0x01, 0x7f, 0x80, 0xff, 0x100 + 0x42 };
+	unsigned int a, c;
+	size_t len, pos;
+	unsigned char *s;
+
+	for (c = 0; c < sizeof(chars) / sizeof(chars[0]); c++)
+	for (a = 0; a < MAX_ALIGN; a++)
+	for (len = 0; len <= MAX_LEN; len += 5) {
+		if ((chars[c] > 0xff) && !impl->memchr_converts)
+			continue;
+
+		s = src_buf + GUARD + a;
+		/* Bytes that are close to, but not, the searched value */
+		memset(s, (unsigned char)chars[c] ^ 0x01, len);
+		/* The searched value just past the end must not be found */
+		s[len] = chars[c];
+		CHECK(impl->memchr(s, chars[c], len) == NULL);
+
+		for (pos = 0; pos < len; pos++) {
+			s[pos] = chars[c];
+			CHECK(impl->memchr(s, chars[c], len) == s + pos);
+			CHECK(impl->memchr(s, chars[c], len) ==
+			      memchr(s, chars[c], len));
+			s[pos] = (unsigned char)chars[c] ^ 0x01;
+		}
+	}
+}
+
+static double bench(void *(*fn)(void *, const void *, size_t),
+		    size_t len, unsigned int misalign)
+{
+	static unsigned char bsrc[65536 + 64] __attribute__((aligned(64)));
+	static unsigned char bdst[65536 + 64] __attribute__((aligned(64)));
+	struct timespec t0, t1;
+	unsigned int i, iters = (64 << 20) / len;
+	double secs;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < iters; i++)
+		fn(bdst + misalign, bsrc, len);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+	return ((double)iters * len) / (secs * 1024 * 1024);
+}
+
+static void run_benchmark(void)
+{
+	static const size_t lens[] = { 16, 64, 256, 4096, 65536 };
+	unsigned int i;
+
+	printf("memcpy throughput (MB/s)   size   byte    opt  (misaligned opt)\n");
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		printf("%34zu %6.0f %6.0f %6.0f\n", lens[i],
+		       bench(byte_memcpy, lens[i], 0),
+		       bench(opt_memcpy, lens[i], 0),
+		       bench(opt_memcpy, lens[i], 3));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int i;
+
+	srand(1);
+
+	for (i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+		test_memset(&impls[i]);
+		test_memcpy(&impls[i]);
+		test_memmove(&impls[i]);
+		test_memcmp(&impls[i]);
+		test_memchr(&impls[i]);
+	}
+
+	if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+		run_benchmark();
+
+	return test_report("mem_test");
+}
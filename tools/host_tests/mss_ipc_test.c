@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the MSS PM IPC of plat/marvell/a8k/common/mss/mss_ipc_drv.c
+ * and mss_pm_ipc.c, which the a8k PSCI handlers use without a lock. Each CPU
+ * is a host thread that sends OFF and SUSPEND requests on its own channel,
+ * the same way as a8k_pwr_domain_off() and a8k_pwr_domain_suspend(), while a
+ * model of the MSS takes all the pending requests from the SISR at once.
+ *
+ * The model accesses are sequentially consistent, as the MSS SRAM and
+ * registers are Device memory. The SISR is write-1-to-set.
+ */
+
+/* The a8k platform definitions, in place of the host ones */
+#include "../../plat/marvell/a8k/common/include/platform_def.h"
+#include "../../plat/marvell/a8k/common/mss/mss_ipc_drv.c"
+#include "../../plat/marvell/a8k/common/mss/mss_pm_ipc.c"
+
+#include <pthread.h>
+#include <sched.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define IPC_CPUS		4
+#define IPC_ROUNDS		10000
+/* Polls of a channel before its request is reported as lost */
+#define IPC_MAX_POLLS		100000
+/* Written by the MSS over a message it has taken */
+#define IPC_POISON		0xdeadbeef
+
+/* IPC layout handed over by the MSS */
+#define IPC_MSG_BASE		0x40000
+#define IPC_QUEUE_SIZE		0x40
+#define IPC_CHANNEL_SIZE	(2 * IPC_QUEUE_SIZE)
+#define IPC_RAM_BASE		(IPC_MSG_BASE | IPC_MSG_BASE_MASK)
+#define IPC_RAM_SIZE		(IPC_CPUS * IPC_CHANNEL_SIZE)
+
+enum ipc_request {
+	REQ_OFF,
+	REQ_SUSPEND,
+	REQ_TYPES
+};
+
+static const unsigned int req_offset[REQ_TYPES] = {
+	[REQ_OFF] = MSS_CPU_OFF_INT_SET_OFFSET,
+	[REQ_SUSPEND] = MSS_CPU_SUSPEND_INT_SET_OFFSET,
+};
+
+/* Model of the MSS */
+static uint32_t ipc_ram[IPC_RAM_SIZE / sizeof(uint32_t)];
+static uint32_t sisr;
+static int mss_stop;
+static unsigned int mss_requests[IPC_CPUS][REQ_TYPES];
+static unsigned int mss_batches;	/* SISR reads with several requests */
+static unsigned int model_errors;	/* Set by any thread */
+static unsigned int lost_requests;
+
+static void model_error(void)
+{
+	__atomic_add_fetch(&model_errors, 1, __ATOMIC_SEQ_CST);
+}
+
+static uint32_t *ipc_word(uintptr_t addr)
+{
+	if (addr < IPC_RAM_BASE || addr >= IPC_RAM_BASE + IPC_RAM_SIZE ||
+	    (addr & 3) != 0) {
+		model_error();
+		return NULL;
+	}
+	return &ipc_ram[(addr - IPC_RAM_BASE) / sizeof(uint32_t)];
+}
+
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	uint32_t *word = ipc_word(addr);
+
+	return word ? __atomic_load_n(word, __ATOMIC_SEQ_CST) : 0;
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	uint32_t *word;
+
+	if (addr == MSS_SISR) {
+		__atomic_fetch_or(&sisr, value, __ATOMIC_SEQ_CST);
+		return;
+	}
+
+	word = ipc_word(addr);
+	if (word)
+		__atomic_store_n(word, value, __ATOMIC_SEQ_CST);
+}
+
+/* The MSS side of a request: the message must be complete and new */
+static void mss_handle(unsigned int cpu, enum ipc_request req)
+{
+	unsigned int addr = mv_pm_ipc_queue_addr_get(cpu, IPC_MSG_TX);
+
+	if (mmio_read_32(addr + IPC_MSG_STATE_LOC) != IPC_MSG_OCCUPY ||
+	    mmio_read_32(addr + IPC_MSG_POWER_STATE_LOC) != 0)
+		model_error();
+	else
+		mss_requests[cpu][req]++;
+
+	mmio_write_32(addr + IPC_MSG_POWER_STATE_LOC, IPC_POISON);
+	mmio_write_32(addr + IPC_MSG_STATE_LOC, IPC_MSG_FREE);
+}
+
+static void *mss_run(void *arg)
+{
+	uint32_t pending;
+	unsigned int cpu, req, found;
+
+	for (;;) {
+		pending = __atomic_exchange_n(&sisr, 0, __ATOMIC_SEQ_CST);
+		if (pending == 0) {
+			if (__atomic_load_n(&mss_stop, __ATOMIC_SEQ_CST))
+				return NULL;
+			sched_yield();
+			continue;
+		}
+
+		found = 0;
+		for (req = 0; req < REQ_TYPES; req++)
+			for (cpu = 0; cpu < IPC_CPUS; cpu++)
+				if (pending & (1 << (req_offset[req] + cpu))) {
+					mss_handle(cpu, req);
+					found++;
+				}
+		if (found != __builtin_popcount(pending))
+			model_error();
+		if (found > 1)
+			mss_batches++;
+	}
+}
+
+/* The PSCI side, as in a8k_pwr_domain_off() and a8k_pwr_domain_suspend() */
+static void *cpu_run(void *arg)
+{
+	unsigned int cpu = (uintptr_t)arg;
+	psci_power_state_t state;
+	unsigned int n, polls;
+
+	memset(&state, 0, sizeof(state));
+
+	for (n = 0; n < IPC_ROUNDS; n++) {
+		/* The CPU is back once the MSS has taken its last request */
+		polls = 0;
+		while (mv_pm_ipc_msg_validate(cpu, IPC_MSG_TX,
+					      IPC_MSG_FREE) != 0) {
+			if (++polls == IPC_MAX_POLLS) {
+				__atomic_add_fetch(&lost_requests, 1,
+						   __ATOMIC_SEQ_CST);
+				return NULL;
+			}
+			sched_yield();
+		}
+
+		mss_pm_ipc_msg_send(cpu, &state);
+		dsb();
+		if ((n % 2) == 0)
+			mss_pm_ipc_off_msg_trigger(cpu);
+		else
+			mss_pm_ipc_suspend_msg_trigger(cpu);
+	}
+
+	return NULL;
+}
+
+static void test_concurrent_requests(void)
+{
+	struct mss_pm_ipc_ctrl ctrl = {
+		.msg_base_address = IPC_MSG_BASE,
+		.num_of_channels = IPC_CPUS,
+		.channel_size = IPC_CHANNEL_SIZE,
+		.queue_size = IPC_QUEUE_SIZE,
+	};
+	pthread_t mss, cpus[IPC_CPUS];
+	unsigned int cpu;
+
+	mv_pm_ipc_init((uintptr_t)&ctrl);
+	CHECK(mv_pm_ipc_queue_addr_get(1, IPC_MSG_RX) ==
+	      IPC_RAM_BASE + IPC_CHANNEL_SIZE + IPC_QUEUE_SIZE);
+	for (cpu = 0; cpu < IPC_CPUS; cpu++) {
+		mmio_write_32(mv_pm_ipc_queue_addr_get(cpu, IPC_MSG_TX) +
+			      IPC_MSG_POWER_STATE_LOC, IPC_POISON);
+		mv_pm_ipc_msg_update(cpu, IPC_MSG_TX, IPC_MSG_FREE);
+	}
+
+	REQUIRE(pthread_create(&mss, NULL, mss_run, NULL) == 0);
+	for (cpu = 0; cpu < IPC_CPUS; cpu++)
+		REQUIRE(pthread_create(&cpus[cpu], NULL, cpu_run,
+				       (void *)(uintptr_t)cpu) == 0);
+	for (cpu = 0; cpu < IPC_CPUS; cpu++)
+		pthread_join(cpus[cpu], NULL);
+
+	/* Let the MSS take the last requests */
+	for (cpu = 0; cpu < IPC_CPUS; cpu++)
+		while (mv_pm_ipc_msg_validate(cpu, IPC_MSG_TX,
+					      IPC_MSG_FREE) != 0)
+			sched_yield();
+	__atomic_store_n(&mss_stop, 1, __ATOMIC_SEQ_CST);
+	pthread_join(mss, NULL);
+
+	CHECK(model_errors == 0);
+	CHECK(lost_requests == 0);
+	CHECK(sisr == 0);
+	for (cpu = 0; cpu < IPC_CPUS; cpu++) {
+		CHECK(mss_requests[cpu][REQ_OFF] == IPC_ROUNDS / 2);
+		CHECK(mss_requests[cpu][REQ_SUSPEND] == IPC_ROUNDS / 2);
+	}
+	printf("%u requests from %u CPUs, %u SISR reads with several\n",
+	       IPC_CPUS * IPC_ROUNDS, IPC_CPUS, mss_batches);
+}
+
+/* A reply is read from the RX queue of the channel, which is then freed */
+static void test_reply(void)
+{
+	unsigned int addr = mv_pm_ipc_queue_addr_get(2, IPC_MSG_RX);
+
+	mmio_write_32(addr + IPC_MSG_REPLY_LOC, PM_IPC_MSG_CPU_OFF);
+	mmio_write_32(addr + IPC_MSG_STATE_LOC, IPC_MSG_OCCUPY);
+	CHECK(mss_pm_ipc_msg_recv(2, PM_IPC_MSG_CPU_OFF) == 0);
+	CHECK(mmio_read_32(addr + IPC_MSG_STATE_LOC) == IPC_MSG_FREE);
+
+	mmio_write_32(addr + IPC_MSG_REPLY_LOC, PM_IPC_MSG_CPU_ON);
+	mmio_write_32(addr + IPC_MSG_STATE_LOC, IPC_MSG_OCCUPY);
+	CHECK(mss_pm_ipc_msg_recv(2, PM_IPC_MSG_CPU_OFF) == -1);
+	CHECK(model_errors == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	test_concurrent_requests();
+	test_reply();
+
+	return test_report(argv[0]);
+}
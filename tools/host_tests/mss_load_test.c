@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the MSS image DMA loader of
+ * plat/marvell/a8k/common/mss/mss_scp_bootloader.c. The loader is built into
+ * the test to reach its static functions, and runs over a model of the MSS
+ * DMA registers: a chunk transfer completes after a set number of reads of the
+ * control register, and each read advances the generic counter by 1 us. The
+ * image is loaded below 4GB, as the loader takes 32-bit addresses.
+ */
+
+/* The a8k platform definitions, in place of the host ones */
+#include "../../plat/marvell/a8k/common/include/platform_def.h"
+#include "../../plat/marvell/a8k/common/mss/mss_scp_bootloader.c"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define TICKS_PER_US		(COUNTER_FREQUENCY / 1000000)
+#define MSS_REGS		AP_MSS_REG_BASE
+#define MSS_RAM_SIZE		0x10000
+#define MAX_IMAGE_SIZE		(MSS_RAM_SIZE - DMA_SIZE)
+
+/* Model of the MSS */
+static uint8_t mss_ram[MSS_RAM_SIZE];
+static uint32_t reg_srcbr, reg_dstbr, reg_aebr, reg_aibr;
+static int dma_busy;
+static unsigned int busy_reads;
+static unsigned int num_dmas;
+static int m3_released;
+static uint32_t last_dstbr;
+
+/* Model settings */
+static unsigned int complete_after;	/* Control reads before the ACK */
+static int never_complete;
+
+static uint8_t *image;
+static uint64_t now;
+
+uint64_t read_cntpct_el0(void)
+{
+	return now;
+}
+
+void mdelay(uint32_t msec)
+{
+	now += (uint64_t)msec * 1000 * TICKS_PER_US;
+}
+
+static void dma_transfer(void)
+{
+	uint8_t *src;
+
+	/* The DMA reads the external space through the address extension */
+	src = (uint8_t *)(uintptr_t)(((uint64_t)reg_aebr <<
+				       MSS_EXTERNAL_ACCESS_BIT) |
+				      (reg_srcbr & MSS_EXTERNAL_ADDR_MASK));
+	CHECK(reg_dstbr + DMA_SIZE <= MSS_RAM_SIZE);
+	if (reg_dstbr + DMA_SIZE <= MSS_RAM_SIZE)
+		memcpy(&mss_ram[reg_dstbr], src, DMA_SIZE);
+	dma_busy = 0;
+}
+
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	if (addr != MSS_DMA_CTRLR(MSS_REGS)) {
+		CHECK(!"read of an unexpected register");
+		return 0;
+	}
+
+	now += TICKS_PER_US;
+	if (dma_busy) {
+		if (never_complete || busy_reads-- > 0)
+			return 0;
+		dma_transfer();
+	}
+	return MSS_DMA_CTRLR_ACK_READY << MSS_DMA_CTRLR_ACK_OFFSET;
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	if (addr == MSS_DMA_SRCBR(MSS_REGS)) {
+		CHECK((value & ~MSS_EXTERNAL_ADDR_MASK) == MSS_EXTERNAL_SPACE);
+		reg_srcbr = value;
+	} else if (addr == MSS_DMA_DSTBR(MSS_REGS)) {
+		reg_dstbr = value;
+	} else if (addr == MSS_DMA_CTRLR(MSS_REGS)) {
+		/* A new chunk is only issued once the previous one is done */
+		CHECK(!dma_busy);
+		CHECK(value == ((MSS_DMA_CTRLR_REQ_SET <<
+				 MSS_DMA_CTRLR_REQ_OFFSET) | DMA_SIZE));
+		/* Chunks are issued in order */
+		CHECK(num_dmas == 0 || reg_dstbr == last_dstbr + DMA_SIZE);
+		last_dstbr = reg_dstbr;
+		dma_busy = 1;
+		busy_reads = complete_after;
+		num_dmas++;
+	} else if (addr == MSS_AEBR(MSS_REGS)) {
+		reg_aebr = value;
+	} else if (addr == MSS_AIBR(MSS_REGS)) {
+		reg_aibr = value;
+	} else if (addr == MSS_M3_RSTCR(MSS_REGS)) {
+		CHECK(value == MSS_M3_RSTCR_RST_OFF);
+		m3_released = 1;
+	} else {
+		CHECK(!"write to an unexpected register");
+	}
+}
+
+static void reset_model(void)
+{
+	memset(mss_ram, 0, sizeof(mss_ram));
+	dma_busy = 0;
+	num_dmas = 0;
+	m3_released = 0;
+	complete_after = 3;
+	never_complete = 0;
+	now = 0;
+}
+
+static void fill_image(uint32_t size)
+{
+	uint32_t n;
+
+	for (n = 0; n < size; n++)
+		image[n] = (uint8_t)(n * 7 + (n >> 8));
+}
+
+static uint32_t image_addr(void)
+{
+	return (uint32_t)(uintptr_t)image;
+}
+
+static void test_load(void)
+{
+	static const uint32_t sizes[] = {
+		4, DMA_SIZE - 4, DMA_SIZE, DMA_SIZE + 4, 1000, 4096,
+		MAX_IMAGE_SIZE
+	};
+	unsigned int i;
+	uint32_t size;
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		size = sizes[i];
+		reset_model();
+		fill_image(size);
+
+		mss_dma_load_start(image_addr(), size, MSS_REGS);
+		CHECK(reg_aebr == ((image_addr() >> MSS_EXTERNAL_ACCESS_BIT) &
+				   MSS_AEBR_MASK));
+		CHECK(reg_aibr == ((MSS_REGS >> MSS_INTERNAL_ACCESS_BIT) &
+				   MSS_AIBR_MASK));
+		CHECK(mss_dma_load_wait() == 0);
+
+		CHECK(num_dmas == (size + DMA_SIZE - 1) / DMA_SIZE);
+		CHECK(memcmp(mss_ram, image, size) == 0);
+		CHECK(m3_released);
+	}
+}
+
+/* The loader never waits between two polls, nor after the last chunk */
+static void test_poll(void)
+{
+	uint32_t size = 10 * DMA_SIZE;
+	unsigned int polls = 0;
+	int ret;
+
+	reset_model();
+	fill_image(size);
+	complete_after = 5;
+
+	mss_dma_load_start(image_addr(), size, MSS_REGS);
+	CHECK(num_dmas == 1);
+	do {
+		ret = mss_dma_load_poll();
+		polls++;
+		/* The caller is free to do other work here */
+	} while (ret > 0);
+
+	CHECK(ret == 0);
+	CHECK(num_dmas == 10);
+	/* 5 busy reads and one ACK per chunk */
+	CHECK(polls == 10 * (complete_after + 1));
+	CHECK(now == 10 * (complete_after + 1) * TICKS_PER_US);
+	/* The counter is read before the ACK */
+	CHECK(mss_load.min_ticks == complete_after * TICKS_PER_US);
+	CHECK(mss_load.max_ticks == mss_load.min_ticks);
+	CHECK(!m3_released);
+
+	/* Once done, polling does not touch the engine */
+	CHECK(mss_dma_load_poll() == 0);
+	CHECK(now == 10 * (complete_after + 1) * TICKS_PER_US);
+
+	CHECK(mss_dma_load_wait() == 0);
+	CHECK(m3_released);
+	CHECK(memcmp(mss_ram, image, size) == 0);
+}
+
+static void test_timeout(void)
+{
+	reset_model();
+	fill_image(4096);
+	never_complete = 1;
+
+	mss_dma_load_start(image_addr(), 4096, MSS_REGS);
+	CHECK(mss_dma_load_wait() == 1);
+	CHECK(!m3_released);
+	CHECK(num_dmas == 1);
+	CHECK(now > MSS_US_TO_TICKS(MSS_DMA_TIMEOUT_US));
+	CHECK(now <= MSS_US_TO_TICKS(MSS_DMA_TIMEOUT_US) + 2 * TICKS_PER_US);
+
+	/* A late chunk within the timeout is waited for */
+	reset_model();
+	complete_after = MSS_DMA_TIMEOUT_US - 10;
+	mss_dma_load_start(image_addr(), 2 * DMA_SIZE, MSS_REGS);
+	CHECK(mss_dma_load_wait() == 0);
+	CHECK(m3_released);
+}
+
+int main(int argc, char *argv[])
+{
+	image = mmap(NULL, MAX_IMAGE_SIZE, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (image == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	test_load();
+	test_poll();
+	test_timeout();
+
+	return test_report(argv[0]);
+}
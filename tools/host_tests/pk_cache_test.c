@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the public key cache of drivers/auth/mbedtls/mbedtls_crypto.c
+ * over the fake mbed TLS of fake_mbedtls.c. The signature checks follow the
+ * order of the TBBR Chain of Trust, where the trusted and non-trusted world
+ * keys each verify several certificates in a row. The test is built with
+ * MBEDTLS_PK_CACHE_ENTRIES set to 0, to 2 and to 4.
+ */
+
+#include <crypto_mod.h>
+#include <mbedtls_common.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fake_mbedtls.h"
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define KEY_SIZE		64
+#define CERT_SIZE		256
+
+#define ROT_KEY			0
+#define TRUSTED_KEY		1
+#define NON_TRUSTED_KEY		2
+#define SCP_KEY			3
+#define NUM_KEYS		4
+
+static unsigned char keys[NUM_KEYS][KEY_SIZE];
+static unsigned char sig_alg[] = { FAKE_ALG_SHA256 };
+
+/* Signing keys of the certificates, in the order BL2 verifies them */
+static const int tbbr_chain[] = {
+	ROT_KEY,		/* Trusted key certificate */
+	TRUSTED_KEY,		/* SCP_BL2 key certificate */
+	SCP_KEY,		/* SCP_BL2 content certificate */
+	TRUSTED_KEY,		/* SoC firmware key certificate */
+	TRUSTED_KEY,		/* Trusted OS firmware key certificate */
+	NON_TRUSTED_KEY,	/* Non-trusted firmware key certificate */
+	ROT_KEY,		/* Non-trusted firmware key (ROTPK check) */
+	TRUSTED_KEY,		/* SoC firmware content certificate */
+	TRUSTED_KEY,		/* Trusted OS firmware content certificate */
+	NON_TRUSTED_KEY,	/* Non-trusted firmware content certificate */
+};
+#define CHAIN_LENGTH	(sizeof(tbbr_chain) / sizeof(tbbr_chain[0]))
+
+/* Verify @cert signed with @signer against the public key @key */
+static int verify(const unsigned char *cert, const unsigned char *signer,
+		  unsigned char *key)
+{
+	unsigned char sig[FAKE_DIGEST_SIZE];
+
+	fake_sign(signer, cert, CERT_SIZE, sig);
+	return crypto_mod_verify_signature((void *)cert, CERT_SIZE,
+					   sig, sizeof(sig),
+					   sig_alg, sizeof(sig_alg),
+					   key, KEY_SIZE);
+}
+
+/* The chain verifies and the keys are parsed once each when they fit */
+static void test_chain(void)
+{
+	unsigned char cert[CERT_SIZE];
+	unsigned int i, n, parsed;
+
+	parsed = fake_pk_parsed;
+	for (n = 0; n < 2; n++) {
+		for (i = 0; i < CHAIN_LENGTH; i++) {
+			memset(cert, i, sizeof(cert));
+			CHECK(verify(cert, keys[tbbr_chain[i]],
+				     keys[tbbr_chain[i]]) == CRYPTO_SUCCESS);
+		}
+	}
+	parsed = fake_pk_parsed - parsed;
+
+	printf("  %u signature checks, %u key parses\n", 2 * CHAIN_LENGTH,
+	       parsed);
+#if MBEDTLS_PK_CACHE_ENTRIES >= NUM_KEYS
+	CHECK(parsed == NUM_KEYS);
+#elif MBEDTLS_PK_CACHE_ENTRIES
+	CHECK(parsed > NUM_KEYS);
+	CHECK(parsed < 2 * CHAIN_LENGTH);
+#else
+	CHECK(parsed == 2 * CHAIN_LENGTH);
+	CHECK(fake_pk_freed == fake_pk_parsed);
+#endif
+}
+
+/* A cached key only verifies signatures made with it */
+static void test_wrong_key(void)
+{
+	unsigned char cert[CERT_SIZE];
+	unsigned char copy[KEY_SIZE];
+
+	memset(cert, 0x5a, sizeof(cert));
+	CHECK(verify(cert, keys[TRUSTED_KEY], keys[TRUSTED_KEY]) ==
+	      CRYPTO_SUCCESS);
+	CHECK(verify(cert, keys[NON_TRUSTED_KEY], keys[TRUSTED_KEY]) ==
+	      CRYPTO_ERR_SIGNATURE);
+	CHECK(verify(cert, keys[TRUSTED_KEY], keys[NON_TRUSTED_KEY]) ==
+	      CRYPTO_ERR_SIGNATURE);
+
+	/* Keys are matched on their content, not their address */
+	memcpy(copy, keys[TRUSTED_KEY], sizeof(copy));
+	CHECK(verify(cert, keys[TRUSTED_KEY], copy) == CRYPTO_SUCCESS);
+	copy[KEY_SIZE - 1] ^= 1;
+	copy[0] = 0x77;
+	CHECK(verify(cert, keys[TRUSTED_KEY], copy) == CRYPTO_ERR_SIGNATURE);
+}
+
+/* A key that fails to parse is reported and not cached */
+static void test_bad_key(void)
+{
+	unsigned char cert[CERT_SIZE];
+	unsigned char bad[KEY_SIZE];
+
+	memset(cert, 0xa5, sizeof(cert));
+	memset(bad, 0, sizeof(bad));
+	CHECK(verify(cert, keys[TRUSTED_KEY], bad) == CRYPTO_ERR_SIGNATURE);
+	CHECK(verify(cert, keys[TRUSTED_KEY], bad) == CRYPTO_ERR_SIGNATURE);
+	CHECK(verify(cert, keys[TRUSTED_KEY], keys[TRUSTED_KEY]) ==
+	      CRYPTO_SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int i, j;
+
+	srand(1);
+	for (i = 0; i < NUM_KEYS; i++) {
+		for (j = 0; j < KEY_SIZE; j++)
+			keys[i][j] = rand();
+		/* The fake signatures use the first byte, keep them apart */
+		keys[i][0] = 0x10 * (i + 1);
+	}
+
+	crypto_mod_init();
+
+	printf("%s: %u cache entries\n", argv[0], MBEDTLS_PK_CACHE_ENTRIES);
+	test_chain();
+	test_wrong_key();
+	test_bad_key();
+
+	/* Evicted keys are freed, the cached ones are still held */
+	CHECK(fake_pk_parsed - fake_pk_freed <= MBEDTLS_PK_CACHE_ENTRIES);
+#if MBEDTLS_PK_CACHE_ENTRIES
+	mbedtls_pk_cache_print_stats();
+#endif
+
+	return test_report(argv[0]);
+}
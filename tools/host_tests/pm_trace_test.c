@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of pm_trace_add() of plat/marvell/a8k/common/plat_pm_trace.c,
+ * built with PM_TRACE_ENABLE for the a80x0 platform definitions, over a model
+ * of the MSS SRAM trace queues and of the MSS timer. The queues are read back
+ * the way the MSS firmware does, from the oldest entry.
+ */
+
+/* The a8k platform definitions, in place of the host ones */
+#include "../../plat/marvell/a8k/common/include/platform_def.h"
+#include <plat_pm_trace.h>
+/* The header disables the trace, enable it for the source below */
+#define PM_TRACE_ENABLE
+#include "../../plat/marvell/a8k/common/plat_pm_trace.c"
+
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define TRACE_ENTRIES		(AP_MSS_ATF_TRACE_SIZE_MASK + 1)
+#define MSS_SRAM_BASE		AP_MSS_ATF_CORE_CTRL_BASE
+#define MSS_SRAM_END		AP_MSS_ATF_CORE_INFO(PLATFORM_CORE_COUNT)
+
+/* Model of the MSS SRAM and timer */
+static uint32_t mss_sram[(MSS_SRAM_END - MSS_SRAM_BASE) / sizeof(uint32_t)];
+static uint32_t timer;
+static unsigned int sram_reads, timer_reads, writes;
+
+static uint32_t *sram_word(uintptr_t addr)
+{
+	CHECK(addr >= MSS_SRAM_BASE && addr < MSS_SRAM_END);
+	CHECK((addr & 3) == 0);
+	if (addr < MSS_SRAM_BASE || addr >= MSS_SRAM_END)
+		return &mss_sram[0];
+	return &mss_sram[(addr - MSS_SRAM_BASE) / sizeof(uint32_t)];
+}
+
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	if (addr == AP_MSS_TIMER_BASE) {
+		timer_reads++;
+		return timer++;
+	}
+	sram_reads++;
+	return *sram_word(addr);
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	writes++;
+	*sram_word(addr) = value;
+}
+
+static uint32_t *queue_entry(unsigned int core, unsigned int pos)
+{
+	return sram_word(AP_MSS_ATF_CORE_INFO(core) +
+			 pos * AP_MSS_ATF_CORE_ENTRY_SIZE);
+}
+
+static unsigned int queue_pos(unsigned int core)
+{
+	return *sram_word(AP_MSS_ATF_CORE_CTRL(core));
+}
+
+static void reset_model(void)
+{
+	memset(mss_sram, 0, sizeof(mss_sram));
+	memset(pm_trace_pos, 0, sizeof(pm_trace_pos));
+	timer = 1000;
+	sram_reads = 0;
+	timer_reads = 0;
+	writes = 0;
+}
+
+/* The queue of each core is separate from the control words and the others */
+static void test_layout(void)
+{
+	unsigned int core;
+
+	CHECK(AP_MSS_ATF_CORE_CTRL(PLATFORM_CORE_COUNT) <=
+	      AP_MSS_ATF_CORE_INFO_BASE);
+	for (core = 0; core < PLATFORM_CORE_COUNT; core++)
+		CHECK(AP_MSS_ATF_CORE_INFO(core) +
+		      TRACE_ENTRIES * AP_MSS_ATF_CORE_ENTRY_SIZE ==
+		      AP_MSS_ATF_CORE_INFO(core + 1));
+}
+
+/* Only the first trace of a core reads its position from the MSS SRAM */
+static void test_add(void)
+{
+	unsigned int n;
+
+	reset_model();
+	/* Left by a previous boot stage */
+	*sram_word(AP_MSS_ATF_CORE_CTRL(2)) = 10;
+
+	pm_trace_add(TRACE_PWR_DOMAIN_OFF | 1, 2);
+	CHECK(sram_reads == 1);
+	CHECK(timer_reads == 1);
+	CHECK(writes == 3);
+	CHECK(queue_entry(2, 10)[0] == 1000);
+	CHECK(queue_entry(2, 10)[1] == (TRACE_PWR_DOMAIN_OFF | 1));
+	CHECK(queue_pos(2) == 11);
+
+	for (n = 0; n < 5; n++)
+		pm_trace_add(TRACE_PWR_DOMAIN_SUSPEND | n, 2);
+	CHECK(sram_reads == 1);
+	CHECK(timer_reads == 6);
+	CHECK(writes == 18);
+	CHECK(queue_pos(2) == 16);
+	CHECK(queue_entry(2, 15)[1] == (TRACE_PWR_DOMAIN_SUSPEND | 4));
+
+	/* The other queues are untouched */
+	CHECK(queue_pos(1) == 0);
+	CHECK(queue_pos(3) == 0);
+	CHECK(queue_entry(1, 255)[1] == 0);
+	CHECK(queue_entry(3, 0)[1] == 0);
+}
+
+/* The queue is cyclic, the MSS reads it back from the oldest entry */
+static void test_wrap(void)
+{
+	unsigned int n, pos, traces = TRACE_ENTRIES + 20;
+	uint32_t *entry;
+
+	reset_model();
+	for (n = 0; n < traces; n++)
+		pm_trace_add(TRACE_PWR_DOMAIN_ON_FINISH | n, 0);
+	CHECK(queue_pos(0) == traces % TRACE_ENTRIES);
+
+	pos = queue_pos(0);
+	for (n = traces - TRACE_ENTRIES; n < traces; n++) {
+		entry = queue_entry(0, pos);
+		CHECK(entry[1] == (TRACE_PWR_DOMAIN_ON_FINISH | n));
+		CHECK(entry[0] == 1000 + n);
+		pos = (pos + 1) & AP_MSS_ATF_TRACE_SIZE_MASK;
+	}
+}
+
+static void test_invalid_core(void)
+{
+	reset_model();
+	pm_trace_add(TRACE_PWR_DOMAIN_ON, PLATFORM_CORE_COUNT);
+	pm_trace_add(TRACE_PWR_DOMAIN_ON, ~0U);
+	CHECK(sram_reads == 0);
+	CHECK(timer_reads == 0);
+	CHECK(writes == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	test_layout();
+	test_add();
+	test_wrap();
+	test_invalid_core();
+
+	return test_report(argv[0]);
+}
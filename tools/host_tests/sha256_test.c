@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the SHA-256 block function of
+ * drivers/auth/mbedtls/mbedtls_sha256.c. The portable block function is
+ * checked against known answers, with the padding of FIPS 180-4 done here in
+ * place of mbed TLS. The ARMv8 Cryptographic Extension kernel
+ * (aarch64/sha256_ce.S) cannot run on the host: it is replaced by a stub that
+ * only checks that it is selected when ID_AA64ISAR0_EL1 reports the SHA-256
+ * instructions.
+ *
+ * With -b, the throughput of the portable block function is measured.
+ */
+
+#include <arch.h>
+#include <mbedtls/sha256.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+static uint64_t id_aa64isar0;
+static unsigned int ce_blocks;
+
+uint64_t read_id_aa64isar0_el1(void)
+{
+	return id_aa64isar0;
+}
+
+void sha256_ce_process(uint32_t state[8], const unsigned char *data)
+{
+	ce_blocks++;
+}
+
+static void sha256(const unsigned char *msg, size_t len, unsigned char *out)
+{
+	static const uint32_t h0[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+	};
+	mbedtls_sha256_context ctx;
+	unsigned char block[128];
+	uint64_t bits = (uint64_t)len * 8;
+	size_t tail, pad, i;
+
+	memcpy(ctx.state, h0, sizeof(h0));
+	for (; len >= 64; msg += 64, len -= 64)
+		mbedtls_sha256_process(&ctx, msg);
+
+	/* 0x80, zeroes and the 64-bit length end the last one or two blocks */
+	memset(block, 0, sizeof(block));
+	memcpy(block, msg, len);
+	block[len] = 0x80;
+	tail = (len < 56) ? 64 : 128;
+	for (i = 0; i < 8; i++)
+		block[tail - 1 - i] = bits >> (8 * i);
+	for (pad = 0; pad < tail; pad += 64)
+		mbedtls_sha256_process(&ctx, block + pad);
+
+	for (i = 0; i < 32; i++)
+		out[i] = ctx.state[i / 4] >> (24 - 8 * (i % 4));
+}
+
+static void check_digest(const unsigned char *msg, size_t len,
+			 const char *expected)
+{
+	unsigned char digest[32];
+	char hex[65];
+	unsigned int i;
+
+	sha256(msg, len, digest);
+	for (i = 0; i < 32; i++)
+		sprintf(hex + 2 * i, "%02x", digest[i]);
+	if (strcmp(hex, expected) != 0)
+		printf("  %zu bytes: got %s\n", len, hex);
+	CHECK(strcmp(hex, expected) == 0);
+}
+
+/* Known answers, the messages being 0, 1, 2... modulo 256 */
+static void test_known_answers(void)
+{
+	static const struct {
+		size_t len;
+		const char *digest;
+	} kats[] = {
+		{ 0, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+		{ 1, "6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d" },
+		{ 55, "463eb28e72f82e0a96c0a4cc53690c571281131f672aa229e0d45ae59b598b59" },
+		{ 56, "da2ae4d6b36748f2a318f23e7ab1dfdf45acdc9d049bd80e59de82a60895f562" },
+		{ 63, "29af2686fd53374a36b0846694cc342177e428d1647515f078784d69cdb9e488" },
+		{ 64, "fdeab9acf3710362bd2658cdc9a29e8f9c757fcf9811603a8c447cd1d9151108" },
+		{ 65, "4bfd2c8b6f1eec7a2afeb48b934ee4b2694182027e6d0fc075074f2fabb31781" },
+		{ 119, "da18797ed7c3a777f0847f429724a2d8cd5138e6ed2895c3fa1a6d39d18f7ec6" },
+		{ 120, "f52b23db1fbb6ded89ef42a23ce0c8922c45f25c50b568a93bf1c075420bbb7c" },
+		{ 127, "92ca0fa6651ee2f97b884b7246a562fa71250fedefe5ebf270d31c546bfea976" },
+		{ 128, "471fb943aa23c511f6f72f8d1652d9c880cfa392ad80503120547703e56a2be5" },
+		{ 1000, "a8af099bf2e878609558dbf69d8f88f4a31040a8cf84b549a0cfa912f12ffc3f" },
+		{ 4096, "c8f5d0341d54d951a71b136e6e2afcb14d11ed8489a7ae126a8fee0df6ecf193" },
+	};
+	static unsigned char msg[4096];
+	unsigned int i;
+
+	for (i = 0; i < sizeof(msg); i++)
+		msg[i] = i;
+	for (i = 0; i < sizeof(kats) / sizeof(kats[0]); i++)
+		check_digest(msg, kats[i].len, kats[i].digest);
+}
+
+/* The examples of FIPS 180-4 */
+static void test_fips_examples(void)
+{
+	static const char two_blocks[] =
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	unsigned char *million;
+
+	check_digest((const unsigned char *)"abc", 3,
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	check_digest((const unsigned char *)two_blocks, sizeof(two_blocks) - 1,
+		"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+	million = malloc(1000000);
+	REQUIRE(million != NULL);
+	memset(million, 'a', 1000000);
+	check_digest(million, 1000000,
+		"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+	free(million);
+}
+
+/* The CE kernel is used when the CPU has the SHA-256 instructions */
+static void test_dispatch(void)
+{
+	mbedtls_sha256_context ctx;
+	unsigned char block[64];
+
+	memset(&ctx, 0, sizeof(ctx));
+	memset(block, 0, sizeof(block));
+
+	ce_blocks = 0;
+	id_aa64isar0 = 1ULL << ID_AA64ISAR0_SHA2_SHIFT;
+	mbedtls_sha256_process(&ctx, block);
+	CHECK(ce_blocks == 1);
+	/* SHA-512 support (field value 2) implies SHA-256 */
+	id_aa64isar0 = 2ULL << ID_AA64ISAR0_SHA2_SHIFT;
+	mbedtls_sha256_process(&ctx, block);
+	CHECK(ce_blocks == 2);
+	/* Other fields do not matter */
+	id_aa64isar0 = ~(ID_AA64ISAR0_SHA2_MASK << ID_AA64ISAR0_SHA2_SHIFT);
+	mbedtls_sha256_process(&ctx, block);
+	CHECK(ce_blocks == 2);
+	id_aa64isar0 = 0;
+}
+
+static void benchmark(void)
+{
+	mbedtls_sha256_context ctx;
+	static unsigned char buf[1024 * 1024];
+	unsigned int i, n, rounds = 64;
+	struct timespec start, end;
+	double secs;
+
+	memset(&ctx, 0, sizeof(ctx));
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (n = 0; n < rounds; n++)
+		for (i = 0; i < sizeof(buf); i += 64)
+			mbedtls_sha256_process(&ctx, buf + i);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	secs = (end.tv_sec - start.tv_sec) +
+	       (end.tv_nsec - start.tv_nsec) / 1e9;
+	printf("portable SHA-256 block function: %.1f MB/s\n",
+	       rounds * (sizeof(buf) / 1e6) / secs);
+}
+
+int main(int argc, char *argv[])
+{
+	test_known_answers();
+	test_fips_examples();
+	test_dispatch();
+
+	if ((argc > 1) && (strcmp(argv[1], "-b") == 0))
+		benchmark();
+
+	return test_report(argv[0]);
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the Marvell SiP service of plat/marvell/common/marvell_sip_svc.c,
+ * built with and without SMC_BENCHMARK. The service is built into the test to
+ * reach its statistics. The generic counter only advances when the test, or
+ * the context save and restore stubs, move it.
+ */
+
+/* <context_mgmt.h> uses assert() without including it */
+#include <assert.h>
+#include "../../plat/marvell/common/marvell_sip_svc.c"
+
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+static cpu_context_t ctx;
+static uint64_t now;
+static unsigned int cpu;
+static unsigned int saves, restores;
+
+uint64_t read_cntpct_el0(void)
+{
+	return now;
+}
+
+unsigned int plat_my_core_pos(void)
+{
+	return cpu;
+}
+
+/* A save costs 3 to 5 ticks, a restore 2 */
+void cm_el1_sysregs_context_save(uint32_t security_state)
+{
+	CHECK(security_state == NON_SECURE);
+	now += 3 + (saves++ % 3);
+}
+
+void cm_el1_sysregs_context_restore(uint32_t security_state)
+{
+	CHECK(security_state == NON_SECURE);
+	now += 2;
+	restores++;
+}
+
+static u_register_t reg(unsigned int n)
+{
+	return read_ctx_reg(get_gpregs_ctx(&ctx), (CTX_GPREG_X0 + n * 8));
+}
+
+static void sip_call(uint32_t fid, u_register_t x1, u_register_t flags)
+{
+	memset(&ctx, 0, sizeof(ctx));
+	mv_sip_smc_handler(fid, x1, 0, 0, 0, NULL, &ctx, flags);
+}
+
+static void test_common(void)
+{
+	sip_call(MV_SIP_SVC_CALL_COUNT, 0, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == 3 + (SMC_BENCHMARK ? 3 : 0));
+
+	sip_call(MV_SIP_SVC_VERSION, 0, SMC_FROM_SECURE);
+	CHECK(reg(0) == MV_SIP_SVC_VERSION_MAJOR);
+	CHECK(reg(1) == MV_SIP_SVC_VERSION_MINOR);
+
+	sip_call(0xc200ff20, 0, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == SMC_UNK);
+}
+
+#if SMC_BENCHMARK
+static void test_bench_null(void)
+{
+	now = 1000;
+	cpu = 1;
+	sip_call(MV_SIP_BENCH_NULL, 950, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == 0);
+	CHECK(reg(1) == 50);
+	sip_call(MV_SIP_BENCH_NULL, 990, SMC_FROM_NON_SECURE);
+	CHECK(reg(1) == 10);
+	/* A timestamp from the future is not counted */
+	sip_call(MV_SIP_BENCH_NULL, 1001, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == 0);
+	CHECK(reg(1) == 0);
+
+	/* The statistics are per CPU */
+	cpu = 0;
+	sip_call(MV_SIP_BENCH_GET_STATS, 0, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == 0);
+	CHECK(reg(1) == 0 && reg(2) == 0 && reg(3) == 0);
+
+	cpu = 1;
+	sip_call(MV_SIP_BENCH_GET_STATS, 0, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == 0);
+	CHECK(reg(1) == 10);
+	CHECK(reg(2) == 30);
+	CHECK(reg(3) == 50);
+
+	/* and reset once read */
+	sip_call(MV_SIP_BENCH_GET_STATS, 0, SMC_FROM_NON_SECURE);
+	CHECK(reg(1) == 0 && reg(2) == 0 && reg(3) == 0);
+	CHECK(mv_sip_bench_stats[1].count == 0);
+}
+
+static void test_bench_ctx_switch(void)
+{
+	saves = 0;
+	restores = 0;
+	sip_call(MV_SIP_BENCH_CTX_SWITCH, 0, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == SMC_UNK);
+	sip_call(MV_SIP_BENCH_CTX_SWITCH, MV_SIP_BENCH_MAX_LOOPS + 1,
+		 SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == SMC_UNK);
+	CHECK(saves == 0);
+
+	sip_call(MV_SIP_BENCH_CTX_SWITCH, 10, SMC_FROM_NON_SECURE);
+	CHECK(saves == 10);
+	CHECK(restores == 10);
+	CHECK(reg(0) == 0);
+	CHECK(reg(1) == 5);
+	/* (10 * 5 + 9) / 10 */
+	CHECK(reg(2) == 5);
+	CHECK(reg(3) == 7);
+}
+
+/* A secure caller would have its own EL1 registers saved as non-secure */
+static void test_bench_secure_caller(void)
+{
+	static const uint32_t fids[] = {
+		MV_SIP_BENCH_NULL, MV_SIP_BENCH_CTX_SWITCH,
+		MV_SIP_BENCH_GET_STATS
+	};
+	unsigned int i;
+
+	saves = 0;
+	now = 1000;
+	cpu = 2;
+	for (i = 0; i < ARRAY_SIZE(fids); i++) {
+		sip_call(fids[i], 10, SMC_FROM_SECURE);
+		CHECK(reg(0) == SMC_UNK);
+	}
+	CHECK(saves == 0);
+	CHECK(mv_sip_bench_stats[2].count == 0);
+}
+#else
+static void test_no_bench(void)
+{
+	sip_call(MV_SIP_BENCH_NULL, 0, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == SMC_UNK);
+	sip_call(MV_SIP_BENCH_CTX_SWITCH, 10, SMC_FROM_NON_SECURE);
+	CHECK(reg(0) == SMC_UNK);
+	CHECK(saves == 0);
+}
+#endif /* SMC_BENCHMARK */
+
+int main(int argc, char *argv[])
+{
+	test_common();
+#if SMC_BENCHMARK
+	test_bench_null();
+	test_bench_ctx_switch();
+	test_bench_secure_caller();
+#else
+	test_no_bench();
+#endif
+
+	return test_report(argv[0]);
+}
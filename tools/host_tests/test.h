@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Minimal helpers shared by the host tests. A test checks its expectations
+ * with CHECK() and returns test_report() from main(), so that the exit status
+ * is non-zero if any check failed.
+ */
+
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+
+extern unsigned int test_checks;
+extern unsigned int test_failures;
+
+/* Only the first failures are printed, the others are just counted */
+#define TEST_MAX_REPORTS	20
+
+#define TEST_FAIL(_cond)						\
+	do {								\
+		if (++test_failures <= TEST_MAX_REPORTS)		\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #_cond);		\
+	} while (0)
+
+#define CHECK(_cond)							\
+	do {								\
+		test_checks++;						\
+		if (!(_cond))						\
+			TEST_FAIL(_cond);				\
+	} while (0)
+
+/* Same as CHECK() but stops the current test function on failure */
+#define REQUIRE(_cond)							\
+	do {								\
+		test_checks++;						\
+		if (!(_cond)) {						\
+			TEST_FAIL(_cond);				\
+			return;						\
+		}							\
+	} while (0)
+
+/* Defines the test counters, must be used once per test program */
+#define TEST_DEFINE_COUNTERS						\
+	unsigned int test_checks;					\
+	unsigned int test_failures
+
+static inline int test_report(const char *name)
+{
+	printf("%s: %u checks, %u failed\n", name, test_checks,
+	       test_failures);
+	return test_failures != 0;
+}
+
+#endif /* __TEST_H__ */
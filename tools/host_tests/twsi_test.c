@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2017, ARM Limited and Contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * Neither the name of ARM nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific
+ * prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host test of the A8K I2C (TWSI) driver of drivers/marvell/i2c/a8k_i2c.c and
+ * of the SPD read of plat/marvell/a8k/common/plat_ble_spd.c, built for the
+ * a80x0 platform definitions. Both are built into the test to reach their
+ * static functions, and run over a model of the TWSI controller with a DDR4
+ * SPD EEPROM on the bus.
+ *
+ * A bus event (start, stop or byte transfer) is started by clearing the
+ * interrupt flag, or by setting the start or stop bit on an idle bus, and
+ * completes 9 bit times later. Time only advances through udelay() and
+ * mdelay(). The model checks that the driver never clears the interrupt flag
+ * less than I2C_WRITE_DELAY_US after a register write the controller has not
+ * yet processed.
+ */
+
+#include "../../drivers/marvell/i2c/a8k_i2c.c"
+#include "../../plat/marvell/a8k/common/plat_ble_spd.c"
+
+#include <stdio.h>
+#include <string.h>
+#include "test.h"
+
+TEST_DEFINE_COUNTERS;
+
+#define SPD_PAGE_SIZE		256
+#define SPD_PAGES		2
+/* Bus event duration: 8 data bits and the acknowledge */
+#define EVENT_US		(9 * 1000000 / CONFIG_SYS_I2C_SPEED + 1)
+
+enum bus_state {
+	BUS_IDLE,
+	BUS_STARTED,	/* Waiting for the address byte */
+	BUS_WRITE,
+	BUS_READ,
+	BUS_NAK,	/* Address not acknowledged, waiting for the stop */
+};
+
+/* Model of the TWSI controller */
+static struct marvell_i2c_regs regs;
+static uint32_t reg_control, reg_status, reg_data;
+static enum bus_state state;
+static int busy;			/* Bus event in progress */
+static uint64_t busy_until;
+static uint32_t next_status, next_data;
+static int next_iflg;
+static unsigned int num_events;
+
+/* Checks of the write delay */
+static unsigned int num_writes;
+static unsigned int event_writes;	/* Writes before the current event */
+static unsigned int processed_writes;	/* Writes before the last event */
+static uint64_t last_write_at;
+static unsigned int gap_violations;
+
+/* Model of the SPD EEPROM */
+static uint8_t spd[SPD_PAGES * SPD_PAGE_SIZE];
+static unsigned int spd_page, spd_ptr;
+static int spd_offset_set;
+static int spd_present;
+static unsigned int spd_read_xfers;	/* Read transactions to the SPD */
+
+/* Model settings */
+static unsigned int corrupt_xfers;	/* Read transactions with a bad byte */
+static unsigned int lose_arb_at;	/* Lose the arbitration on this event */
+static unsigned int hang_at;		/* Never complete this event */
+
+static uint64_t now;
+static unsigned int long_delays;	/* Delays of the write delay or more */
+
+void udelay(uint32_t usec)
+{
+	now += usec;
+	if (usec >= I2C_WRITE_DELAY_US)
+		long_delays++;
+}
+
+void mdelay(uint32_t msec)
+{
+	udelay(msec * 1000);
+}
+
+static void event_complete(void)
+{
+	if (busy && hang_at != num_events && now >= busy_until) {
+		busy = 0;
+		processed_writes = event_writes;
+		reg_status = next_status;
+		reg_data = next_data;
+		reg_control &= ~(I2C_CONTROL_START | I2C_CONTROL_STOP);
+		if (next_iflg)
+			reg_control |= I2C_CONTROL_IFLG;
+	}
+}
+
+static void event_start(uint32_t status, uint32_t data, int iflg)
+{
+	num_events++;
+	busy = 1;
+	busy_until = now + EVENT_US;
+	event_writes = num_writes;
+	next_status = status;
+	next_data = data;
+	next_iflg = iflg;
+	if (lose_arb_at == num_events) {
+		next_status = I2C_STATUS_LOST_ARB_DATA_ADDR_TRANSFER;
+		next_iflg = 1;
+		state = BUS_IDLE;
+	}
+}
+
+static void bus_stop(void)
+{
+	state = BUS_IDLE;
+	event_start(I2C_STATUS_IDLE, reg_data, 0);
+}
+
+static void bus_address(uint32_t byte)
+{
+	uint32_t chip = byte >> 1;
+	int read = byte & I2C_CMD_READ;
+
+	if (chip == I2C_SPD_P0_ADDR || chip == I2C_SPD_P0_ADDR + 1) {
+		/* The page selectors, whatever the direction */
+		spd_page = chip - I2C_SPD_P0_ADDR;
+	} else if (chip != I2C_SPD_ADDR || !spd_present) {
+		state = BUS_NAK;
+		event_start(read ? 0x48 : 0x20, reg_data, 1);
+		return;
+	} else if (read) {
+		spd_read_xfers++;
+	}
+	spd_offset_set = 0;
+	state = read ? BUS_READ : BUS_WRITE;
+	event_start(read ? I2C_STATUS_ADDR_R_ACK : I2C_STATUS_ADDR_W_ACK,
+		    reg_data, 1);
+}
+
+static void bus_receive(void)
+{
+	uint8_t byte = spd[spd_page * SPD_PAGE_SIZE + spd_ptr];
+
+	if (spd_read_xfers <= corrupt_xfers && spd_ptr == 10)
+		byte ^= 0x40;
+	spd_ptr = (spd_ptr + 1) % SPD_PAGE_SIZE;
+	event_start((reg_control & I2C_CONTROL_ACK) ? I2C_STATUS_DATA_R_ACK :
+		    I2C_STATUS_DATA_R_NAK, byte, 1);
+}
+
+static void bus_transmit(void)
+{
+	if (!spd_offset_set) {
+		spd_ptr = reg_data & 0xff;
+		spd_offset_set = 1;
+	} else {
+		spd[spd_page * SPD_PAGE_SIZE + spd_ptr] = reg_data;
+		spd_ptr = (spd_ptr + 1) % SPD_PAGE_SIZE;
+	}
+	event_start(I2C_STATUS_DATA_W_ACK, reg_data, 1);
+}
+
+static void bus_repeated_start(void)
+{
+	state = BUS_STARTED;
+	event_start(I2C_STATUS_REPEATED_START, reg_data, 1);
+}
+
+/* The interrupt flag was cleared: start the next bus event */
+static void bus_event(void)
+{
+	if (reg_control & I2C_CONTROL_STOP)
+		bus_stop();
+	else if (reg_control & I2C_CONTROL_START)
+		bus_repeated_start();
+	else if (state == BUS_STARTED)
+		bus_address(reg_data);
+	else if (state == BUS_WRITE)
+		bus_transmit();
+	else if (state == BUS_READ)
+		bus_receive();
+	else
+		CHECK(!"interrupt flag cleared on an idle bus");
+}
+
+static void control_write(uint32_t value)
+{
+	uint32_t prev = reg_control;
+
+	/* The interrupt flag can only be cleared */
+	reg_control = value & (prev | ~I2C_CONTROL_IFLG);
+	if (busy)
+		return;
+
+	if ((prev & I2C_CONTROL_IFLG) && !(value & I2C_CONTROL_IFLG)) {
+		bus_event();
+	} else if (!(prev & I2C_CONTROL_IFLG) && state == BUS_IDLE &&
+		   (value & I2C_CONTROL_START)) {
+		state = BUS_STARTED;
+		event_start(I2C_STATUS_START, reg_data, 1);
+	} else if (!(prev & I2C_CONTROL_IFLG) && (value & I2C_CONTROL_STOP)) {
+		bus_stop();
+	}
+}
+
+static void reset_controller(void)
+{
+	reg_control = 0;
+	reg_status = I2C_STATUS_IDLE;
+	reg_data = 0;
+	state = BUS_IDLE;
+	busy = 0;
+	processed_writes = num_writes;
+}
+
+uint32_t mmio_read_32(uintptr_t addr)
+{
+	event_complete();
+	if (addr == (uintptr_t)&regs.control) {
+		return reg_control;
+	} else if (addr == (uintptr_t)&regs.u.status) {
+		return reg_status;
+	} else if (addr == (uintptr_t)&regs.data) {
+		return reg_data;
+	}
+
+	CHECK(!"read of an unexpected register");
+	return 0;
+}
+
+void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	event_complete();
+	if (addr == (uintptr_t)&regs.control) {
+		if ((reg_control & I2C_CONTROL_IFLG) &&
+		    !(value & I2C_CONTROL_IFLG) &&
+		    processed_writes != num_writes &&
+		    now - last_write_at < I2C_WRITE_DELAY_US)
+			gap_violations++;
+		last_write_at = now;
+		num_writes++;
+		control_write(value);
+	} else if (addr == (uintptr_t)&regs.data) {
+		last_write_at = now;
+		num_writes++;
+		reg_data = value;
+	} else if (addr == (uintptr_t)&regs.soft_reset) {
+		reset_controller();
+	} else if (addr != (uintptr_t)&regs.u.baudrate &&
+		   addr != (uintptr_t)&regs.slave_address &&
+		   addr != (uintptr_t)&regs.xtnd_slave_addr) {
+		CHECK(!"write to an unexpected register");
+	}
+}
+
+static void fill_spd(void)
+{
+	unsigned int n;
+	uint16_t crc;
+
+	for (n = 0; n < sizeof(spd); n++)
+		spd[n] = (uint8_t)(n * 13 + 5);
+	for (n = 0; n < SPD_CRC_BLOCKS; n++) {
+		crc = spd_crc16(&spd[n * SPD_CRC_BLOCK_SIZE],
+				SPD_CRC_BLOCK_SIZE - 2);
+		spd[(n + 1) * SPD_CRC_BLOCK_SIZE - 2] = crc & 0xff;
+		spd[(n + 1) * SPD_CRC_BLOCK_SIZE - 1] = crc >> 8;
+	}
+}
+
+static void reset_model(void)
+{
+	reset_controller();
+	num_events = 0;
+	gap_violations = 0;
+	fill_spd();
+	spd_page = 0;
+	spd_present = 1;
+	spd_read_xfers = 0;
+	corrupt_xfers = 0;
+	lose_arb_at = 0;
+	hang_at = 0;
+	long_delays = 0;
+	i2c_init(&regs);
+	now = 0;
+	long_delays = 0;
+}
+
+/* The transaction left the bus idle, with a stop */
+static int bus_released(void)
+{
+	event_complete();
+	return state == BUS_IDLE && !busy &&
+	       !(reg_control & (I2C_CONTROL_START | I2C_CONTROL_STOP));
+}
+
+static void test_crc(void)
+{
+	static const uint8_t check[] = "123456789";
+	uint8_t buf[SPD_PAGE_SIZE];
+
+	/* CRC-16/XMODEM check value, used by JEDEC for the SPD */
+	CHECK(spd_crc16(check, 9) == 0x31C3);
+	CHECK(spd_crc16(check, 0) == 0);
+
+	fill_spd();
+	memcpy(buf, spd, sizeof(buf));
+	CHECK(spd_crc_errors(buf, sizeof(buf)) == 0);
+	buf[3] ^= 1;
+	CHECK(spd_crc_errors(buf, sizeof(buf)) == 1);
+	buf[SPD_CRC_BLOCK_SIZE + 3] ^= 1;
+	CHECK(spd_crc_errors(buf, sizeof(buf)) == 2);
+	/* Only the complete blocks are checked */
+	CHECK(spd_crc_errors(buf, SPD_CRC_BLOCK_SIZE + 64) == 1);
+	CHECK(spd_crc_errors(buf, 64) == 0);
+
+	/* The CRC bytes themselves */
+	memcpy(buf, spd, sizeof(buf));
+	buf[2 * SPD_CRC_BLOCK_SIZE - 1] ^= 0x80;
+	CHECK(spd_crc_errors(buf, sizeof(buf)) == 1);
+}
+
+static void test_spd_read(void)
+{
+	uint8_t buf[SPD_PAGE_SIZE];
+
+	reset_model();
+	memset(buf, 0, sizeof(buf));
+
+	/* The page select of the board code, then the page itself */
+	CHECK(i2c_read(I2C_SPD_P0_ADDR, 0x0, 1, buf, 1) == 0);
+	CHECK(bus_released());
+	now = 0;
+	long_delays = 0;
+	CHECK(marvell_spd_read(I2C_SPD_ADDR, 1, buf, sizeof(buf)) == 0);
+	CHECK(memcmp(buf, spd, sizeof(buf)) == 0);
+	CHECK(spd_read_xfers == 1);
+	CHECK(bus_released());
+	CHECK(gap_violations == 0);
+	/*
+	 * The write delay is paid for the address, offset, repeated start,
+	 * read address, last byte and stop writes, not for each byte
+	 */
+	CHECK(long_delays == 6);
+	printf("SPD page read in %llu us at %u Hz\n", (unsigned long long)now,
+	       CONFIG_SYS_I2C_SPEED);
+
+	/* A read from a non-zero offset and page 1 */
+	CHECK(i2c_read(I2C_SPD_P0_ADDR + 1, 0x0, 1, buf, 1) == 0);
+	CHECK(i2c_read(I2C_SPD_ADDR, 0x20, 1, buf, 16) == 0);
+	CHECK(memcmp(buf, &spd[SPD_PAGE_SIZE + 0x20], 16) == 0);
+	CHECK(gap_violations == 0);
+}
+
+static void test_spd_retry(void)
+{
+	uint8_t buf[SPD_PAGE_SIZE];
+
+	/* Corrupted transfers are read again */
+	reset_model();
+	corrupt_xfers = SPD_READ_RETRIES - 1;
+	CHECK(marvell_spd_read(I2C_SPD_ADDR, 1, buf, sizeof(buf)) == 0);
+	CHECK(spd_read_xfers == SPD_READ_RETRIES);
+	CHECK(memcmp(buf, spd, sizeof(buf)) == 0);
+
+	/* Up to SPD_READ_RETRIES times */
+	reset_model();
+	corrupt_xfers = SPD_READ_RETRIES;
+	CHECK(marvell_spd_read(I2C_SPD_ADDR, 1, buf, sizeof(buf)) != 0);
+	CHECK(spd_read_xfers == SPD_READ_RETRIES);
+	CHECK(bus_released());
+	CHECK(gap_violations == 0);
+}
+
+/* An empty DIMM slot: the address is not acknowledged */
+static void test_missing_device(void)
+{
+	uint8_t buf[SPD_PAGE_SIZE];
+
+	reset_model();
+	spd_present = 0;
+	CHECK(i2c_read(I2C_SPD_ADDR, 0x0, 1, buf, sizeof(buf)) == -EPERM);
+	CHECK(bus_released());
+	CHECK(i2c_write(I2C_SPD_ADDR, 0x0, 1, buf, 1) == -EPERM);
+	CHECK(bus_released());
+	/* Not even with a valid SPD left in the buffer */
+	memcpy(buf, spd, sizeof(buf));
+	CHECK(marvell_spd_read(I2C_SPD_ADDR, 1, buf, sizeof(buf)) != 0);
+	CHECK(bus_released());
+	CHECK(gap_violations == 0);
+}
+
+static void test_lost_arbitration(void)
+{
+	uint8_t buf[SPD_PAGE_SIZE];
+	unsigned int at;
+
+	/* On the start, address, offset, read address and data events */
+	for (at = 1; at <= 6; at++) {
+		reset_model();
+		num_events = 0;
+		lose_arb_at = at;
+		memset(buf, 0, sizeof(buf));
+		CHECK(i2c_read(I2C_SPD_ADDR, 0x0, 1, buf, 32) == 0);
+		CHECK(memcmp(buf, spd, 32) == 0);
+		CHECK(bus_released());
+		CHECK(gap_violations == 0);
+	}
+}
+
+/* A slave holding the bus: the transaction times out, a reset recovers */
+static void test_hang(void)
+{
+	uint8_t buf[SPD_PAGE_SIZE];
+	unsigned int at;
+
+	for (at = 1; at <= 6; at++) {
+		reset_model();
+		num_events = 0;
+		hang_at = at;
+		CHECK(i2c_read(I2C_SPD_ADDR, 0x0, 1, buf, 32) == -ETIMEDOUT);
+		/* Bounded by the event and stop timeouts and write delays */
+		CHECK(now <= 2 * I2C_TIMEOUT_US + 8 * I2C_WRITE_DELAY_US +
+			     8 * EVENT_US);
+
+		hang_at = 0;
+		i2c_init(&regs);
+		memset(buf, 0, sizeof(buf));
+		CHECK(i2c_read(I2C_SPD_ADDR, 0x0, 1, buf, 32) == 0);
+		CHECK(memcmp(buf, spd, 32) == 0);
+		CHECK(bus_released());
+	}
+}
+
+static void test_write(void)
+{
+	uint8_t data[4] = { 0xde, 0xad, 0xbe, 0xef };
+	uint8_t buf[4];
+
+	reset_model();
+	CHECK(i2c_write(I2C_SPD_ADDR, 0x40, 1, data, sizeof(data)) == 0);
+	CHECK(memcmp(&spd[0x40], data, sizeof(data)) == 0);
+	CHECK(bus_released());
+	CHECK(i2c_read(I2C_SPD_ADDR, 0x40, 1, buf, sizeof(buf)) == 0);
+	CHECK(memcmp(buf, data, sizeof(data)) == 0);
+	CHECK(gap_violations == 0);
+}
+
+int main(int argc, char *argv[])
+{
+	test_crc();
+	test_spd_read();
+	test_spd_retry();
+	test_missing_device();
+	test_lost_arbitration();
+	test_hang();
+	test_write();
+
+	return test_report(argv[0]);
+}